@@ -7,8 +7,9 @@
 // 
 //  This Arduino project interfaces with an ADIS16470 using SPI and the 
 //  accompanying C++ libraries, reads IMU data in LSBs, and transmits
-//  measurements to a serial debug terminal (PuTTY) via the onboard 
-//  USB serial port using Serial.write(). 
+//  measurements via the onboard USB serial port using Serial.write().
+//  Samples are sent in the packed binary stream format described in
+//  ADIS16470_Stream.h and can be decoded with ADIS16470StreamDecoder.
 //
 //  This project has been tested on a PJRC 32-Bit Teensy 3.2 Development Board, 
 //  but should be compatible with any other embedded platform with some modification.
@@ -45,8 +46,18 @@
 #include <SPI.h>
 
 // Initialize Variables
-// Temporary Data Array
-uint8_t *burstData;
+// Frames drained from the library queue
+ADIS16470Frame frames[8];
+
+// Binary stream encoder. Batches ADIS16470_STREAM_SAMPLES samples per packet
+ADIS16470StreamEncoder encoder;
+
+// Sensor configuration applied at startup
+const ADIS16470RegValue imuConfig[] = {
+    { MSC_CTRL, 0xC1 },  // Enable Data Ready, set polarity
+    { FILT_CTRL, 0x04 }, // Set digital filter
+    { DEC_RATE, 0x00 },  // Disable decimation
+};
 
 // Call ADIS16470 Class
 ADIS16470 IMU(10,2,6); // Chip Select, Data Ready, Reset Pin Assignments
@@ -54,26 +65,25 @@ ADIS16470 IMU(10,2,6); // Chip Select, Data Ready, Reset Pin Assignments
 void setup()
 {
     Serial.begin(115200); // Initialize serial output via USB
-    IMU.configSPI(); // Configure SPI communication
     delay(1000); // Give the part time to start up
-    IMU.regWrite(MSC_CTRL, 0xC1);  // Enable Data Ready, set polarity
-    IMU.regWrite(DEC_RATE, 0x00); // Set digital filter
-    IMU.regWrite(FILT_CTRL, 0x04); // Set digital filter
-    attachInterrupt(2, printData, RISING); // Attach interrupt to pin 2. Trigger on the rising edge
+    IMU.applyConfig(imuConfig, 3, true); // Write only the registers that differ, then verify
+    encoder.begin(STREAM_INERTIAL16, true); // 16-bit gyro/accel samples, delta/varint packed
+    attachInterrupt(2, grabData, RISING); // Attach interrupt to pin 2. Trigger on the rising edge
 }
 
-// Function used to read register values when an ISR is triggered from the IMU's Data Ready pin and print to serial port
-void printData()
+// Function used to read register values when an ISR is triggered from the IMU's Data Ready pin
+void grabData()
 {
-    burstData = IMU.byteBurst(); // Read burst data and point to data array. Disable checksum
-    Serial.write(0xA5); // Frame delimiter
-    Serial.write(0xA5); // Frame delimiter
-    Serial.write(0xA5); // Frame delimiter
-    Serial.write(burstData,20); // Push data pointer to serial port
+    IMU.queueBurst(); // Read data and push the decoded frame to the library queue
 }
 
-// Main loop
+// Main loop. Drain the queue and write each full packet to the serial port with a single call
 void loop()
 {
-    // Nothing to do here! The program is entirely interrupt-driven!
+    size_t count = IMU.readFrames(frames, 8);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (encoder.add(frames[i])) // Packet full?
+            Serial.write(encoder.data(), encoder.finish());
+    }
 }
@@ -48,8 +48,11 @@
 //#define DEBUG
 
 // Initialize Variables
-// Temporary Data Array
-uint16_t *burstData;
+// Frames drained from the library queue
+ADIS16470Frame frames[8];
+
+// Most recent frame
+ADIS16470Frame lastFrame;
 
 // Checksum variable
 int16_t burstChecksum = 0;
@@ -71,17 +74,21 @@ float TEMPS = 0;
 // Delay counter variable
 int printCounter = 0;
 
+// Sensor configuration applied at startup
+const ADIS16470RegValue imuConfig[] = {
+    { MSC_CTRL, 0xC1 },  // Enable Data Ready, set polarity
+    { FILT_CTRL, 0x04 }, // Set digital filter
+    { DEC_RATE, 0x00 },  // Disable decimation
+};
+
 // Call ADIS16470 Class
 ADIS16470 IMU(10,2,6); // Chip Select, Data Ready, Reset Pin Assignments
 
 void setup()
 {
     Serial.begin(115200); // Initialize serial output via USB
-    IMU.configSPI(); // Configure SPI communication
     delay(500); // Give the part time to start up
-    IMU.regWrite(MSC_CTRL, 0xC1);  // Enable Data Ready, set polarity
-    IMU.regWrite(FILT_CTRL, 0x04); // Set digital filter
-    IMU.regWrite(DEC_RATE, 0x00), // Disable decimation
+    IMU.applyConfig(imuConfig, 3, true); // Write only the registers that differ, then verify
 
     // Read the control registers once to print to screen
     MSC = IMU.regRead(MSC_CTRL);
@@ -94,32 +101,34 @@ void setup()
 // Function used to read register values when an ISR is triggered using the IMU's DataReady output
 void grabData()
 {
-    burstData = {};
-    IMU.configSPI(); // Configure SPI before the read. Useful when talking to multiple SPI devices
-    burstData = IMU.wordBurst(); // Read data and insert into array
+    IMU.queueBurst(); // Read data and push the decoded frame to the library queue
 }
 
 // Function used to scale all acquired data (scaling functions are included in ADIS16470.cpp)
 void scaleData()
 {
-    GXS = IMU.gyroScale(*(burstData + 1)); //Scale X Gyro
-    GYS = IMU.gyroScale(*(burstData + 2)); //Scale Y Gyro
-    GZS = IMU.gyroScale(*(burstData + 3)); //Scale Z Gyro
-    AXS = IMU.accelScale(*(burstData + 4)); //Scale X Accel
-    AYS = IMU.accelScale(*(burstData + 5)); //Scale Y Accel
-    AZS = IMU.accelScale(*(burstData + 6)); //Scale Z Accel
-    TEMPS = IMU.tempScale(*(burstData + 7)); //Scale Temp Sensor
+    GXS = IMU.gyroScale(lastFrame.gyro[0]); //Scale X Gyro
+    GYS = IMU.gyroScale(lastFrame.gyro[1]); //Scale Y Gyro
+    GZS = IMU.gyroScale(lastFrame.gyro[2]); //Scale Z Gyro
+    AXS = IMU.accelScale(lastFrame.accl[0]); //Scale X Accel
+    AYS = IMU.accelScale(lastFrame.accl[1]); //Scale Y Accel
+    AZS = IMU.accelScale(lastFrame.accl[2]); //Scale Z Accel
+    TEMPS = IMU.tempScale(lastFrame.temp); //Scale Temp Sensor
 }
 
 // Main loop. Print data to the serial port. Sensor sampling is performed in the ISR
 void loop()
 {
+    // Drain every frame captured by the ISR. Keep the most recent one for display
+    size_t count = IMU.readFrames(frames, 8);
+    if (count > 0)
+        lastFrame = frames[count - 1];
+
     printCounter ++;
     if (printCounter >= 50000) // Delay for writing data to the serial port
     {
-        detachInterrupt(2); //Detach interrupt to avoid overwriting data
         scaleData(); // Scale data acquired from the IMU
-        burstChecksum = IMU.checksum(burstData); // Calculate checksum based on data array
+        burstChecksum = IMU.checksum(&lastFrame); // Calculate checksum based on the frame
 
         //Clear the serial terminal and reset cursor
         //Only works on supported serial terminal programs (Putty)
@@ -164,18 +173,37 @@ void loop()
 
         // Print Status Registers
         Serial.print("DIAG_STAT: ");
-        Serial.println((*(burstData + 0)));
+        Serial.println(lastFrame.diagStat);
         Serial.print("TIME_STMP: ");
-        Serial.println((*(burstData + 8)));
+        Serial.println(lastFrame.timeStamp);
         Serial.print("CHECKSUM: ");
-        Serial.println((*(burstData + 9)));
+        Serial.println(lastFrame.checksum);
 
         // Report if checksum is good or bad
         Serial.print("CHECKSUM OK? ");
-        if (burstChecksum == *(burstData + 9)) 
+        if (burstChecksum == (int16_t)lastFrame.checksum) 
             Serial.println("YES");
         else
             Serial.println("NO");
+
+        // Report data integrity
+        ADIS16470IntegrityStats stats = IMU.integrityStats();
+        Serial.print("BAD CHECKSUMS: ");
+        Serial.println(stats.badChecksum);
+        Serial.print("MISSED SAMPLES: ");
+        Serial.println(stats.samplesMissed);
+        Serial.print("DIAG ERRORS: ");
+        Serial.println(stats.diagErrors);
+        Serial.print("QUEUE OVERRUNS: ");
+        Serial.println(IMU.queueOverruns());
+        Serial.print("QUEUE HIGH WATER: ");
+        Serial.println(IMU.queueHighWater());
+
+#ifdef ADIS16470_PROFILE
+        // Print timing histograms (enable in ADIS16470_Profile.h)
+        Serial.println(" ");
+        IMU.printProfile(Serial);
+#endif
        
         // Print scaled temp data
         Serial.print("TEMP: ");
@@ -184,26 +212,25 @@ void loop()
 #ifdef DEBUG 
         // Print unscaled gyro data
         Serial.print("XGYRO: ");
-        Serial.println((*(burstData + 1)));
+        Serial.println(lastFrame.gyro[0]);
         Serial.print("YGYRO: ");
-        Serial.println((*(burstData + 2)));
+        Serial.println(lastFrame.gyro[1]);
         Serial.print("ZGYRO: ");
-        Serial.println((*(burstData + 3)));
+        Serial.println(lastFrame.gyro[2]);
       
         // Print unscaled accel data
         Serial.print("XACCL: ");
-        Serial.println((*(burstData + 4)));
+        Serial.println(lastFrame.accl[0]);
         Serial.print("YACCL: ");
-        Serial.println((*(burstData + 5)));
+        Serial.println(lastFrame.accl[1]);
         Serial.print("ZACCL: ");
-        Serial.println((*(burstData + 6)));
+        Serial.println(lastFrame.accl[2]);
         Serial.println(" ");
        
         // Print unscaled temp data
         Serial.print("TEMP: ");
-        Serial.println((*(burstData + 7)));
+        Serial.println(lastFrame.temp);
 #endif
         printCounter = 0;
-        attachInterrupt(2, grabData, RISING);
     }
 }
@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Teensy_MultiIMU_Example.ino
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  This Arduino project reads two ADIS16470s sharing one SPI bus. Each sensor's 
+//  data ready ISR only records the edge with the scheduler; loop() then performs 
+//  the burst reads one at a time in data ready order, so the sensors never 
+//  collide on the bus. Scaled gyro data, per-sensor drop counts and data ready 
+//  to read latencies are written to the USB serial port.
+//
+//  This project has been tested on a PJRC 32-Bit Teensy 3.2 Development Board, 
+//  but should be compatible with any other embedded platform with some modification.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//  Pinout for a Teensy 3.2 Development Board
+//  SCK = D13/SCK (shared)
+//  DOUT(MISO) = D12/MISO (shared)
+//  DIN(MOSI) = D11/MOSI (shared)
+//  IMU 0: CS = D10, DR = D2, RST = D6
+//  IMU 1: CS = D9, DR = D3, RST = D7
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <ADIS16470.h>
+#include <SPI.h>
+
+#define IMU_COUNT 2
+
+// Sensor configuration applied to every IMU at startup
+const ADIS16470RegValue imuConfig[] = {
+    { MSC_CTRL, 0xC1 },  // Enable Data Ready, set polarity
+    { FILT_CTRL, 0x04 }, // Set digital filter
+    { DEC_RATE, 0x00 },  // Disable decimation
+};
+
+// Call ADIS16470 Class. Both sensors use the default SPI bus
+ADIS16470 IMU0(10,2,6); // Chip Select, Data Ready, Reset Pin Assignments
+ADIS16470 IMU1(9,3,7);
+ADIS16470 *imus[IMU_COUNT] = { &IMU0, &IMU1 };
+
+// Scheduler clock in microseconds
+uint32_t clockMicros()
+{
+    return micros();
+}
+
+ADIS16470Scheduler scheduler(clockMicros);
+
+// Scheduler device numbers
+int devices[IMU_COUNT];
+
+// Frames drained from the library queues
+ADIS16470Frame frames[8];
+
+// Most recent frame from each IMU
+ADIS16470Frame lastFrame[IMU_COUNT];
+
+// Delay counter variable
+int printCounter = 0;
+
+void setup()
+{
+    Serial.begin(115200); // Initialize serial output via USB
+    delay(500); // Give the parts time to start up
+
+    for (int i = 0; i < IMU_COUNT; i++)
+    {
+        imus[i]->applyConfig(imuConfig, 3, true); // Write only the registers that differ, then verify
+        devices[i] = scheduler.addDevice(0, ADIS16470::scheduledBurst, imus[i]); // Both on bus 0
+    }
+
+    attachInterrupt(2, imu0Ready, RISING); // Attach data ready interrupts. Trigger on the rising edge
+    attachInterrupt(3, imu1Ready, RISING);
+}
+
+// Data ready ISRs. Only record the edge; the read happens in loop()
+void imu0Ready()
+{
+    scheduler.dataReady(devices[0]);
+}
+
+void imu1Ready()
+{
+    scheduler.dataReady(devices[1]);
+}
+
+// Main loop. Service pending sensors, then print data to the serial port
+void loop()
+{
+    scheduler.poll(); // Burst read every sensor with a pending data ready edge
+
+    // Drain every queued frame. Keep the most recent one from each IMU for display
+    for (int i = 0; i < IMU_COUNT; i++)
+    {
+        size_t count = imus[i]->readFrames(frames, 8);
+        if (count > 0)
+            lastFrame[i] = frames[count - 1];
+    }
+
+    printCounter ++;
+    if (printCounter >= 50000) // Delay for writing data to the serial port
+    {
+        //Clear the serial terminal and reset cursor
+        //Only works on supported serial terminal programs (Putty)
+        Serial.print("\033[2J");
+        Serial.print("\033[H");
+
+        // Print header
+        Serial.println(" ");
+        Serial.println("ADIS16470 Teensy Multi-IMU Example Program");
+        Serial.println(" ");
+
+        for (int i = 0; i < IMU_COUNT; i++)
+        {
+            const ADIS16470DeviceStats &stats = scheduler.stats(devices[i]);
+
+            Serial.print("IMU ");
+            Serial.println(i);
+
+            // Print scaled gyro data
+            Serial.print("XGYRO: ");
+            Serial.println(imus[i]->gyroScale(lastFrame[i].gyro[0]));
+            Serial.print("YGYRO: ");
+            Serial.println(imus[i]->gyroScale(lastFrame[i].gyro[1]));
+            Serial.print("ZGYRO: ");
+            Serial.println(imus[i]->gyroScale(lastFrame[i].gyro[2]));
+
+            // Print scheduling statistics
+            Serial.print("SAMPLES: ");
+            Serial.println(stats.serviced);
+            Serial.print("DROPPED: ");
+            Serial.println(stats.dropped);
+            Serial.print("LATENCY MIN/MAX (us): ");
+            Serial.print(stats.latencyMin);
+            Serial.print(" / ");
+            Serial.println(stats.latencyMax);
+            Serial.print("BAD CHECKSUMS: ");
+            Serial.println(imus[i]->integrityStats().badChecksum);
+            Serial.println(" ");
+        }
+        printCounter = 0;
+    }
+}
@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_CalibrationSim.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Host simulation of ADIS16470BiasEstimator. A stationary sensor with known per-axis 
+//  biases, white noise and 1 g on the Z accelerometer produces 32-bit (or 16-bit) burst 
+//  frames. Each configuration checks that estimation stops after about (noise / target)^2 
+//  samples, that every correction lands within a few targets of the true bias, and that 
+//  the sample limit is honoured on a noisy unit. A 16-bit case quieter than one LSB checks
+//  that the LSB^2 / 12 quantization floor keeps constant readings from stopping at the 
+//  minimum. The stopping point is compared with a fixed two second average at 2000 SPS.
+//
+//  Build and run from the repository root:
+//    g++ -O2 -Isrc extras/bench/ADIS16470_CalibrationSim.cpp src/ADIS16470_Calibration.cpp -o calibration_sim
+//    ./calibration_sim
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "ADIS16470_Calibration.h"
+
+#define FIXED_SAMPLES 4000   // Two seconds at 2000 SPS
+#define ONE_G_LSB     800.0  // 16-bit accelerometer LSB per g (1.25 mg/LSB)
+
+struct Case {
+  const char *name;
+  uint8_t channels;
+  double gyroNoise;   // 16-bit LSB rms
+  double accelNoise;
+  float target;       // Standard error target, 16-bit LSB
+  uint32_t maxSamples;
+  bool frames16;      // Feed 16-bit bursts instead of 32-bit
+  bool expectConverged;
+};
+
+static bool run(const Case &c, std::mt19937 &rng) {
+  // True bias (16-bit LSB) per channel, reading = bias + expected + noise
+  const double bias[CAL_CHANNELS] = { 3.7, -12.25, 0.4, -5.5, 8.1, 20.3 };
+  const double expected[CAL_CHANNELS] = { 0, 0, 0, 0, 0, ONE_G_LSB };
+  std::normal_distribution<double> unit(0.0, 1.0);
+
+  ADIS16470BiasEstimator est;
+  est.setChannels(c.channels);
+  est.setTargets(c.target, c.target);
+  est.setLimits(64, c.maxSamples);
+  est.setExpected(5, (float)ONE_G_LSB);
+  est.reset();
+
+  // Fixed-duration plain average for comparison
+  double sum[CAL_CHANNELS] = { 0 };
+  uint32_t fixed = 0;
+  bool done = false;
+  while (!done || fixed < FIXED_SAMPLES)
+  {
+    double v[CAL_CHANNELS];
+    for (int ch = 0; ch < CAL_CHANNELS; ch++)
+      v[ch] = bias[ch] + expected[ch] + ((ch < 3) ? c.gyroNoise : c.accelNoise) * unit(rng);
+    if (fixed < FIXED_SAMPLES)
+    {
+      for (int ch = 0; ch < CAL_CHANNELS; ch++)
+        sum[ch] += v[ch];
+      fixed++;
+    }
+    if (done)
+      continue;
+    if (c.frames16)
+    {
+      ADIS16470Frame f = {};
+      for (int i = 0; i < 3; i++)
+      {
+        f.gyro[i] = (int16_t)lround(v[i]);
+        f.accl[i] = (int16_t)lround(v[3 + i]);
+      }
+      done = est.add(f);
+    }
+    else
+    {
+      ADIS16470Frame32 f = {};
+      for (int i = 0; i < 3; i++)
+      {
+        f.gyro[i] = (int32_t)llround(v[i] * 65536.0);
+        f.accl[i] = (int32_t)llround(v[3 + i] * 65536.0);
+      }
+      done = est.add(f);
+    }
+  }
+
+  bool ok = (est.converged() == c.expectConverged);
+  uint32_t n = est.samples();
+  if (c.expectConverged)
+  {
+    // Samples needed by the noisiest selected channel, allowing for estimation spread
+    double sigma = 0;
+    for (int ch = 0; ch < CAL_CHANNELS; ch++)
+      if (c.channels & (1 << ch))
+        sigma = fmax(sigma, (ch < 3) ? c.gyroNoise : c.accelNoise);
+    // 16-bit frames add the rounding noise, which is also the estimator's variance floor
+    double variance = sigma * sigma + (c.frames16 ? 1.0 / 12.0 : 0.0);
+    double predicted = fmax(64.0, variance / ((double)c.target * c.target));
+    if (n < 0.7 * predicted || n > 1.3 * predicted + 8)
+      ok = false;
+    printf("%s\n  stopped after %u samples (predicted %.0f, fixed average %d)\n", c.name, n, predicted, FIXED_SAMPLES);
+  }
+  else
+  {
+    if (n != c.maxSamples)
+      ok = false;
+    printf("%s\n  stopped at the limit after %u samples\n", c.name, n);
+  }
+
+  // Corrections against truth. 16-bit input adds rounding, so allow half an LSB more
+  double limit = 4.0 * fmax(c.target, est.standardError(0)) + (c.frames16 ? 0.5 : 0.0);
+  for (int ch = 0; ch < CAL_CHANNELS; ch++)
+  {
+    if (!(c.channels & (1 << ch)))
+      continue;
+    double corr = est.correction(ch) / 65536.0;
+    double err = corr + bias[ch];
+    double fixedErr = expected[ch] - sum[ch] / fixed + bias[ch];
+    double se = est.standardError(ch);
+    if (fabs(err) > fmax(limit, 4.0 * se))
+      ok = false;
+    printf("  ch%d  correction %9.4f  error %8.4f  std err %7.4f  (fixed average error %8.4f)\n",
+           ch, corr, err, se, fixedErr);
+  }
+  printf("  %s\n", ok ? "ok" : "FAIL");
+  return ok;
+}
+
+int main(void) {
+  Case cases[] = {
+    { "gyros, quiet sensor (0.3 LSB rms), target 0.02 LSB",  CAL_GYRO, 0.3, 1.0, 0.02f, 20000, false, true },
+    { "gyros, 1 LSB rms, target 0.02 LSB",                   CAL_GYRO, 1.0, 1.0, 0.02f, 20000, false, true },
+    { "all axes with 1 g on Z, target 0.05 LSB",             CAL_ALL,  0.8, 2.0, 0.05f, 20000, false, true },
+    { "all axes, 16-bit bursts, target 0.05 LSB",            CAL_ALL,  1.5, 1.5, 0.05f, 20000, true,  true },
+    { "gyros, 16-bit bursts, 0.05 LSB rms, target 0.01 LSB", CAL_GYRO, 0.05, 1.0, 0.01f, 20000, true, true },
+    { "noisy unit (6 LSB rms), sample limit 5000",           CAL_GYRO, 6.0, 1.0, 0.02f,  5000, false, false },
+  };
+  std::mt19937 rng(1);
+  int failures = 0;
+  for (const Case &c : cases)
+    if (!run(c, rng))
+      failures++;
+  printf(failures ? "%d FAILED\n" : "all passed\n", failures);
+  return failures ? 1 : 0;
+}
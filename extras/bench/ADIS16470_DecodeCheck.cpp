@@ -0,0 +1,326 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_DecodeCheck.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Host check of the capture decoder in extras/tools. It writes a legacy capture with junk
+//  between frames, false delimiters, corrupted frames, a DIAG_STAT error and a truncated
+//  tail, and stream captures with a corrupted packet and a change of sample type, then
+//  runs the decoder on them. Legacy decoding must resynchronize after every fault, count
+//  each bad checksum, deliver exactly the intact frames and produce byte-identical CSV and
+//  binary output for any -j. Replay through the driver must deliver the same rows as a
+//  plain decode, with the bad checksums and TIME_STAMP gaps reported by the driver's
+//  integrity engine.
+//
+//  Build the decoder with small chunks so the captures span many of them, then the check,
+//  from the repository root:
+//    g++ -O2 -std=c++17 -pthread -DCHUNK_BYTES=4096 -Isrc -Iextras/bench
+//        -DADIS16470_TRANSPORT_HEADER='"ADIS16470_RecordingTransport.h"'
+//        extras/tools/ADIS16470_Decode.cpp src/*.cpp -o adis16470_decode
+//    g++ -O2 -Isrc extras/bench/ADIS16470_DecodeCheck.cpp src/ADIS16470_Stream.cpp -o decode_check
+//    ./decode_check ./adis16470_decode
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "ADIS16470_Stream.h"
+
+#define LEGACY_FRAMES   20000
+#define JUNK_EVERY      97    // Junk bytes before every 97th frame
+#define FALSE_EVERY     211   // A delimiter with garbage behind it before every 211th frame
+#define CORRUPT_EVERY   331   // Every 331st frame has a flipped data byte
+#define DIAG_FRAME      500   // Frame with a DIAG_STAT bit set
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+  if (!ok)
+    failures++;
+}
+
+static const char *decoder = nullptr;
+static char dir[] = "/tmp/adis16470_decode_XXXXXX";
+
+// Path of a file in the scratch directory
+static std::string path(const char *name) { return std::string(dir) + "/" + name; }
+
+static void writeFile(const char *name, const std::vector<uint8_t> &data) {
+  FILE *f = fopen(path(name).c_str(), "wb");
+  fwrite(data.data(), 1, data.size(), f);
+  fclose(f);
+}
+
+static std::string readFile(const char *name) {
+  std::string s;
+  FILE *f = fopen(path(name).c_str(), "rb");
+  if (f == nullptr)
+    return s;
+  char buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    s.append(buf, n);
+  fclose(f);
+  return s;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Runs the decoder with args on capture, writing output and stderr to the
+// named scratch files. Returns false if it fails to run.
+////////////////////////////////////////////////////////////////////////////
+static bool run(const char *args, const char *capture, const char *output, const char *log) {
+  std::string cmd = std::string("\"") + decoder + "\" " + args + " -w \"" + path(output) + "\" \"" +
+                    path(capture) + "\" 2> \"" + path(log) + "\"";
+  return system(cmd.c_str()) == 0;
+}
+
+// Counters from the "replay:" line of a log
+struct ReplayLine {
+  unsigned long long delivered = 0;
+  unsigned bursts = 0, badChecksum = 0, gaps = 0, missed = 0, duplicates = 0, diagErrors = 0, overruns = 0;
+};
+
+static bool parseReplay(const std::string &log, ReplayLine &r) {
+  size_t at = log.find("replay: ");
+  return at != std::string::npos &&
+         sscanf(log.c_str() + at, "replay: delivered %llu, bursts %u, bad checksums %u, gaps %u (%u samples), "
+                "duplicates %u, diag errors %u, overruns %u", &r.delivered, &r.bursts, &r.badChecksum, &r.gaps,
+                &r.missed, &r.duplicates, &r.diagErrors, &r.overruns) == 8;
+}
+
+// TIME_STAMP column (the last) of every CSV row
+static std::vector<unsigned> timeStamps(const std::string &csv) {
+  std::vector<unsigned> ts;
+  size_t line = csv.find('\n') + 1; // Skip the header
+  while (line < csv.size())
+  {
+    size_t end = csv.find('\n', line);
+    ts.push_back((unsigned)atoi(csv.c_str() + csv.rfind(',', end) + 1));
+    line = end + 1;
+  }
+  return ts;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Burst words of one sample: outputs derived from i, valid checksum
+////////////////////////////////////////////////////////////////////////////
+static void burstWords(uint32_t i, uint16_t diagStat, uint16_t *w, bool wide) {
+  int n = 0;
+  w[n++] = diagStat;
+  for (int c = 0; c < 6; c++)
+  {
+    int32_t v = (int32_t)((i * 7919u + c * 104729u) % 60000u) - 30000;
+    if (wide)
+      w[n++] = (uint16_t)(i * 31 + c); // LOW word
+    w[n++] = (uint16_t)v;
+  }
+  w[n++] = (uint16_t)(i % 200);     // TEMP_OUT
+  w[n++] = (uint16_t)i;             // TIME_STAMP, one per sample
+  w[n] = (uint16_t)adis16470Checksum(w, n);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Legacy captures: resync, bad checksums, -j and replay
+////////////////////////////////////////////////////////////////////////////
+static void legacy(void) {
+  printf("legacy capture\n");
+  std::mt19937 rng(3);
+  std::vector<uint8_t> data;
+  std::vector<unsigned> expected;
+  unsigned corrupted = 0, falseDelimiters = 0;
+
+  // 0xA5 appears only in delimiters, so every resync lands on the next frame
+  auto junk = [&](int n) {
+    for (int k = 0; k < n; k++)
+    {
+      uint8_t b = (uint8_t)rng();
+      data.push_back(b == 0xA5 ? 0x5A : b);
+    }
+  };
+
+  for (uint32_t i = 0; i < LEGACY_FRAMES; i++)
+  {
+    if (i % JUNK_EVERY == 5)
+      junk(1 + rng() % 40);
+    if (i % FALSE_EVERY == 7)
+    {
+      data.insert(data.end(), 3, 0xA5);
+      junk(5);
+      falseDelimiters++;
+    }
+
+    uint16_t w[BURST_WORDS];
+    uint8_t bytes[2 * BURST_WORDS];
+    for (uint32_t salt = 0; ; salt += 65536) // Vary the outputs, not TIME_STAMP, until no byte is 0xA5
+    {
+      burstWords(i + salt, (i == DIAG_FRAME) ? 0x0004 : 0, w, false);
+      bool clean = true;
+      for (int k = 0; k < BURST_WORDS; k++)
+      {
+        bytes[2 * k] = w[k] >> 8;
+        bytes[2 * k + 1] = w[k] & 0xFF;
+        clean = clean && bytes[2 * k] != 0xA5 && (bytes[2 * k + 1] != 0xA5 || k == 8);
+      }
+      if (clean) // A lone 0xA5 in the TIME_STAMP low byte never forms a delimiter
+        break;
+    }
+    if (i % CORRUPT_EVERY == 11)
+    {
+      bytes[5] = (bytes[5] == 0xA4) ? 0x00 : bytes[5] ^ 0x01;
+      corrupted++;
+    }
+    else
+      expected.push_back(i);
+    data.insert(data.end(), 3, 0xA5);
+    data.insert(data.end(), bytes, bytes + sizeof(bytes));
+  }
+  data.insert(data.end(), 3, 0xA5); // Truncated frame at the end
+  data.insert(data.end(), 10, 0x11);
+  writeFile("legacy.bin", data);
+
+  check(run("-j 1", "legacy.bin", "j1.csv", "j1.log"), "decoder runs");
+  std::string csv = readFile("j1.csv");
+  unsigned long long frames = 0, bad = 0, skipped = 0;
+  std::string log = readFile("j1.log");
+  sscanf(log.c_str(), "frames %llu, bad checksums %llu, skipped bytes %llu", &frames, &bad, &skipped);
+  check(frames == expected.size(), "every intact frame is decoded");
+  check(bad == corrupted + falseDelimiters, "corrupted frames and false delimiters count as bad");
+  check(timeStamps(csv) == expected, "rows hold the intact frames in order");
+
+  bool same = true;
+  for (const char *j : { "-j 2", "-j 3", "-j 8" })
+  {
+    run(j, "legacy.bin", "jn.csv", "jn.log");
+    same = same && readFile("jn.csv") == csv && readFile("jn.log").compare(0, log.find('\n'), log, 0, log.find('\n')) == 0;
+  }
+  check(same, "CSV and counters identical for -j 1, 2, 3 and 8");
+
+  run("-j 1 -o bin", "legacy.bin", "j1.bin", "j1b.log");
+  run("-j 5 -o bin", "legacy.bin", "j5.bin", "j5b.log");
+  std::string bin = readFile("j1.bin");
+  check(!bin.empty() && bin == readFile("j5.bin"), "binary output identical for -j 1 and -j 5");
+
+  ReplayLine r;
+  check(run("-r 0", "legacy.bin", "replay.csv", "replay.log"), "replay runs");
+  check(readFile("replay.csv") == csv, "replay delivers the same rows as decoding");
+  check(parseReplay(readFile("replay.log"), r), "replay reports the driver's integrity counters");
+  check(r.delivered == expected.size() && r.bursts == expected.size() + corrupted + falseDelimiters,
+        "driver read every burst, delivered every intact one");
+  check(r.badChecksum == corrupted + falseDelimiters && r.overruns == 0, "driver counts the bad checksums, no overruns");
+  check(r.gaps == corrupted && r.missed == corrupted && r.duplicates == 0, "each corrupted frame is one TIME_STAMP gap");
+  check(r.diagErrors == 1, "DIAG_STAT error seen by the driver");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Stream captures: decode and replay agree, lost packets become gaps
+////////////////////////////////////////////////////////////////////////////
+static void stream(void) {
+  printf("stream capture\n");
+  ADIS16470StreamEncoder enc;
+  std::vector<uint8_t> data;
+  std::vector<size_t> starts;
+  auto flush = [&]() {
+    size_t len = enc.finish();
+    if (len == 0)
+      return;
+    starts.push_back(data.size());
+    data.insert(data.end(), enc.data(), enc.data() + len);
+  };
+
+  // 3000 16-bit samples, then 3000 32-bit delta samples with TIME_STAMP running on
+  enc.begin(STREAM_INERTIAL16, true);
+  uint32_t i = 0;
+  for (; i < 3000; i++)
+  {
+    uint16_t w[BURST_WORDS];
+    ADIS16470Frame f;
+    burstWords(i, 0, w, false);
+    adis16470DecodeBurst(w, &f);
+    if (enc.add(f))
+      flush();
+  }
+  flush();
+  enc.begin(STREAM_DELTA32, true);
+  for (; i < 6000; i++)
+  {
+    uint16_t w[BURST32_WORDS];
+    ADIS16470DeltaFrame32 f;
+    burstWords(i, 0, w, true);
+    adis16470DecodeDeltaBurst32(w, &f);
+    if (enc.add(f))
+      flush();
+  }
+  flush();
+
+  // Corrupt one 16-bit packet and one 32-bit packet
+  size_t packets = starts.size();
+  data[starts[40] + 12] ^= 0x10;
+  data[starts[packets - 40] + 12] ^= 0x10;
+  writeFile("stream.bin", data);
+
+  check(run("-f stream", "stream.bin", "stream.csv", "stream.log"), "decoder runs");
+  std::string csv = readFile("stream.csv");
+  unsigned crc = 0;
+  std::string log = readFile("stream.log");
+  size_t at = log.find("crc errors ");
+  if (at != std::string::npos)
+    crc = (unsigned)atoi(log.c_str() + at + 11);
+  check(crc == 2, "two packets fail their CRC");
+  check(timeStamps(csv).size() == 6000 - 2 * ADIS16470_STREAM_SAMPLES, "the other samples are decoded");
+
+  ReplayLine r;
+  check(run("-f stream -r 0", "stream.bin", "sreplay.csv", "sreplay.log"), "stream replay runs");
+  check(readFile("sreplay.csv") == csv, "replay delivers the same rows across the type change");
+  check(parseReplay(readFile("sreplay.log"), r), "replay reports the driver's integrity counters");
+  check(r.bursts == 6000 - 2 * ADIS16470_STREAM_SAMPLES && r.badChecksum == 0 && r.overruns == 0,
+        "driver reads every sample, all checksums valid");
+  check(r.gaps == 2 && r.missed == 2 * ADIS16470_STREAM_SAMPLES, "each lost packet is one TIME_STAMP gap");
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2)
+  {
+    fprintf(stderr, "usage: decode_check path/to/adis16470_decode\n");
+    return 2;
+  }
+  decoder = argv[1];
+  if (mkdtemp(dir) == nullptr)
+  {
+    perror("mkdtemp");
+    return 1;
+  }
+
+  legacy();
+  stream();
+
+  std::string cmd = std::string("rm -rf \"") + dir + "\"";
+  if (system(cmd.c_str()) != 0)
+    fprintf(stderr, "could not remove %s\n", dir);
+
+  printf(failures ? "%d FAILED\n" : "all passed\n", failures);
+  return failures ? 1 : 0;
+}
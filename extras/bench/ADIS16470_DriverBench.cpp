@@ -0,0 +1,284 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_DriverBench.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Host benchmark of the driver's hot paths. The real ADIS16470 class is linked against
+//  a recording fake bus (ADIS16470_RecordingTransport.h). For each operation it reports
+//  the host CPU time per call with the bus itself free, plus the SPI frames, the bytes
+//  clocked and the modeled bus time (SCLK time plus stalls) at the configured clocks.
+//  The bus time is also checked against the model in ADIS16470_Timing.h.
+//
+//  It ends with the sustained rate of the data ready pipeline. Each sample costs the
+//  queueBurst() bus time, the ISR and readFrames() CPU time and the batch scaling time;
+//  at higher sample rates data would be dropped. The CPU figures are for the host, so
+//  compare them between runs rather than with a target MCU. --json prints one JSON
+//  object for tracking results over time.
+//
+//  Build and run from the repository root:
+//    g++ -O2 -DADIS16470_TRANSPORT_HEADER='"ADIS16470_RecordingTransport.h"' -Isrc -Iextras/bench
+//        extras/bench/ADIS16470_DriverBench.cpp src/*.cpp -o driver_bench
+//    ./driver_bench [--json] [--iterations N] [--sclk HZ] [--burst-sclk HZ]
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "ADIS16470.h"
+
+#if !defined(ADIS16470_TRANSPORT_HEADER)
+#error Build with -DADIS16470_TRANSPORT_HEADER='"ADIS16470_RecordingTransport.h"'
+#endif
+
+#define BATCH_FRAMES 64 // Frames per adis16470ScaleFrames() call
+
+struct Result {
+  const char *name;
+  double cpuNs;      // Host CPU per call, bus free
+  uint32_t frames;   // CS assertions per call
+  uint64_t bytes;    // Bytes clocked per call
+  double busNs;      // Recorded SCLK time plus delays per call
+  double modelNs;    // ADIS16470_Timing.h prediction (0 for no bus traffic)
+};
+
+// Keeps a value alive without storing it
+template <class T> static inline void keep(const T &value) {
+  __asm__ volatile("" : : "g"(&value) : "memory");
+}
+
+static double nowNs(void) {
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Records the bus activity of one call, then times iterations calls and
+// keeps the fastest of five runs.
+////////////////////////////////////////////////////////////////////////////
+template <class Fn>
+static Result measure(const char *name, ADIS16470RecordingBus &bus, long iterations, double modelNs, Fn fn) {
+  bus.clear();
+  fn(0);
+  Result r = { name, 0, bus.frames, bus.bytes, bus.busNs(), modelNs };
+
+  double best = INFINITY;
+  for (int run = 0; run < 5; run++)
+  {
+    double start = nowNs();
+    for (long i = 0; i < iterations; i++)
+      fn(i);
+    double t = (nowNs() - start) / iterations;
+    if (t < best)
+      best = t;
+  }
+  r.cpuNs = best;
+  return r;
+}
+
+// Burst reply as clocked out by the sensor: two bytes during the command, then the words
+static size_t buildBurstReply(uint8_t *reply, int words) {
+  uint16_t w[BURST32_WORDS];
+  for (int i = 0; i < words - 1; i++)
+    w[i] = (uint16_t)(0x1234 + 0x0101 * i);
+  w[0] = 0; // DIAG_STAT clear
+  w[words - 1] = (uint16_t)adis16470Checksum(w, words - 1);
+  reply[0] = 0;
+  reply[1] = 0;
+  for (int i = 0; i < words; i++)
+  {
+    reply[2 + 2 * i] = w[i] >> 8;
+    reply[3 + 2 * i] = w[i] & 0xFF;
+  }
+  return 2 + 2 * words;
+}
+
+int main(int argc, char **argv) {
+
+  bool json = false;
+  long iterations = 200000;
+  uint32_t sclkHz = SCLK_MAX_HZ;
+  uint32_t burstHz = SCLK_BURST_MAX_HZ;
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "--json"))
+      json = true;
+    else if (!strcmp(argv[i], "--iterations") && i + 1 < argc)
+      iterations = strtol(argv[++i], nullptr, 0);
+    else if (!strcmp(argv[i], "--sclk") && i + 1 < argc)
+      sclkHz = strtoul(argv[++i], nullptr, 0);
+    else if (!strcmp(argv[i], "--burst-sclk") && i + 1 < argc)
+      burstHz = strtoul(argv[++i], nullptr, 0);
+    else
+    {
+      fprintf(stderr, "usage: %s [--json] [--iterations N] [--sclk HZ] [--burst-sclk HZ]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (iterations < 1 || sclkHz == 0 || burstHz == 0)
+    return 2;
+
+  ADIS16470RecordingBus bus;
+  ADIS16470 imu(10, 2, 6, bus);
+  if (imu.configSPI(sclkHz, sclkHz, burstHz) < 0)
+  {
+    fprintf(stderr, "SCLK above the datasheet limits (%lu Hz registers, %lu Hz bursts)\n",
+            (unsigned long)SCLK_MAX_HZ, (unsigned long)SCLK_BURST_MAX_HZ);
+    return 2;
+  }
+  imu.setTimeStampStep(0); // The canned burst repeats its TIME_STAMP
+
+  static const uint8_t regReply[2] = { 0x40, 0x56 };
+  uint8_t burstReply[2 + 2 * BURST_WORDS];
+  uint8_t burst32Reply[2 + 2 * BURST32_WORDS];
+  size_t burstLength = buildBurstReply(burstReply, BURST_WORDS);
+  size_t burst32Length = buildBurstReply(burst32Reply, BURST32_WORDS);
+
+  uint16_t words[BURST_WORDS];
+  uint16_t words32[BURST32_WORDS];
+  memcpy(words, imu.wordBurst(), sizeof(words));
+  memcpy(words32, imu.wordBurst32(), sizeof(words32));
+  ADIS16470Frame frame;
+  adis16470DecodeBurst(words, &frame);
+
+  std::vector<ADIS16470Frame> frames(BATCH_FRAMES, frame);
+  std::vector<float> soa(7 * BATCH_FRAMES);
+  ADIS16470ScaledData scaled = { &soa[0], &soa[BATCH_FRAMES], &soa[2 * BATCH_FRAMES], &soa[3 * BATCH_FRAMES],
+                                 &soa[4 * BATCH_FRAMES], &soa[5 * BATCH_FRAMES], &soa[6 * BATCH_FRAMES] };
+
+  const uint8_t regAddrs[8] = { X_GYRO_OUT, Y_GYRO_OUT, Z_GYRO_OUT, X_ACCL_OUT, Y_ACCL_OUT, Z_ACCL_OUT, TEMP_OUT, TIME_STAMP };
+  const ADIS16470RegValue config[] = { { MSC_CTRL, 0xC1 }, { FILT_CTRL, 0x04 }, { DEC_RATE, 0x00 } };
+  imu.applyConfig(config, 3); // Fill the shadow so the benchmark measures the no-change path
+
+  std::vector<Result> results;
+  bus.reply = regReply;
+  bus.replyLength = sizeof(regReply);
+
+  results.push_back(measure("regRead", bus, iterations, adis16470RegReadUs(sclkHz, 1) * 1e3,
+    [&](long) { keep(imu.regRead(PROD_ID)); }));
+  results.push_back(measure("regReadMany(8)", bus, iterations / 4, adis16470RegReadUs(sclkHz, 8) * 1e3,
+    [&](long) { int16_t out[8]; imu.regReadMany(regAddrs, out, 8); keep(out); }));
+  results.push_back(measure("regRead32", bus, iterations, adis16470RegReadUs(sclkHz, 2) * 1e3,
+    [&](long) { keep(imu.regRead32(X_DELTANG_LOW)); }));
+  results.push_back(measure("regWrite", bus, iterations, adis16470RegWriteUs(sclkHz) * 1e3,
+    [&](long i) { keep(imu.regWrite(USER_SCR1, (int16_t)i)); }));
+  results.push_back(measure("applyConfig(3, unchanged)", bus, iterations, 0,
+    [&](long) { keep(imu.applyConfig(config, 3)); }));
+
+  bus.reply = burstReply;
+  bus.replyLength = burstLength;
+  results.push_back(measure("wordBurst", bus, iterations, adis16470BurstUs(burstHz, BURST_WORDS) * 1e3,
+    [&](long) { keep(imu.wordBurst()); }));
+  results.push_back(measure("byteBurst", bus, iterations, adis16470BurstUs(burstHz, BURST_WORDS) * 1e3,
+    [&](long) { keep(imu.byteBurst()); }));
+  results.push_back(measure("validatedBurst", bus, iterations, adis16470BurstUs(burstHz, BURST_WORDS) * 1e3,
+    [&](long) { ADIS16470Frame f; keep(imu.validatedBurst(&f)); keep(f); }));
+  results.push_back(measure("queueBurst+readFrames", bus, iterations, adis16470BurstUs(burstHz, BURST_WORDS) * 1e3,
+    [&](long) { ADIS16470Frame f; keep(imu.queueBurst()); keep(imu.readFrames(&f, 1)); keep(f); }));
+
+  bus.reply = burst32Reply;
+  bus.replyLength = burst32Length;
+  results.push_back(measure("wordBurst32", bus, iterations, adis16470BurstUs(burstHz, BURST32_WORDS) * 1e3,
+    [&](long) { keep(imu.wordBurst32()); }));
+  results.push_back(measure("burst32", bus, iterations, adis16470BurstUs(burstHz, BURST32_WORDS) * 1e3,
+    [&](long) { ADIS16470Frame32 f; keep(imu.burst32(&f)); keep(f); }));
+
+  // Pure computation: no bus traffic expected
+  results.push_back(measure("checksum", bus, iterations, 0,
+    [&](long i) { words[1] = (uint16_t)i; keep(imu.checksum(words)); }));
+  results.push_back(measure("checksum32", bus, iterations, 0,
+    [&](long i) { words32[1] = (uint16_t)i; keep(imu.checksum32(words32)); }));
+  results.push_back(measure("checksum(frame)", bus, iterations, 0,
+    [&](long i) { frame.gyro[0] = (int16_t)i; keep(imu.checksum(&frame)); }));
+  results.push_back(measure("accelScale", bus, iterations, 0,
+    [&](long i) { keep(imu.accelScale((int16_t)i)); }));
+  results.push_back(measure("gyroScale", bus, iterations, 0,
+    [&](long i) { keep(imu.gyroScale((int16_t)i)); }));
+  results.push_back(measure("tempScale", bus, iterations, 0,
+    [&](long i) { keep(imu.tempScale((int16_t)i)); }));
+  results.push_back(measure("deltaAngleScale", bus, iterations, 0,
+    [&](long i) { keep(imu.deltaAngleScale((int16_t)i)); }));
+  results.push_back(measure("deltaVelocityScale", bus, iterations, 0,
+    [&](long i) { keep(imu.deltaVelocityScale((int16_t)i)); }));
+  results.push_back(measure("gyroScale32", bus, iterations, 0,
+    [&](long i) { keep(imu.gyroScale32((int32_t)i * 65537)); }));
+  results.push_back(measure("adis16470ScaleFrames(64)", bus, iterations / BATCH_FRAMES, 0,
+    [&](long) { adis16470ScaleFrames(frames.data(), BATCH_FRAMES, scaled); keep(soa[0]); }));
+
+  // Sustained data ready pipeline: ISR burst into the queue, drain, batch scaling
+  const Result *pipeline = nullptr;
+  const Result *scale = nullptr;
+  for (const Result &r : results)
+  {
+    if (!strcmp(r.name, "queueBurst+readFrames")) pipeline = &r;
+    if (!strcmp(r.name, "adis16470ScaleFrames(64)")) scale = &r;
+  }
+  double cpuPerSample = pipeline->cpuNs + scale->cpuNs / BATCH_FRAMES;
+  double busPerSample = pipeline->busNs;
+  double busLimitSps = 1e9 / busPerSample;
+  double sustainedSps = 1e9 / (busPerSample + cpuPerSample);
+  double sensorSps = 2000;
+
+  // Recorded bus time must agree with the timing model (which rounds up to whole microseconds)
+  int modelMismatches = 0;
+  for (const Result &r : results)
+    if (r.busNs > r.modelNs + 1 || r.busNs < r.modelNs - 1000 * (r.frames + 1))
+      modelMismatches++;
+
+  if (json)
+  {
+    printf("{\n  \"schema\": 1,\n  \"config\": { \"sclk_hz\": %u, \"burst_sclk_hz\": %u, \"iterations\": %ld },\n",
+           sclkHz, burstHz, iterations);
+    printf("  \"operations\": [\n");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+      const Result &r = results[i];
+      printf("    { \"name\": \"%s\", \"cpu_ns\": %.3f, \"frames\": %u, \"bytes\": %llu, \"bus_ns\": %.1f, \"model_ns\": %.1f }%s\n",
+             r.name, r.cpuNs, r.frames, (unsigned long long)r.bytes, r.busNs, r.modelNs,
+             (i + 1 < results.size()) ? "," : "");
+    }
+    printf("  ],\n");
+    printf("  \"throughput\": { \"bus_ns_per_sample\": %.1f, \"cpu_ns_per_sample\": %.3f, \"bus_limit_sps\": %.1f, "
+           "\"sustained_sps\": %.1f, \"headroom_at_2000_sps\": %.3f },\n",
+           busPerSample, cpuPerSample, busLimitSps, sustainedSps, sustainedSps / sensorSps);
+    printf("  \"model_mismatches\": %d\n}\n", modelMismatches);
+  }
+  else
+  {
+    printf("SCLK %u Hz (registers), %u Hz (bursts), %ld iterations\n\n", sclkHz, burstHz, iterations);
+    printf("%-28s %10s %7s %7s %11s %11s\n", "operation", "cpu ns", "frames", "bytes", "bus us", "model us");
+    for (const Result &r : results)
+    {
+      printf("%-28s %10.2f %7u %7llu %11.3f %11.3f\n", r.name, r.cpuNs, r.frames, (unsigned long long)r.bytes,
+             r.busNs * 1e-3, r.modelNs * 1e-3);
+    }
+    printf("\nper sample: %.3f us bus + %.1f ns CPU (queueBurst, readFrames, 1/%d of adis16470ScaleFrames)\n",
+           busPerSample * 1e-3, cpuPerSample, BATCH_FRAMES);
+    printf("bus limit:       %9.1f samples/s\n", busLimitSps);
+    printf("sustained limit: %9.1f samples/s (%.2fx the 2000 SPS sensor maximum)\n", sustainedSps, sustainedSps / sensorSps);
+    if (modelMismatches)
+      printf("%d operations disagree with ADIS16470_Timing.h\n", modelMismatches);
+  }
+
+  return modelMismatches ? 1 : 0;
+}
@@ -0,0 +1,347 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_FilterCheck.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Host check and benchmark for ADIS16470_Filter. A direct reference implementation works
+//  on whole recordings (biquads as difference equations over arrays, CIC as N nested 
+//  length-R moving sums, boxcar as window sums, FIR as a plain dot product, statistics by
+//  scanning each window) and every output field of the streaming filter must match it 
+//  bit for bit over a range of rates, CIC orders, biquad cascades, FIR lengths and inputs
+//  that include full-scale steps. Then the worst-case configuration is timed.
+//
+//  Build and run from the repository root:
+//    g++ -O2 -Isrc extras/bench/ADIS16470_FilterCheck.cpp src/ADIS16470_Filter.cpp -o filter_check
+//    ./filter_check
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "ADIS16470_Filter.h"
+
+struct Config {
+  uint32_t inputHz, outputHz;
+  uint8_t cicOrder;
+  std::vector<ADIS16470Biquad> biquads[FILTER_CHANNELS];
+  std::vector<int16_t> taps[FILTER_CHANNELS];
+};
+
+////////////////////////////////////////////////////////////////////////////
+// Reference implementation
+////////////////////////////////////////////////////////////////////////////
+
+static int32_t sat32(int64_t v) {
+  return (v > INT32_MAX) ? INT32_MAX : (v < INT32_MIN) ? INT32_MIN : (int32_t)v;
+}
+
+// floor(acc / 2^shift + 1/2)
+static int32_t refRound(int64_t acc, int shift) {
+  int64_t half = (int64_t)1 << (shift - 1);
+  int64_t q = acc + half;
+  int64_t d = (int64_t)1 << shift;
+  int64_t f = q / d;
+  if ((q % d != 0) && (q < 0))
+    f--;
+  return sat32(f);
+}
+
+// num / den to nearest, ties away from zero
+static int32_t refDiv(int64_t num, int64_t den) {
+  int64_t q = num / den, r = num % den;
+  if (2 * (r < 0 ? -r : r) >= den)
+    q += (num < 0) ? -1 : 1;
+  return sat32(q);
+}
+
+static uint32_t refIsqrt(uint64_t x) {
+  uint64_t r = (uint64_t)sqrt((double)x);
+  while (r * r > x) r--;
+  while ((r + 1) * (r + 1) <= x) r++;
+  return (uint32_t)r;
+}
+
+static std::vector<ADIS16470FilterOutput> reference(const Config &cfg, const std::vector<ADIS16470Frame> &in) {
+
+  size_t n = in.size();
+  std::vector<ADIS16470FilterOutput> out;
+
+  // Window boundaries: an output follows sample i when floor((i+1)*out/in) steps
+  std::vector<size_t> ends;
+  for (size_t i = 0; i < n; i++)
+    if (((uint64_t)(i + 1) * cfg.outputHz) / cfg.inputHz > ((uint64_t)i * cfg.outputHz) / cfg.inputHz)
+      ends.push_back(i);
+  out.resize(ends.size());
+
+  uint32_t ratio = cfg.inputHz / cfg.outputHz;
+  for (int c = 0; c < FILTER_CHANNELS; c++)
+  {
+    // Biquads
+    std::vector<int64_t> x(n), y(n);
+    for (size_t i = 0; i < n; i++)
+      x[i] = (c < 3 ? in[i].gyro[c] : in[i].accl[c - 3]) * 256;
+    for (const ADIS16470Biquad &q : cfg.biquads[c])
+    {
+      for (size_t i = 0; i < n; i++)
+      {
+        int64_t acc = q.b0 * x[i];
+        if (i >= 1) acc += q.b1 * x[i - 1] - q.a1 * y[i - 1];
+        if (i >= 2) acc += q.b2 * x[i - 2] - q.a2 * y[i - 2];
+        y[i] = refRound(acc, FILTER_BIQUAD_SHIFT);
+      }
+      x = y;
+    }
+
+    // Decimator
+    std::vector<int64_t> d(ends.size());
+    if (cfg.cicOrder == 0)
+      for (size_t m = 0; m < ends.size(); m++)
+        d[m] = x[ends[m]];
+    else if (cfg.cicOrder == 1)
+    {
+      size_t start = 0;
+      for (size_t m = 0; m < ends.size(); m++)
+      {
+        int64_t sum = 0;
+        for (size_t i = start; i <= ends[m]; i++)
+          sum += x[i];
+        d[m] = refDiv(sum, ends[m] - start + 1);
+        start = ends[m] + 1;
+      }
+    }
+    else
+    {
+      std::vector<int64_t> s = x, t(n);
+      int64_t gain = 1;
+      for (int k = 0; k < cfg.cicOrder; k++)
+      {
+        for (size_t i = 0; i < n; i++)
+        {
+          t[i] = 0;
+          for (uint32_t j = 0; j < ratio && j <= i; j++)
+            t[i] += s[i - j];
+        }
+        s = t;
+        gain *= ratio;
+      }
+      for (size_t m = 0; m < ends.size(); m++)
+        d[m] = refDiv(s[ends[m]], gain);
+    }
+
+    // FIR
+    const std::vector<int16_t> &taps = cfg.taps[c];
+    for (size_t m = 0; m < ends.size(); m++)
+    {
+      int64_t v = d[m];
+      if (!taps.empty())
+      {
+        int64_t acc = 0;
+        for (size_t k = 0; k < taps.size() && k <= m; k++)
+          acc += taps[k] * d[m - k];
+        v = refRound(acc, FILTER_FIR_SHIFT);
+      }
+      out[m].value[c] = (int32_t)v;
+    }
+
+    // Window statistics
+    size_t start = 0;
+    for (size_t m = 0; m < ends.size(); m++)
+    {
+      int16_t lo = INT16_MAX, hi = INT16_MIN;
+      uint64_t sq = 0;
+      uint16_t diag = 0;
+      for (size_t i = start; i <= ends[m]; i++)
+      {
+        int16_t r = (c < 3) ? in[i].gyro[c] : in[i].accl[c - 3];
+        if (r < lo) lo = r;
+        if (r > hi) hi = r;
+        sq += (uint64_t)((int64_t)r * r);
+        diag |= in[i].diagStat;
+      }
+      uint64_t cnt = ends[m] - start + 1;
+      out[m].min[c] = lo;
+      out[m].max[c] = hi;
+      out[m].rms[c] = (uint16_t)refIsqrt((sq + cnt / 2) / cnt);
+      out[m].samples = (uint16_t)cnt;
+      out[m].diagStat = diag;
+      out[m].temp = in[ends[m]].temp;
+      out[m].timeStamp = in[ends[m]].timeStamp;
+      start = ends[m] + 1;
+    }
+  }
+  return out;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Test inputs and coefficients
+////////////////////////////////////////////////////////////////////////////
+
+// RBJ low-pass quantized to Q2.30
+static ADIS16470Biquad lowPass(double fc, double fs, double q) {
+  double w = 2 * M_PI * fc / fs, alpha = sin(w) / (2 * q), cw = cos(w), a0 = 1 + alpha;
+  double s = (double)(1 << FILTER_BIQUAD_SHIFT);
+  ADIS16470Biquad b;
+  b.b0 = (int32_t)llround((1 - cw) / 2 / a0 * s);
+  b.b1 = (int32_t)llround((1 - cw) / a0 * s);
+  b.b2 = b.b0;
+  b.a1 = (int32_t)llround(-2 * cw / a0 * s);
+  b.a2 = (int32_t)llround((1 - alpha) / a0 * s);
+  return b;
+}
+
+static std::vector<ADIS16470Frame> makeInput(size_t n, unsigned seed) {
+  srand(seed);
+  std::vector<ADIS16470Frame> in(n);
+  for (size_t i = 0; i < n; i++)
+  {
+    ADIS16470Frame &f = in[i];
+    for (int c = 0; c < 3; c++)
+    {
+      double v = 8000 * sin(0.01 * (c + 1) * i) + (rand() % 2001 - 1000);
+      f.gyro[c] = (int16_t)v;
+      f.accl[c] = (int16_t)(rand() % 65536 - 32768);
+    }
+    if (i % 997 == 500) // Full-scale steps
+      f.gyro[0] = (i % 2) ? INT16_MAX : INT16_MIN;
+    f.temp = (int16_t)(i & 0x7FF);
+    f.diagStat = (rand() % 50 == 0) ? (uint16_t)(1 << (rand() % 10)) : 0;
+    f.timeStamp = (uint16_t)i;
+    f.checksum = 0;
+  }
+  return in;
+}
+
+static bool same(const ADIS16470FilterOutput &a, const ADIS16470FilterOutput &b) {
+  for (int c = 0; c < FILTER_CHANNELS; c++)
+    if (a.value[c] != b.value[c] || a.min[c] != b.min[c] || a.max[c] != b.max[c] || a.rms[c] != b.rms[c])
+      return false;
+  return a.temp == b.temp && a.diagStat == b.diagStat && a.timeStamp == b.timeStamp && a.samples == b.samples;
+}
+
+static bool runCase(const char *name, const Config &cfg, size_t n, unsigned seed) {
+  ADIS16470Filter filter;
+  if (filter.setRates(cfg.inputHz, cfg.outputHz, cfg.cicOrder) != 1)
+  {
+    printf("FAIL %s: rejected\n", name);
+    return false;
+  }
+  for (int c = 0; c < FILTER_CHANNELS; c++)
+  {
+    filter.setBiquads(c, cfg.biquads[c].data(), (uint8_t)cfg.biquads[c].size());
+    filter.setFir(c, cfg.taps[c].data(), (uint8_t)cfg.taps[c].size());
+  }
+
+  std::vector<ADIS16470Frame> in = makeInput(n, seed);
+  std::vector<ADIS16470FilterOutput> ref = reference(cfg, in);
+
+  size_t m = 0;
+  ADIS16470FilterOutput o;
+  for (size_t i = 0; i < n; i++)
+  {
+    if (!filter.push(in[i], &o))
+      continue;
+    if (m >= ref.size() || !same(o, ref[m]))
+    {
+      printf("FAIL %s: output %zu (sample %zu)\n", name, m, i);
+      return false;
+    }
+    m++;
+  }
+  if (m != ref.size())
+  {
+    printf("FAIL %s: %zu outputs, expected %zu\n", name, m, ref.size());
+    return false;
+  }
+  printf("ok   %-28s %6zu outputs\n", name, m);
+  return true;
+}
+
+int main(void) {
+
+  struct { const char *name; uint32_t in, out; uint8_t order; int biquads; int taps; } cases[] = {
+    { "pass-through",            2000, 2000, 0, 0, 0 },
+    { "pick latest 2000->100",   2000,  100, 0, 2, 0 },
+    { "boxcar 2000->100",        2000,  100, 1, 0, 0 },
+    { "boxcar 2000->300 (frac)", 2000,  300, 1, 1, 8 },
+    { "boxcar 2000->7 (frac)",   2000,    7, 1, 0, 0 },
+    { "cic2 2000->250",          2000,  250, 2, 0, 5 },
+    { "cic3 2000->200",          2000,  200, 3, 2, 16 },
+    { "cic3 2000->1000",         2000, 1000, 3, 0, 0 },
+    { "max cascade 2000->100",   2000,  100, 3, FILTER_MAX_BIQUADS, FILTER_MAX_TAPS },
+  };
+
+  int failures = 0;
+  unsigned seed = 1;
+  for (auto &tc : cases)
+  {
+    Config cfg;
+    cfg.inputHz = tc.in;
+    cfg.outputHz = tc.out;
+    cfg.cicOrder = tc.order;
+    for (int c = 0; c < FILTER_CHANNELS; c++)
+    {
+      for (int i = 0; i < tc.biquads; i++) // Per-axis cutoffs
+        cfg.biquads[c].push_back(lowPass(50.0 + 40 * c + 25 * i, tc.in, 0.707));
+      for (int k = 0; k < tc.taps; k++)
+        cfg.taps[c].push_back((int16_t)(rand() % 8192 - 2048));
+    }
+    if (!runCase(tc.name, cfg, 20000, seed++))
+      failures++;
+  }
+
+  // Invalid settings must be rejected
+  ADIS16470Filter f;
+  if (f.setRates(2000, 300, 2) != -1 || f.setRates(100, 200, 1) != -1 || f.setRates(2000, 100, 4) != -1)
+  {
+    printf("FAIL invalid rates accepted\n");
+    failures++;
+  }
+
+  // Worst-case timing
+  {
+    ADIS16470Filter filter;
+    filter.setRates(2000, 100, FILTER_MAX_CIC);
+    std::vector<int16_t> taps(FILTER_MAX_TAPS, 1024);
+    std::vector<ADIS16470Biquad> bq(FILTER_MAX_BIQUADS, lowPass(100, 2000, 0.707));
+    for (int c = 0; c < FILTER_CHANNELS; c++)
+    {
+      filter.setBiquads(c, bq.data(), FILTER_MAX_BIQUADS);
+      filter.setFir(c, taps.data(), FILTER_MAX_TAPS);
+    }
+    std::vector<ADIS16470Frame> in = makeInput(1 << 16, 99);
+    ADIS16470FilterOutput o;
+    uint32_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int p = 0; p < 50; p++)
+      for (const ADIS16470Frame &fr : in)
+        if (filter.push(fr, &o))
+          sink += (uint32_t)o.value[0];
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    printf("worst case (%d biquads, CIC%d, %d taps, 6 axes): %.1f ns/sample (%u)\n",
+           FILTER_MAX_BIQUADS, FILTER_MAX_CIC, FILTER_MAX_TAPS, ns / (50.0 * in.size()), sink & 1);
+  }
+
+  printf(failures ? "%d FAILED\n" : "all passed\n", failures);
+  return failures ? 1 : 0;
+}
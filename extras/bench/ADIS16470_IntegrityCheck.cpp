@@ -0,0 +1,254 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_IntegrityCheck.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Host check of the burst integrity accounting. The real ADIS16470 class is linked against
+//  the recording fake bus (ADIS16470_RecordingTransport.h), and each burst reply is built
+//  by hand to inject one fault: a bad checksum, a repeated or skipped TIME_STAMP, a wrap
+//  across 0xFFFF, TIME_STAMP jitter and DIAG_STAT bits. The status flags of every burst
+//  and each counter of integrityStats() are checked, followed by frame queue overruns
+//  with good and bad bursts and the buffer handshake of the asynchronous burst path.
+//
+//  Build and run from the repository root:
+//    g++ -O2 -DADIS16470_TRANSPORT_HEADER='"ADIS16470_RecordingTransport.h"' -Isrc -Iextras/bench
+//        extras/bench/ADIS16470_IntegrityCheck.cpp src/*.cpp -o integrity_check
+//    ./integrity_check
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include "ADIS16470.h"
+
+#if !defined(ADIS16470_TRANSPORT_HEADER)
+#error Build with -DADIS16470_TRANSPORT_HEADER='"ADIS16470_RecordingTransport.h"'
+#endif
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+  if (!ok)
+    failures++;
+}
+
+static ADIS16470RecordingBus bus;
+static uint8_t reply[2 + 2 * BURST_WORDS];
+
+////////////////////////////////////////////////////////////////////////////
+// Loads the reply of the next burst: two bytes during the command, then
+// the words. badChecksum sends a checksum one higher than the data sum.
+////////////////////////////////////////////////////////////////////////////
+static void nextBurst(uint16_t diagStat, uint16_t timeStamp, bool badChecksum = false) {
+  typedef ADIS16470BurstLayout L;
+  uint16_t w[BURST_WORDS];
+  for (int i = 0; i < BURST_WORDS - 1; i++)
+    w[i] = (uint16_t)(0x0102 * i + timeStamp);
+  w[L::diagStat] = diagStat;
+  w[L::timeStamp] = timeStamp;
+  w[L::checksum] = (uint16_t)(adis16470Checksum(w, BURST_WORDS - 1) + (badChecksum ? 1 : 0));
+  reply[0] = 0;
+  reply[1] = 0;
+  for (int i = 0; i < BURST_WORDS; i++)
+  {
+    reply[2 + 2 * i] = w[i] >> 8;
+    reply[3 + 2 * i] = w[i] & 0xFF;
+  }
+  bus.reply = reply;
+  bus.replyLength = sizeof(reply);
+}
+
+static uint8_t burst(ADIS16470 &imu, uint16_t diagStat, uint16_t timeStamp, bool badChecksum = false) {
+  ADIS16470Frame f;
+  nextBurst(diagStat, timeStamp, badChecksum);
+  return imu.validatedBurst(&f);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Checksum, duplicate and gap detection with a step of one
+////////////////////////////////////////////////////////////////////////////
+static void continuity(ADIS16470 &imu) {
+  printf("TIME_STAMP continuity\n");
+  imu.clearIntegrityStats();
+  imu.setTimeStampStep(1);
+
+  check(burst(imu, 0, 100) == 0 && burst(imu, 0, 101) == 0, "consecutive samples are clean");
+  check(burst(imu, 0, 101) == BURST_DUPLICATE, "repeated TIME_STAMP flags BURST_DUPLICATE");
+  check(burst(imu, 0, 104) == BURST_GAP, "skipped TIME_STAMP flags BURST_GAP");
+  check(burst(imu, DIAG_SPI_ERROR, 999, true) == BURST_BAD_CHECKSUM, "bad checksum flags BURST_BAD_CHECKSUM alone");
+  check(burst(imu, 0, 105) == 0, "bad checksum does not disturb tracking");
+
+  ADIS16470IntegrityStats s = imu.integrityStats();
+  check(s.bursts == 6 && s.badChecksum == 1, "bursts 6, badChecksum 1");
+  check(s.duplicates == 1 && s.gaps == 1 && s.samplesMissed == 2, "duplicates 1, gaps 1, samplesMissed 2");
+  check(s.diagErrors == 0 && s.jitter == 0 && s.overruns == 0, "no DIAG_STAT errors, jitter or overruns");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Unsigned TIME_STAMP deltas across 0xFFFF
+////////////////////////////////////////////////////////////////////////////
+static void wrap(ADIS16470 &imu) {
+  printf("TIME_STAMP wrap\n");
+  imu.clearIntegrityStats();
+
+  bool clean = true;
+  const uint16_t run[] = { 0xFFFD, 0xFFFE, 0xFFFF, 0x0000, 0x0001 };
+  for (uint16_t ts : run)
+    clean = clean && burst(imu, 0, ts) == 0;
+  check(clean, "0xFFFF -> 0x0000 is the next sample");
+
+  imu.setTimeStampStep(1); // Restart tracking
+  check(burst(imu, 0, 0xFFFE) == 0, "first sample after a restart is clean");
+  check(burst(imu, 0, 0x0002) == BURST_GAP, "gap across the wrap flags BURST_GAP");
+
+  ADIS16470IntegrityStats s = imu.integrityStats();
+  check(s.gaps == 1 && s.samplesMissed == 3, "wrap gap counts 3 missed samples");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Deltas off the nominal step by less than half a sample
+////////////////////////////////////////////////////////////////////////////
+static void jitter(ADIS16470 &imu) {
+  printf("TIME_STAMP jitter\n");
+  imu.clearIntegrityStats();
+  imu.setTimeStampStep(4);
+
+  check(burst(imu, 0, 0) == 0 && burst(imu, 0, 4) == 0, "exact step is clean");
+  check(burst(imu, 0, 9) == 0 && burst(imu, 0, 12) == 0, "step 4 +/- 1 is not a gap");
+  check(burst(imu, 0, 20) == BURST_GAP, "two steps is a gap");
+
+  ADIS16470IntegrityStats s = imu.integrityStats();
+  check(s.jitter == 2, "jitter 2");
+  check(s.gaps == 1 && s.samplesMissed == 1, "gaps 1, samplesMissed 1");
+  imu.setTimeStampStep(1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Per-bit DIAG_STAT counters
+////////////////////////////////////////////////////////////////////////////
+static void diag(ADIS16470 &imu) {
+  printf("DIAG_STAT\n");
+  imu.clearIntegrityStats();
+
+  check(burst(imu, DIAG_SPI_ERROR | DIAG_CLOCK_ERROR, 1) == BURST_DIAG_ERROR, "DIAG_STAT bits flag BURST_DIAG_ERROR");
+  check(burst(imu, DIAG_SPI_ERROR, 3) == (BURST_DIAG_ERROR | BURST_GAP), "DIAG_STAT and gap flags combine");
+
+  ADIS16470IntegrityStats s = imu.integrityStats();
+  check(s.diagErrors == 2, "diagErrors 2");
+  check(s.diagFlags[3] == 2 && s.diagFlags[7] == 1, "SPI error bit 2, clock error bit 1");
+  int others = 0;
+  for (int bit = 0; bit < 16; bit++)
+    if (bit != 3 && bit != 7)
+      others += s.diagFlags[bit];
+  check(others == 0, "other DIAG_STAT bits untouched");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// A full frame queue drops valid bursts and counts each once
+////////////////////////////////////////////////////////////////////////////
+static void overrun(ADIS16470 &imu) {
+  printf("frame queue overrun\n");
+  imu.clearIntegrityStats();
+
+  bool queued = true;
+  uint16_t ts = 1;
+  for (int i = 0; i < ADIS16470_QUEUE_DEPTH; i++)
+  {
+    nextBurst(0, ts++);
+    queued = queued && imu.queueBurst() == 0;
+  }
+  check(queued && imu.framesAvailable() == ADIS16470_QUEUE_DEPTH, "queue fills with clean samples");
+
+  nextBurst(0, ts++);
+  check(imu.queueBurst() == BURST_OVERRUN, "valid burst on a full queue flags BURST_OVERRUN");
+  nextBurst(0, ts++, true);
+  check(imu.queueBurst() == BURST_BAD_CHECKSUM, "bad burst on a full queue is not an overrun");
+
+  ADIS16470IntegrityStats s = imu.integrityStats();
+  check(s.overruns == 1 && imu.queueOverruns() == 1, "overruns 1 in integrityStats() and queueOverruns()");
+  check(s.badChecksum == 1 && s.gaps == 0, "badChecksum 1, no gaps");
+
+  ADIS16470Frame frames[ADIS16470_QUEUE_DEPTH];
+  size_t n = imu.readFrames(frames, ADIS16470_QUEUE_DEPTH);
+  check(n == ADIS16470_QUEUE_DEPTH && frames[0].timeStamp == 1, "queued frames drain in order");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Asynchronous bursts: flags reach the callback, and a burst arriving while
+// the application holds both buffers is dropped and counted once
+////////////////////////////////////////////////////////////////////////////
+static uint16_t *lastWords = nullptr;
+static uint8_t lastStatus = 0;
+static int callbacks = 0;
+
+static void onBurst(uint16_t *burstWords, uint8_t status) {
+  lastWords = burstWords;
+  lastStatus = status;
+  callbacks++;
+}
+
+static void asyncBursts(ADIS16470 &imu) {
+  printf("asynchronous bursts\n");
+  imu.clearIntegrityStats();
+  static uint16_t bufferA[BURST_WORDS], bufferB[BURST_WORDS];
+
+  imu.regWrite(MSC_CTRL, MSC_BURST32 | 0xC1);
+  check(imu.setBurstBuffers(bufferA, bufferB) == -1, "setBurstBuffers() rejects a 32-bit burst mode");
+  imu.regWrite(MSC_CTRL, 0xC1);
+  check(imu.setBurstBuffers(bufferA, bufferB) == 1, "setBurstBuffers() accepts a 16-bit burst mode");
+
+  nextBurst(0, 10);
+  check(imu.beginBurst(onBurst) == 1 && lastWords == bufferA && lastStatus == 0, "first burst fills buffer A, clean");
+  nextBurst(0, 11, true);
+  check(imu.beginBurst(onBurst) == 1 && lastWords == bufferB && lastStatus == BURST_BAD_CHECKSUM,
+        "bad checksum reaches the callback");
+  nextBurst(0, 12);
+  imu.beginBurst(onBurst);
+  nextBurst(0, 13, true);
+  imu.beginBurst(onBurst);
+  ADIS16470IntegrityStats s = imu.integrityStats();
+  check(callbacks == 2 && s.overruns == 1 && s.bursts == 4, "both buffers held: bursts dropped, one overrun");
+
+  imu.releaseBurst(bufferB);
+  nextBurst(0, 14);
+  check(imu.beginBurst(onBurst) == 1 && lastWords == bufferB && lastStatus == BURST_GAP, "released buffer refills, gap reported");
+  check(imu.releaseBurst(bufferA + 1) == -1, "releaseBurst() rejects other pointers");
+
+  imu.regWrite(MSC_CTRL, MSC_BURST32 | 0xC1);
+  imu.releaseBurst(bufferA);
+  check(imu.beginBurst(onBurst) == -1 && callbacks == 3, "beginBurst() rejects a 32-bit burst mode");
+  imu.regWrite(MSC_CTRL, 0xC1);
+}
+
+int main(void) {
+
+  ADIS16470 imu(10, 2, 6, bus);
+
+  continuity(imu);
+  wrap(imu);
+  jitter(imu);
+  diag(imu);
+  overrun(imu);
+  asyncBursts(imu);
+
+  printf(failures ? "%d FAILED\n" : "all passed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_ProfileCheck.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Host check of the timing instrumentation in ADIS16470_Profile. A fake clock injected with
+//  adis16470ProfileSetClock() is stepped through known durations, through the same scope and
+//  data ready hooks the driver uses, and the histogram buckets, count, min, max, sum,
+//  percentiles and the adis16470ProfileFormat() text are compared with their expected values.
+//  It also covers a clock wrapping through 0xFFFFFFFF and a truncated format buffer.
+//
+//  Build and run from the repository root:
+//    g++ -O2 -DADIS16470_PROFILE -Isrc extras/bench/ADIS16470_ProfileCheck.cpp src/ADIS16470_Profile.cpp
+//        -o profile_check
+//    ./profile_check
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstring>
+#include "ADIS16470_Profile.h"
+
+#if !defined(ADIS16470_PROFILE)
+#error Build with -DADIS16470_PROFILE
+#endif
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+  if (!ok)
+    failures++;
+}
+
+// Fake clock: one tick per microsecond, advanced by hand
+static uint32_t fakeNow = 0;
+static uint32_t fakeClock(void) { return fakeNow; }
+
+// Times one scope of exactly ticks, starting at start
+static void timeScope(int op, uint32_t start, uint32_t ticks) {
+  fakeNow = start;
+  ADIS16470ProfileScope scope(op);
+  fakeNow = start + ticks;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Durations 1..100 ticks: known buckets, min/max/sum and percentiles
+////////////////////////////////////////////////////////////////////////////
+static void histogram(void) {
+  printf("histogram\n");
+  for (uint32_t d = 1; d <= 100; d++)
+    timeScope(PROF_REG_READ, 1000 * d, d);
+
+  ADIS16470Histogram h = adis16470ProfileHistogram(PROF_REG_READ);
+  check(h.count == 100 && h.min == 1 && h.max == 100 && h.sum == 5050, "count 100, min 1, max 100, sum 5050");
+  check(h.buckets[0] == 0 && h.buckets[1] == 1 && h.buckets[3] == 1, "values below 4 get their own bucket");
+  check(h.buckets[4] == 1 && h.buckets[7] == 1, "4..7 split into four buckets of one");
+  check(h.buckets[8] == 2 && h.buckets[11] == 2, "8..15 split into four buckets of two");
+  check(h.buckets[18] == 8 && h.buckets[22] == 5, "48..55 holds 8, 96..111 holds 96..100");
+  uint32_t total = 0;
+  for (int i = 0; i < PROF_BUCKETS; i++)
+    total += h.buckets[i];
+  check(total == 100, "buckets add up to the count");
+  check(h.percentile(0.5f) == 55, "p50 is the top of the 48..55 bucket");
+  check(h.percentile(0.99f) == 100, "p99 is clamped to max");
+  check(h.percentile(0.0f) == 1, "p0 is the first sample");
+
+  ADIS16470Histogram empty = adis16470ProfileHistogram(PROF_SELECT);
+  check(empty.count == 0 && empty.percentile(0.5f) == 0, "unused operation stays empty");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Data ready latency hooks and clock wrap
+////////////////////////////////////////////////////////////////////////////
+static void latency(void) {
+  printf("data ready latency\n");
+  ADIS16470ProfileLatency edge;
+
+  fakeNow = 5000;
+  adis16470ProfileDataReady(edge);
+  fakeNow = 5250;
+  adis16470ProfileDataDone(edge);
+  adis16470ProfileDataDone(edge); // No edge pending, not recorded
+
+  fakeNow = 0xFFFFFF00;
+  adis16470ProfileDataReady(edge);
+  fakeNow = 0x00000100;
+  adis16470ProfileDataDone(edge);
+
+  ADIS16470Histogram h = adis16470ProfileHistogram(PROF_DR_LATENCY);
+  check(h.count == 2, "one latency per data ready edge");
+  check(h.min == 250 && h.max == 512, "latency across the 32-bit wrap is 512 ticks");
+
+  timeScope(PROF_BURST, 0xFFFFFFF0, 32);
+  h = adis16470ProfileHistogram(PROF_BURST);
+  check(h.count == 1 && h.min == 32 && h.max == 32, "scope across the 32-bit wrap is 32 ticks");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Text summary in nanoseconds at one tick per microsecond
+////////////////////////////////////////////////////////////////////////////
+static void format(void) {
+  printf("format\n");
+  char text[512];
+  size_t n = adis16470ProfileFormat(text, sizeof(text));
+  check(n == strlen(text), "returns the length written");
+  check(!strncmp(text, "op count min_ns mean_ns p50_ns p99_ns max_ns\n", 45), "header line");
+  check(strstr(text, "\nselect 0 0 0 0 0 0\n") != nullptr, "select: empty");
+  check(strstr(text, "\nregRead 100 1000 50500 55000 100000 100000\n") != nullptr, "regRead: 100 1000 50500 55000 100000 100000");
+  check(strstr(text, "\nburst 1 32000 32000 32000 32000 32000\n") != nullptr, "burst: 1 32000 32000 32000 32000 32000");
+  check(strstr(text, "\ndrLatency 2 250000 381000 255000 512000 512000\n") != nullptr, "drLatency: 2 250000 381000 255000 512000 512000");
+
+  char small[16];
+  n = adis16470ProfileFormat(small, sizeof(small));
+  check(n == sizeof(small) - 1 && small[n] == 0, "truncated output stays terminated");
+
+  adis16470ProfileReset();
+  n = adis16470ProfileFormat(text, sizeof(text));
+  check(strstr(text, "\nregRead 0 0 0 0 0 0\n") != nullptr, "adis16470ProfileReset() clears every histogram");
+}
+
+int main(void) {
+
+  adis16470ProfileSetClock(fakeClock, 1000000);
+  adis16470ProfileReset();
+
+  histogram();
+  latency();
+  format();
+
+  printf(failures ? "%d FAILED\n" : "all passed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_RecordingTransport.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Fake SPI transport for benchmarking the driver on a PC. Nothing is attached to the bus:
+//  each transfer returns the next byte of a canned reply (restarted at every CS assertion)
+//  and is counted, together with the SCLK time of the byte at the configured clock. Delays
+//  are recorded rather than slept, so the driver's CPU cost and its modeled bus time can
+//  be measured separately. Select it for the whole build with
+//    -DADIS16470_TRANSPORT_HEADER='"ADIS16470_RecordingTransport.h"' -Iextras/bench
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Bus activity counters and the canned reply
+struct ADIS16470RecordingBus {
+  uint32_t frames = 0;      // CS assertions
+  uint64_t bytes = 0;       // Bytes clocked
+  uint64_t clockPs = 0;     // SCLK time of those bytes, picoseconds
+  uint64_t delayNs = 0;     // Delays requested by the driver
+  uint32_t transactions = 0;
+
+  const uint8_t *reply = nullptr; // MISO bytes from each CS assertion (0 beyond the end)
+  size_t replyLength = 0;
+
+  // Clears the counters (the reply is kept)
+  void clear(void) { frames = 0; bytes = 0; clockPs = 0; delayNs = 0; transactions = 0; }
+
+  // Modeled bus time: clocked bytes plus stalls and other delays
+  double busNs(void) const { return clockPs * 1e-3 + delayNs; }
+
+  // Used by the transport
+  int csPin = -1;
+  uint32_t bytePs = 8000000;
+  size_t replyIndex = 0;
+};
+
+class ADIS16470RecordingTransport {
+
+public:
+  typedef ADIS16470RecordingBus Bus;
+  struct Settings { uint32_t bytePs; }; // Time per byte at the chosen SCLK
+
+  ADIS16470RecordingTransport(Bus &bus) : _bus(&bus) {}
+
+  static Bus &defaultBus(void) { static Bus bus; return bus; }
+
+  void begin(int CS, int DR, int RST) { (void)DR; (void)RST; _bus->csPin = CS; }
+
+  static Settings settings(uint32_t sclkHz) { Settings s = { (uint32_t)(8000000000000ULL / sclkHz) }; return s; }
+
+  void beginTransaction(const Settings &settings) { _bus->bytePs = settings.bytePs; _bus->transactions++; }
+  void endTransaction(void) {}
+
+  uint8_t transfer(uint8_t data) {
+    (void)data;
+    _bus->bytes++;
+    _bus->clockPs += _bus->bytePs;
+    size_t i = _bus->replyIndex++;
+    return (i < _bus->replyLength) ? _bus->reply[i] : 0;
+  }
+
+  void pinWrite(int pin, bool high) {
+    if (pin == _bus->csPin && !high)
+    {
+      _bus->frames++;
+      _bus->replyIndex = 0;
+    }
+  }
+  bool pinRead(int pin) { (void)pin; return false; }
+
+  void delayUs(uint32_t us) { _bus->delayNs += us * 1000ULL; }
+  void delayMs(uint32_t ms) { _bus->delayNs += ms * 1000000ULL; }
+  uint32_t millis(void) { return (uint32_t)(_bus->busNs() * 1e-6); }
+
+private:
+  Bus *_bus;
+};
+
+#define ADIS16470_TRANSPORT ADIS16470RecordingTransport
@@ -0,0 +1,184 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_RingStress.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Producer/consumer stress test for ADIS16470Ring. A producer thread fills the ring in
+//  bursts through acquire()/commit() and push(), and a consumer thread drains it with a
+//  random mix of pop(), popBatch() and front()/release(), sometimes stalling so the ring
+//  overruns. As in the data ready ISR, an item that does not fit is lost. Every item carries
+//  a sequence number and a payload derived from it. The consumer must see every accepted
+//  item exactly once, in order and untorn. The gaps in the sequence must add up to the
+//  overrun count, and the high-water mark must stay within capacity. Runs a small ring of
+//  large items and a larger ring of words.
+//
+//  Build and run from the repository root (add -fsanitize=thread to check for data races):
+//    g++ -O2 -std=c++11 -pthread -Isrc extras/bench/ADIS16470_RingStress.cpp -o ring_stress
+//    ./ring_stress [items]
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include "ADIS16470_Ring.h"
+
+// Item the size of a decoded 32-bit frame: every word is derived from the sequence number
+struct Big {
+  uint32_t seq;
+  uint32_t words[15];
+};
+
+static void fill(Big &item, uint32_t seq) {
+  item.seq = seq;
+  for (int i = 0; i < 15; i++)
+    item.words[i] = seq * 2654435761u + i;
+}
+
+static bool intact(const Big &item) {
+  for (int i = 0; i < 15; i++)
+    if (item.words[i] != item.seq * 2654435761u + (uint32_t)i)
+      return false;
+  return true;
+}
+
+static void fill(uint32_t &item, uint32_t seq) { item = seq; }
+static bool intact(const uint32_t &) { return true; }
+static uint32_t seqOf(const Big &item) { return item.seq; }
+static uint32_t seqOf(const uint32_t &item) { return item; }
+
+// Short random busy wait so the threads drift against each other
+static void spin(std::mt19937 &rng, unsigned maxLoops) {
+  for (volatile unsigned i = rng() % maxLoops; i > 0; i--) {}
+}
+
+template <typename T, size_t N>
+static bool stress(const char *name, uint32_t items) {
+
+  static ADIS16470Ring<T, N> ring;
+  std::atomic<bool> done(false);
+  std::thread producer([&] {
+    std::mt19937 rng(1);
+    uint32_t seq = 0;
+    while (seq < items)
+    {
+      // Burst of up to 2N items, then a pause
+      for (unsigned n = rng() % (2 * N) + 1; n > 0 && seq < items; n--, seq++)
+      {
+        if (rng() & 1)
+        {
+          T *slot = ring.acquire();
+          if (slot != nullptr)
+          {
+            fill(*slot, seq);
+            ring.commit();
+          }
+        }
+        else
+        {
+          T item;
+          fill(item, seq);
+          ring.push(item);
+        }
+      }
+      spin(rng, 2000);
+      if (rng() & 1)
+        std::this_thread::yield(); // Also lets the consumer in on a single core
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  uint32_t expected = 0; // Lowest sequence number the next item may have
+  uint32_t received = 0;
+  uint32_t lost = 0;
+  uint32_t errors = 0;
+  size_t maxAvailable = 0;
+  std::mt19937 rng(2);
+  T batch[N];
+  for (;;)
+  {
+    bool finished = done.load(std::memory_order_acquire); // Before draining, so nothing is missed
+    size_t avail = ring.available();
+    if (avail > maxAvailable)
+      maxAvailable = avail;
+
+    size_t got = 0;
+    switch (rng() % 3)
+    {
+    case 0:
+      got = ring.pop(batch[0]) ? 1 : 0;
+      break;
+    case 1:
+      got = ring.popBatch(batch, rng() % N + 1);
+      break;
+    default:
+      for (const T *item; got < N && (item = ring.front()) != nullptr; got++)
+      {
+        batch[got] = *item;
+        ring.release();
+      }
+      break;
+    }
+
+    for (size_t i = 0; i < got; i++)
+    {
+      uint32_t seq = seqOf(batch[i]);
+      if (seq < expected || !intact(batch[i]))
+        errors++;
+      else
+        lost += seq - expected;
+      expected = seq + 1;
+      received++;
+    }
+
+    if (got == 0 && finished)
+      break;
+    if (got == 0)
+      std::this_thread::yield(); // Let the producer run on a single core
+    if (rng() % 256 == 0)
+      spin(rng, 200000); // Stall long enough to overrun the ring
+  }
+  producer.join();
+
+  lost += items - expected; // Overruns after the last item received
+  bool ok = errors == 0 && received + lost == items && lost == ring.overruns() && ring.overruns() > 0 &&
+            ring.highWater() <= N && maxAvailable <= N && ring.available() == 0;
+  printf("%s %-20s %9lu received %8lu overruns  high water %lu/%lu  %lu errors\n", ok ? "ok  " : "FAIL", name,
+         (unsigned long)received, (unsigned long)ring.overruns(), (unsigned long)ring.highWater(), (unsigned long)N,
+         (unsigned long)errors);
+  return ok;
+}
+
+int main(int argc, char **argv) {
+
+  uint32_t items = (argc > 1) ? (uint32_t)strtoul(argv[1], nullptr, 0) : 2000000;
+
+  int failures = 0;
+  if (!stress<Big, 4>("4 x 64-byte items", items))
+    failures++;
+  if (!stress<uint32_t, 64>("64 x 32-bit items", items))
+    failures++;
+
+  printf(failures ? "%d FAILED\n" : "all passed\n", failures);
+  return failures ? 1 : 0;
+}
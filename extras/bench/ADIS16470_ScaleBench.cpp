@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_ScaleBench.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Host benchmark comparing the per-sample scaling functions (one int16_t and one double 
+//  literal per call, as in the original ADIS16470::accelScale() etc.) against the batch 
+//  structure-of-arrays kernel in ADIS16470_Scale.cpp, then times the delta angle/velocity 
+//  kernels and checks them against double precision.
+//
+//  Build and run from the repository root:
+//    g++ -O2 -march=native -Isrc extras/bench/ADIS16470_ScaleBench.cpp src/ADIS16470_Scale.cpp -o scale_bench
+//    ./scale_bench
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "ADIS16470_Scale.h"
+
+// Per-sample functions with double literals, kept out of line like the driver members
+__attribute__((noinline)) static float accelScaleDouble(int16_t sensorData) { return sensorData * 0.00125; }
+__attribute__((noinline)) static float gyroScaleDouble(int16_t sensorData) { return sensorData * 0.1; }
+__attribute__((noinline)) static float tempScaleDouble(int16_t sensorData) { return sensorData * 0.1; }
+
+static double nowNs(void) {
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char **argv) {
+
+  size_t count = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 4096;
+  int passes = (argc > 2) ? atoi(argv[2]) : 2000;
+
+  // Random frames, fixed seed
+  std::vector<ADIS16470Frame> frames(count);
+  srand(1);
+  for (size_t i = 0; i < count; i++)
+  {
+    for (int j = 0; j < 3; j++)
+    {
+      frames[i].gyro[j] = (int16_t)rand();
+      frames[i].accl[j] = (int16_t)rand();
+    }
+    frames[i].temp = (int16_t)rand();
+  }
+
+  std::vector<float> soa(7 * count);
+  ADIS16470ScaledData out = { &soa[0], &soa[count], &soa[2 * count], &soa[3 * count],
+                              &soa[4 * count], &soa[5 * count], &soa[6 * count] };
+
+  // Per-sample baseline
+  double start = nowNs();
+  for (int p = 0; p < passes; p++)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      out.gyroX[i] = gyroScaleDouble(frames[i].gyro[0]);
+      out.gyroY[i] = gyroScaleDouble(frames[i].gyro[1]);
+      out.gyroZ[i] = gyroScaleDouble(frames[i].gyro[2]);
+      out.accelX[i] = accelScaleDouble(frames[i].accl[0]);
+      out.accelY[i] = accelScaleDouble(frames[i].accl[1]);
+      out.accelZ[i] = accelScaleDouble(frames[i].accl[2]);
+      out.temp[i] = tempScaleDouble(frames[i].temp);
+    }
+    __asm__ volatile("" : : "r"(soa.data()) : "memory");
+  }
+  double perSample = (nowNs() - start) / ((double)passes * count);
+  std::vector<float> reference(soa);
+
+  // Batch kernel
+  start = nowNs();
+  for (int p = 0; p < passes; p++)
+  {
+    adis16470ScaleFrames(frames.data(), count, out);
+    __asm__ volatile("" : : "r"(soa.data()) : "memory");
+  }
+  double batch = (nowNs() - start) / ((double)passes * count);
+
+  // Largest difference caused by the switch to single precision constants
+  double maxError = 0;
+  for (size_t i = 0; i < soa.size(); i++)
+  {
+    double e = soa[i] - reference[i];
+    if (e < 0) e = -e;
+    if (e > maxError) maxError = e;
+  }
+
+  printf("frames: %zu, passes: %d\n", count, passes);
+  printf("per-sample (double): %8.3f ns/frame\n", perSample);
+  printf("batch SoA (float):   %8.3f ns/frame\n", batch);
+  printf("speedup:             %8.2fx\n", perSample / batch);
+  printf("max abs difference:  %g\n", maxError);
+
+  // Delta frames from the same raw values
+  std::vector<ADIS16470DeltaFrame> deltas(count);
+  std::vector<ADIS16470DeltaFrame32> deltas32(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    for (int j = 0; j < 3; j++)
+    {
+      deltas[i].deltAng[j] = frames[i].gyro[j];
+      deltas[i].deltVel[j] = frames[i].accl[j];
+      deltas32[i].deltAng[j] = frames[i].gyro[j] * 65536 + (rand() & 0xFFFF);
+      deltas32[i].deltVel[j] = frames[i].accl[j] * 65536 + (rand() & 0xFFFF);
+    }
+    deltas[i].temp = deltas32[i].temp = frames[i].temp;
+  }
+
+  start = nowNs();
+  for (int p = 0; p < passes; p++)
+  {
+    adis16470ScaleDeltaFrames(deltas.data(), count, out);
+    __asm__ volatile("" : : "r"(soa.data()) : "memory");
+  }
+  double delta = (nowNs() - start) / ((double)passes * count);
+  double deltaError = 0; // Relative to double precision
+  for (size_t i = 0; i < count; i++)
+  {
+    for (int j = 0; j < 3; j++)
+    {
+      double ang = deltas[i].deltAng[j] * (double)DELTANG_SCALE;
+      double vel = deltas[i].deltVel[j] * (double)DELTVEL_SCALE;
+      deltaError = std::max(deltaError, fabs(soa[j * count + i] - ang) / (fabs(ang) + 1e-30));
+      deltaError = std::max(deltaError, fabs(soa[(3 + j) * count + i] - vel) / (fabs(vel) + 1e-30));
+    }
+  }
+
+  start = nowNs();
+  for (int p = 0; p < passes; p++)
+  {
+    adis16470ScaleDeltaFrames32(deltas32.data(), count, out);
+    __asm__ volatile("" : : "r"(soa.data()) : "memory");
+  }
+  double delta32 = (nowNs() - start) / ((double)passes * count);
+  double deltaError32 = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    for (int j = 0; j < 3; j++)
+    {
+      double ang = deltas32[i].deltAng[j] * (double)DELTANG_SCALE / 65536.0;
+      double vel = deltas32[i].deltVel[j] * (double)DELTVEL_SCALE / 65536.0;
+      deltaError32 = std::max(deltaError32, fabs(soa[j * count + i] - ang) / (fabs(ang) + 1e-30));
+      deltaError32 = std::max(deltaError32, fabs(soa[(3 + j) * count + i] - vel) / (fabs(vel) + 1e-30));
+    }
+  }
+
+  printf("delta 16-bit (float): %7.3f ns/frame, max rel error %g\n", delta, deltaError);
+  printf("delta 32-bit (float): %7.3f ns/frame, max rel error %g\n", delta32, deltaError32);
+
+  // Single precision rounding only
+  if (deltaError > 1e-6 || deltaError32 > 1e-6)
+  {
+    printf("FAIL: delta kernels differ from double precision\n");
+    return 1;
+  }
+
+  return 0;
+}
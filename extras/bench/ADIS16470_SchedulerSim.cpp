@@ -0,0 +1,299 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_SchedulerSim.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Host simulation of ADIS16470Scheduler with several devices at different phases, ODRs
+//  and clock errors on two buses, one of them serviced asynchronously. Time is simulated in
+//  nanoseconds and the scheduler sees a 32-bit microsecond clock that wraps during the run.
+//  Data ready ISRs preempt loop() wherever it reads the clock or unmasks interrupts, and
+//  during transfers, so edges also land between claiming a sample and reading it. Each
+//  transfer reads the sensor's newest sample, and the scheduler's serviced and dropped
+//  counts must match which samples were actually read. No sample may be read twice. The
+//  measured latency must match the true edge-to-done time.
+//
+//  Build and run from the repository root:
+//    g++ -O2 -DADIS16470_IRQ_HEADER='"ADIS16470_SimIrq.h"' -Isrc -Iextras/bench
+//        extras/bench/ADIS16470_SchedulerSim.cpp src/ADIS16470_Scheduler.cpp -o scheduler_sim
+//    ./scheduler_sim
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "ADIS16470_Scheduler.h"
+
+#if !defined(ADIS16470_IRQ_HEADER)
+#error Build with -DADIS16470_IRQ_HEADER='"ADIS16470_SimIrq.h"'
+#endif
+
+#define CLOCK_START_US 0xFFF00000UL // The scheduler clock wraps about 1 s into each run
+
+struct DeviceConfig {
+  uint8_t bus;
+  double odr;         // Nominal output data rate, SPS
+  double ppm;         // Sensor clock error
+  double phaseUs;     // Time of the first edge
+  double transferUs;  // Bus time of one read
+  bool async;         // Completes from a simulated DMA interrupt
+};
+
+struct Case {
+  const char *name;
+  std::vector<DeviceConfig> devices;
+  double loopCostNs;  // loop() time per scheduler clock read
+  double seconds;
+  bool expectDrops;
+};
+
+struct SimDevice {
+  DeviceConfig cfg;
+  int id;
+  double nextEdgeNs;
+  double periodNs;
+  uint64_t edges = 0;
+  uint32_t latestTick = 0;  // ISR time of the newest sample
+  int64_t lastRead = -1;    // Newest sample read so far
+  uint32_t readTick = 0;    // ISR time of the sample being read
+  double doneNs = -1;       // End of an asynchronous transfer in flight
+  uint64_t reads = 0;
+  uint64_t duplicates = 0;
+  double latencySumUs = 0;  // True edge-to-done time of every read
+};
+
+// Simulation state
+static double simNs;
+static double stopNs; // Sensors stop here
+static bool masked, inIsr;
+static double loopCostNs;
+static std::vector<SimDevice> devices;
+static ADIS16470Scheduler *scheduler;
+
+static uint32_t tickAt(double ns) { return (uint32_t)(CLOCK_START_US + (uint64_t)(ns / 1000)); }
+
+static void deliver(void);
+
+// Scheduler clock. Reading it from loop() takes time, during which interrupts may fire
+static uint32_t simClock(void) {
+  if (!inIsr)
+  {
+    simNs += loopCostNs;
+    deliver();
+  }
+  return tickAt(simNs);
+}
+
+uint32_t adis16470IrqSave(void) {
+  bool was = masked;
+  masked = true;
+  return was;
+}
+
+void adis16470IrqRestore(uint32_t state) {
+  masked = state;
+  deliver();
+}
+
+// Runs the ISRs of every edge and DMA completion due by now, oldest first
+static void deliver(void) {
+  if (masked || inIsr)
+    return;
+  for (;;)
+  {
+    SimDevice *next = nullptr;
+    bool edge = false;
+    double at = simNs;
+    for (SimDevice &d : devices)
+    {
+      if (d.nextEdgeNs < stopNs && (next ? d.nextEdgeNs < at : d.nextEdgeNs <= at)) // Ties in device order
+      {
+        next = &d;
+        edge = true;
+        at = d.nextEdgeNs;
+      }
+      if (d.doneNs >= 0 && (next ? d.doneNs < at : d.doneNs <= at))
+      {
+        next = &d;
+        edge = false;
+        at = d.doneNs;
+      }
+    }
+    if (next == nullptr)
+      return;
+
+    inIsr = true;
+    if (edge)
+    {
+      next->edges++;
+      next->latestTick = tickAt(simNs);
+      next->nextEdgeNs += next->periodNs;
+      scheduler->dataReady(next->id);
+    }
+    else
+    {
+      next->latencySumUs += (uint32_t)(tickAt(simNs) - next->readTick);
+      next->doneNs = -1;
+      scheduler->complete(next->cfg.bus);
+    }
+    inIsr = false;
+  }
+}
+
+// Moves time forward by ns, running ISRs as they come due
+static void advance(double ns) {
+  double end = simNs + ns;
+  while (simNs < end)
+  {
+    double step = end;
+    for (SimDevice &d : devices)
+    {
+      if (d.nextEdgeNs < stopNs && d.nextEdgeNs > simNs && d.nextEdgeNs < step)
+        step = d.nextEdgeNs;
+      if (d.doneNs > simNs && d.doneNs < step)
+        step = d.doneNs;
+    }
+    simNs = step;
+    deliver();
+  }
+}
+
+// Service function: the transfer reads the newest sample when it starts
+static bool service(void *context) {
+  SimDevice &d = *(SimDevice *)context;
+  int64_t sample = (int64_t)d.edges - 1;
+  if (sample == d.lastRead)
+    d.duplicates++;
+  else
+    d.reads++;
+  d.lastRead = sample;
+  d.readTick = d.latestTick;
+
+  if (d.cfg.async)
+  {
+    d.doneNs = simNs + d.cfg.transferUs * 1000;
+    return false;
+  }
+  advance(d.cfg.transferUs * 1000);
+  d.latencySumUs += (uint32_t)(tickAt(simNs) - d.readTick);
+  return true;
+}
+
+static bool busy(void) {
+  for (const SimDevice &d : devices)
+    if (d.doneNs >= 0)
+      return true;
+  return scheduler->pending() > 0;
+}
+
+static bool run(const Case &c) {
+
+  ADIS16470Scheduler sched(simClock);
+  scheduler = &sched;
+  simNs = 0;
+  stopNs = c.seconds * 1e9;
+  masked = inIsr = false;
+  loopCostNs = c.loopCostNs;
+
+  devices.clear();
+  for (const DeviceConfig &cfg : c.devices)
+  {
+    SimDevice d;
+    d.cfg = cfg;
+    d.periodNs = 1e9 / cfg.odr * (1 - cfg.ppm * 1e-6);
+    d.nextEdgeNs = cfg.phaseUs * 1000;
+    devices.push_back(d);
+  }
+  for (SimDevice &d : devices)
+    d.id = sched.addDevice(d.cfg.bus, service, &d);
+
+  // Run, then stop the sensors and let the queues drain
+  while (simNs < stopNs || busy())
+  {
+    sched.poll();
+    advance(1000);
+  }
+
+  printf("%s\n", c.name);
+  printf("  dev bus    odr    ppm  edges serviced dropped dup  lat_mean_us true_us  lat_max_us\n");
+  bool ok = true;
+  for (const SimDevice &d : devices)
+  {
+    const ADIS16470DeviceStats &s = sched.stats(d.id);
+    double mean = s.serviced ? (double)s.latencySum / s.serviced : 0;
+    double trueMean = d.reads ? d.latencySumUs / d.reads : 0;
+    bool good = d.duplicates == 0 && s.serviced == d.reads && s.serviced + s.dropped == d.edges &&
+                fabs(mean - trueMean) <= 2.0 + c.loopCostNs * 1e-3 && (c.expectDrops || s.dropped == 0);
+    printf("  %3d %3u %6.0f %6.1f %6llu %8lu %7lu %3llu %12.2f %7.2f %11lu %s\n", d.id, d.cfg.bus, d.cfg.odr,
+           d.cfg.ppm, (unsigned long long)d.edges, (unsigned long)s.serviced, (unsigned long)s.dropped,
+           (unsigned long long)d.duplicates, mean, trueMean, (unsigned long)s.latencyMax, good ? "" : "FAIL");
+    ok &= good;
+  }
+  if (c.expectDrops)
+  {
+    uint64_t dropped = 0;
+    for (const SimDevice &d : devices)
+      dropped += sched.stats(d.id).dropped;
+    ok &= dropped > 0;
+  }
+  return ok;
+}
+
+int main(void) {
+
+  // Three devices at different rates and drifts on a synchronous bus, two on a DMA bus
+  std::vector<DeviceConfig> mixed = {
+    { 0, 2000,  20.0,   0, 120, false },
+    { 0, 2000, -35.0,  37, 120, false },
+    { 0, 1000,   5.0, 300, 120, false },
+    { 1, 2000, -10.0, 250, 200, true },
+    { 1,  800,  40.0,  11, 200, true },
+  };
+
+  // Two identical sensors in phase: the second always waits one transaction
+  std::vector<DeviceConfig> coincident = {
+    { 0, 2000, 0, 100, 150, false },
+    { 0, 2000, 0, 100, 150, false },
+  };
+
+  // 120 % bus load
+  std::vector<DeviceConfig> overload = {
+    { 0, 2000,  10.0,   0, 150, false },
+    { 0, 2000, -10.0, 125, 150, false },
+    { 0, 2000,  30.0, 250, 150, false },
+    { 0, 2000, -30.0, 375, 150, false },
+  };
+
+  Case cases[] = {
+    { "mixed rates, 2 buses",                mixed,      300,   10, false },
+    { "mixed rates, slow loop (25 us/read)", mixed,      25000, 10, true },
+    { "coincident edges",                    coincident, 300,   5,  false },
+    { "overloaded bus",                      overload,   300,   5,  true },
+  };
+
+  int failures = 0;
+  for (const Case &c : cases)
+    if (!run(c))
+      failures++;
+
+  printf(failures ? "%d FAILED\n" : "all passed\n", failures);
+  return failures ? 1 : 0;
+}
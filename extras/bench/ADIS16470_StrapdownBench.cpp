@@ -0,0 +1,288 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_StrapdownBench.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Host accuracy check and benchmark for ADIS16470_Strapdown. Delta angles and delta 
+//  velocities are generated in double precision from analytic motion: constant rotation,
+//  coning (yaw ramp with a rolling oscillation) and sculling (rolling oscillation with 
+//  in-phase acceleration, plus gravity). The integrator's final attitude and velocity are 
+//  then compared with the analytic truth. The same samples also go through a typical
+//  per-sample float loop (sin/cos quaternion update and sqrt normalization, no coning or 
+//  sculling terms) for comparison, and both are timed.
+//
+//  Build and run from the repository root:
+//    g++ -O2 -Isrc extras/bench/ADIS16470_StrapdownBench.cpp src/ADIS16470_Strapdown.cpp -o strapdown_bench
+//    ./strapdown_bench
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "ADIS16470_Strapdown.h"
+#include "ADIS16470_Scale.h"
+
+#define ODR      2000.0
+#define SUBSTEPS 32
+
+struct Quat { double w, x, y, z; };
+
+static Quat mul(const Quat &a, const Quat &b) {
+  return { a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+           a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+           a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+           a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w };
+}
+
+// Rotates v from body to navigation frame
+static void rotate(const Quat &q, const double *v, double *out) {
+  Quat p = mul(mul(q, { 0, v[0], v[1], v[2] }), { q.w, -q.x, -q.y, -q.z });
+  out[0] = p.x; out[1] = p.y; out[2] = p.z;
+}
+
+// Analytic motion: attitude q = qz(yawRate t) * qx(roll(t)) * qc(t), where qc is classical 
+// coning (rotation by coneAngle about an axis spinning in the body x-y plane), plus a 
+// navigation-frame y acceleration in phase with the roll
+struct Profile {
+  const char *name;
+  double yawRate;     // rad/sec about navigation z
+  double rollAmp;     // rad, rolling oscillation about body x
+  double coneAngle;   // rad
+  double freq;        // Hz, roll, coning and acceleration frequency
+  double accelAmp;    // m/sec^2
+  bool gravity;
+
+  double omega(void) const { return 2 * M_PI * freq; }
+
+  // Factors of the attitude and their time derivatives
+  void factors(double t, Quat *q, Quat *dq) const {
+    double y = 0.5 * yawRate * t;
+    double r = 0.5 * rollAmp * sin(omega() * t), dr = 0.5 * rollAmp * omega() * cos(omega() * t);
+    double c = 0.5 * coneAngle, ph = omega() * t;
+    q[0] = { cos(y), 0, 0, sin(y) };
+    dq[0] = { -0.5 * yawRate * sin(y), 0, 0, 0.5 * yawRate * cos(y) };
+    q[1] = { cos(r), sin(r), 0, 0 };
+    dq[1] = { -dr * sin(r), dr * cos(r), 0, 0 };
+    q[2] = { cos(c), sin(c) * cos(ph), sin(c) * sin(ph), 0 };
+    dq[2] = { 0, -sin(c) * omega() * sin(ph), sin(c) * omega() * cos(ph), 0 };
+  }
+
+  Quat attitude(double t) const {
+    Quat q[3], dq[3];
+    factors(t, q, dq);
+    return mul(mul(q[0], q[1]), q[2]);
+  }
+
+  // Body rate: vector part of 2 q* dq/dt
+  void rate(double t, double *w) const {
+    Quat q[3], dq[3];
+    factors(t, q, dq);
+    Quat qt = mul(mul(q[0], q[1]), q[2]);
+    Quat a = mul(mul(dq[0], q[1]), q[2]), b = mul(mul(q[0], dq[1]), q[2]), c = mul(mul(q[0], q[1]), dq[2]);
+    Quat d = { a.w + b.w + c.w, a.x + b.x + c.x, a.y + b.y + c.y, a.z + b.z + c.z };
+    Quat o = mul({ qt.w, -qt.x, -qt.y, -qt.z }, d);
+    w[0] = 2 * o.x;
+    w[1] = 2 * o.y;
+    w[2] = 2 * o.z;
+  }
+
+  void accel(double t, double *a) const {
+    a[0] = 0;
+    a[1] = accelAmp * sin(omega() * t);
+    a[2] = 0;
+  }
+
+  void velocity(double t, double *v) const {
+    v[0] = 0;
+    v[1] = (freq > 0) ? accelAmp * (1 - cos(omega() * t)) / omega() : 0;
+    v[2] = 0;
+  }
+
+  // Body specific force
+  void force(double t, double *f) const {
+    double a[3], fn[3];
+    accel(t, a);
+    for (int i = 0; i < 3; i++)
+      fn[i] = a[i] - ((gravity && i == 2) ? (double)STRAPDOWN_GRAVITY : 0.0);
+    Quat q = attitude(t);
+    rotate({ q.w, -q.x, -q.y, -q.z }, fn, f);
+  }
+};
+
+// Integrates body rate and specific force over one sample (Simpson's rule)
+static void sample(const Profile &p, double t0, double dt, float *da, float *dv) {
+  double h = dt / SUBSTEPS, sa[3] = { 0, 0, 0 }, sv[3] = { 0, 0, 0 };
+  for (int k = 0; k <= SUBSTEPS; k++)
+  {
+    double w[3], f[3], wt = (k == 0 || k == SUBSTEPS) ? 1 : (k & 1) ? 4 : 2;
+    p.rate(t0 + k * h, w);
+    p.force(t0 + k * h, f);
+    for (int i = 0; i < 3; i++)
+    {
+      sa[i] += wt * w[i];
+      sv[i] += wt * f[i];
+    }
+  }
+  for (int i = 0; i < 3; i++)
+  {
+    da[i] = (float)(sa[i] * h / 3);
+    dv[i] = (float)(sv[i] * h / 3);
+  }
+}
+
+// Typical per-sample loop: exact rotation of the raw delta angle, no coning or sculling terms
+struct Naive {
+  float q[4] = { 1, 0, 0, 0 }, v[3] = { 0, 0, 0 }, gdt[3];
+  void update(const float *a, const float *dv) {
+    float n = sqrtf(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+    float c = cosf(0.5f * n), s = (n > 0) ? sinf(0.5f * n) / n : 0.5f;
+    float d[4] = { c, s * a[0], s * a[1], s * a[2] };
+    // Velocity with the attitude at the start of the sample
+    float w = q[0], x = q[1], y = q[2], z = q[3];
+    float r[3][3] = { { 1 - 2 * (y * y + z * z), 2 * (x * y - w * z), 2 * (x * z + w * y) },
+                      { 2 * (x * y + w * z), 1 - 2 * (x * x + z * z), 2 * (y * z - w * x) },
+                      { 2 * (x * z - w * y), 2 * (y * z + w * x), 1 - 2 * (x * x + y * y) } };
+    for (int i = 0; i < 3; i++)
+      v[i] += r[i][0] * dv[0] + r[i][1] * dv[1] + r[i][2] * dv[2] + gdt[i];
+    float o[4] = { w * d[0] - x * d[1] - y * d[2] - z * d[3], w * d[1] + x * d[0] + y * d[3] - z * d[2],
+                   w * d[2] - x * d[3] + y * d[0] + z * d[1], w * d[3] + x * d[2] - y * d[1] + z * d[0] };
+    float m = 1.0f / sqrtf(o[0] * o[0] + o[1] * o[1] + o[2] * o[2] + o[3] * o[3]);
+    for (int i = 0; i < 4; i++)
+      q[i] = o[i] * m;
+  }
+};
+
+// Angle between two attitudes, degrees
+static double angleError(const float *q, const Quat &t) {
+  double d = fabs(q[0] * t.w + q[1] * t.x + q[2] * t.y + q[3] * t.z);
+  double n = sqrt((double)q[0] * q[0] + (double)q[1] * q[1] + (double)q[2] * q[2] + (double)q[3] * q[3]);
+  return 2 * acos(fmin(1.0, d / n)) * 180 / M_PI;
+}
+
+static double velocityError(const float *v, const double *t) {
+  double e = 0;
+  for (int i = 0; i < 3; i++)
+    e += (v[i] - t[i]) * (v[i] - t[i]);
+  return sqrt(e);
+}
+
+int main(void) {
+
+  const double seconds = 10;
+  const double dt = 1 / ODR;
+  const size_t n = (size_t)(seconds * ODR);
+
+  // name, yaw rate, roll amplitude, cone angle, frequency, y accel, gravity; limits: attitude deg, velocity m/sec
+  struct { Profile p; double attLimit, velLimit; } cases[] = {
+    { { "constant rate 300 deg/s",  300 * M_PI / 180, 0, 0, 0, 0, false }, 0.005, 1e-4 },
+    { { "coning 2 deg 20 Hz",       0, 0, 2 * M_PI / 180, 20, 0, false },  0.005, 1e-4 },
+    { { "coning 1 deg 100 Hz",      0, 0, 1 * M_PI / 180, 100, 0, false }, 0.05, 1e-4 },
+    { { "sculling 20 Hz + gravity", 0, 0.03, 0, 20, 5, true },             0.005, 1e-3 },
+    { { "yaw+roll+coning+sculling", 1.0, 0.02, 1 * M_PI / 180, 40, 3, true }, 0.005, 1e-3 },
+  };
+
+  int failures = 0;
+  printf("%-26s %12s %12s %12s %12s\n", "profile (10 s @ 2 kSPS)", "att err deg", "naive deg", "vel err m/s", "naive m/s");
+  for (auto &tc : cases)
+  {
+    const Profile &p = tc.p;
+    ADIS16470Strapdown sd;
+    Naive naive;
+    sd.setSamplePeriod((float)dt);
+    sd.setGravity(0, 0, p.gravity ? STRAPDOWN_GRAVITY : 0.0f);
+    Quat q0 = p.attitude(0);
+    sd.setAttitude((float)q0.w, (float)q0.x, (float)q0.y, (float)q0.z);
+    naive.q[0] = (float)q0.w;
+    naive.q[1] = (float)q0.x;
+    naive.q[2] = (float)q0.y;
+    naive.q[3] = (float)q0.z;
+    for (int i = 0; i < 3; i++)
+      naive.gdt[i] = (p.gravity && i == 2) ? STRAPDOWN_GRAVITY * (float)dt : 0.0f;
+
+    for (size_t k = 0; k < n; k++)
+    {
+      float da[3], dv[3];
+      sample(p, k * dt, dt, da, dv);
+      sd.update(da, dv);
+      naive.update(da, dv);
+    }
+
+    Quat qt = p.attitude(seconds);
+    double vt[3];
+    p.velocity(seconds, vt);
+    double ea = angleError(sd.attitude(), qt), na = angleError(naive.q, qt);
+    double ev = velocityError(sd.velocity(), vt), nv = velocityError(naive.v, vt);
+    bool ok = ea < tc.attLimit && ev < tc.velLimit;
+    printf("%-26s %12.2e %12.2e %12.2e %12.2e %s\n", p.name, ea, na, ev, nv, ok ? "ok" : "FAIL");
+    if (!ok)
+      failures++;
+  }
+
+  // 32-bit frame path: constant rate of 1000 LSB32 per sample about x
+  {
+    ADIS16470Strapdown sd;
+    sd.setGravity(0, 0, 0);
+    ADIS16470DeltaFrame32 f = ADIS16470DeltaFrame32();
+    f.deltAng[0] = 1000;
+    for (size_t k = 0; k < n; k++)
+      sd.update(f);
+    double angle = (double)n * 1000 * DELTANG_SCALE / 65536 * M_PI / 180;
+    Quat qt = { cos(angle / 2), sin(angle / 2), 0, 0 };
+    double ea = angleError(sd.attitude(), qt);
+    printf("%-26s %12.2e %s\n", "32-bit frame scaling", ea, ea < 0.005 ? "ok" : "FAIL");
+    if (ea >= 0.005)
+      failures++;
+  }
+
+  // Timing over pre-generated samples
+  {
+    Profile p = { "timing", 1.0, 0.02, 1 * M_PI / 180, 40, 3, true };
+    const size_t m = 1 << 16;
+    std::vector<float> da(3 * m), dv(3 * m);
+    for (size_t k = 0; k < m; k++)
+      sample(p, k * dt, dt, &da[3 * k], &dv[3 * k]);
+    const int passes = 50;
+
+    ADIS16470Strapdown sd;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < passes; r++)
+      for (size_t k = 0; k < m; k++)
+        sd.update(&da[3 * k], &dv[3 * k]);
+    double libNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+
+    Naive naive = Naive();
+    naive.gdt[0] = naive.gdt[1] = 0;
+    naive.gdt[2] = STRAPDOWN_GRAVITY * (float)dt;
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < passes; r++)
+      for (size_t k = 0; k < m; k++)
+        naive.update(&da[3 * k], &dv[3 * k]);
+    double naiveNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+
+    printf("update: %.1f ns/sample, per-sample float loop: %.1f ns/sample (%g %g)\n",
+           libNs / (passes * m), naiveNs / (passes * m), sd.attitude()[0], naive.q[0]);
+  }
+
+  printf(failures ? "%d FAILED\n" : "all passed\n", failures);
+  return failures ? 1 : 0;
+}
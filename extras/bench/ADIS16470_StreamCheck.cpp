@@ -0,0 +1,297 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_StreamCheck.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Host round-trip check for ADIS16470_Stream. Every sample type (16/32-bit, inertial and
+//  delta) is encoded raw and packed, then decoded from pieces of random length down to
+//  single bytes, and each sample must come back unchanged with its sequence number. The
+//  inputs include full-scale jumps (so packed differences wrap at the field width) and
+//  a run long enough to wrap the 16-bit sequence counter. Corrupted streams (bit flips
+//  and garbage between packets) must lose exactly the damaged packets and deliver
+//  nothing else, and packets with a valid CRC but a payload that does not match the
+//  header must deliver no samples at all.
+//
+//  Build and run from the repository root:
+//    g++ -O2 -Isrc extras/bench/ADIS16470_StreamCheck.cpp src/ADIS16470_Stream.cpp -o stream_check
+//    ./stream_check
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "ADIS16470_Stream.h"
+
+// Rotation and linear fields of each frame type
+static int16_t *rot(ADIS16470Frame &f) { return f.gyro; }
+static int16_t *lin(ADIS16470Frame &f) { return f.accl; }
+static int16_t *rot(ADIS16470DeltaFrame &f) { return f.deltAng; }
+static int16_t *lin(ADIS16470DeltaFrame &f) { return f.deltVel; }
+static int32_t *rot(ADIS16470Frame32 &f) { return f.gyro; }
+static int32_t *lin(ADIS16470Frame32 &f) { return f.accl; }
+static int32_t *rot(ADIS16470DeltaFrame32 &f) { return f.deltAng; }
+static int32_t *lin(ADIS16470DeltaFrame32 &f) { return f.deltVel; }
+
+template <typename Frame>
+static bool same(Frame a, Frame b) {
+  for (int i = 0; i < 3; i++)
+    if (rot(a)[i] != rot(b)[i] || lin(a)[i] != lin(b)[i])
+      return false;
+  return a.diagStat == b.diagStat && a.temp == b.temp && a.timeStamp == b.timeStamp && a.checksum == b.checksum;
+}
+
+// Random walk with occasional full-scale jumps
+template <typename Frame>
+static std::vector<Frame> makeFrames(size_t n, unsigned seed) {
+  typedef typename std::remove_reference<decltype(rot(*(Frame *)0)[0])>::type Value;
+  const int64_t lo = (sizeof(Value) == 2) ? INT16_MIN : INT32_MIN;
+  const int64_t hi = (sizeof(Value) == 2) ? INT16_MAX : INT32_MAX;
+  srand(seed);
+  std::vector<Frame> frames(n);
+  Frame f = {};
+  for (size_t s = 0; s < n; s++)
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      if (rand() % 200 == 0)
+      {
+        rot(f)[i] = (Value)((rand() & 1) ? hi : lo);
+        lin(f)[i] = (Value)((rand() & 1) ? lo : hi);
+      }
+      else
+      {
+        rot(f)[i] = (Value)(rot(f)[i] + (rand() % 201 - 100));
+        lin(f)[i] = (Value)(lin(f)[i] + (rand() % 20001 - 10000));
+      }
+    }
+    f.diagStat = (rand() % 100 == 0) ? (uint16_t)(1 << (rand() % 10)) : 0;
+    f.temp = (int16_t)(1000 + rand() % 3);
+    f.timeStamp = (uint16_t)(f.timeStamp + 1);
+    f.checksum = (uint16_t)rand();
+    frames[s] = f;
+  }
+  return frames;
+}
+
+// Encodes frames into a byte stream. starts receives the offset of every packet
+template <typename Frame>
+static std::vector<uint8_t> encode(const std::vector<Frame> &frames, uint8_t type, bool packed,
+                                   std::vector<size_t> *starts = nullptr) {
+  ADIS16470StreamEncoder enc;
+  enc.begin(type, packed);
+  std::vector<uint8_t> out;
+  for (size_t s = 0; s < frames.size(); s++)
+  {
+    if (!enc.add(frames[s]) && s + 1 < frames.size())
+      continue;
+    size_t len = enc.finish();
+    if (starts)
+      starts->push_back(out.size());
+    out.insert(out.end(), enc.data(), enc.data() + len);
+  }
+  return out;
+}
+
+// Samples delivered by the decoder
+template <typename Frame>
+struct Sink {
+  uint8_t type;
+  std::vector<Frame> frames;
+  std::vector<uint16_t> sequences;
+  bool wrongType = false;
+
+  static void handler(void *context, uint8_t type, uint16_t sequence, const uint32_t *fields) {
+    Sink *sink = (Sink *)context;
+    Frame f;
+    adis16470FieldsToFrame(fields, &f);
+    sink->wrongType |= (type != sink->type);
+    sink->frames.push_back(f);
+    sink->sequences.push_back(sequence);
+  }
+};
+
+// Feeds data in random pieces of 1 to maxPiece bytes
+static void feedPieces(ADIS16470StreamDecoder &dec, const std::vector<uint8_t> &data, size_t maxPiece, unsigned seed) {
+  srand(seed);
+  size_t pos = 0;
+  while (pos < data.size())
+  {
+    size_t n = 1 + rand() % maxPiece;
+    if (n > data.size() - pos)
+      n = data.size() - pos;
+    dec.feed(&data[pos], n);
+    pos += n;
+  }
+}
+
+static int failures = 0;
+
+static void report(bool ok, const char *what, const char *name, bool packed) {
+  printf("%s %-22s %-12s %s\n", ok ? "ok  " : "FAIL", what, name, packed ? "packed" : "raw");
+  if (!ok)
+    failures++;
+}
+
+// Clean round trip from pieces of several sizes
+template <typename Frame>
+static void roundTrip(const char *name, uint8_t type, bool packed, size_t n) {
+  std::vector<Frame> frames = makeFrames<Frame>(n, 7 + type);
+  std::vector<uint8_t> data = encode(frames, type, packed);
+
+  static const size_t pieces[] = { 1, 3, 64, 4096 };
+  bool ok = true;
+  for (size_t p : pieces)
+  {
+    Sink<Frame> sink;
+    sink.type = type;
+    ADIS16470StreamDecoder dec(Sink<Frame>::handler, &sink);
+    feedPieces(dec, data, p, (unsigned)p);
+    const ADIS16470StreamStats &st = dec.stats();
+    ok &= !sink.wrongType && sink.frames.size() == n && st.samples == n && st.crcErrors == 0 &&
+          st.formatErrors == 0 && st.bytesSkipped == 0 && st.samplesLost == 0;
+    for (size_t s = 0; ok && s < n; s++)
+      ok &= same(sink.frames[s], frames[s]) && sink.sequences[s] == (uint16_t)s;
+  }
+  char what[32];
+  snprintf(what, sizeof(what), "round trip x%zu", n);
+  report(ok, what, name, packed);
+}
+
+// Bit flips inside packets and garbage between them
+template <typename Frame>
+static void corrupted(const char *name, uint8_t type, bool packed) {
+  const size_t n = 4000;
+  std::vector<Frame> frames = makeFrames<Frame>(n, 11 + type);
+  std::vector<size_t> starts;
+  std::vector<uint8_t> clean = encode(frames, type, packed, &starts);
+  starts.push_back(clean.size());
+
+  // Damage every fifth packet (never the first or last) and add garbage after every seventh
+  srand(3 + type);
+  std::vector<uint8_t> data;
+  std::vector<bool> lost(n, false);
+  size_t lostSamples = 0;
+  for (size_t k = 0; k + 1 < starts.size(); k++)
+  {
+    std::vector<uint8_t> packet(clean.begin() + starts[k], clean.begin() + starts[k + 1]);
+    if (k % 5 == 3 && k + 2 < starts.size())
+    {
+      packet[rand() % packet.size()] ^= (uint8_t)(1 << (rand() % 8));
+      uint8_t count = clean[starts[k] + 6];
+      for (size_t s = 0; s < count; s++)
+        lost[k * ADIS16470_STREAM_SAMPLES + s] = true;
+      lostSamples += count;
+    }
+    data.insert(data.end(), packet.begin(), packet.end());
+    if (k % 7 == 1)
+      for (int g = rand() % 40; g >= 0; g--)
+        data.push_back((g % 9 == 0) ? STREAM_SYNC0 : (uint8_t)rand());
+  }
+  data.insert(data.end(), STREAM_MAX_PACKET, 0); // Flushes a false header in the last garbage
+
+  Sink<Frame> sink;
+  sink.type = type;
+  ADIS16470StreamDecoder dec(Sink<Frame>::handler, &sink);
+  feedPieces(dec, data, 50, 5);
+  const ADIS16470StreamStats &st = dec.stats();
+
+  bool ok = !sink.wrongType && sink.frames.size() == n - lostSamples && st.samples == n - lostSamples &&
+            st.samplesLost == lostSamples && st.crcErrors + st.formatErrors > 0 && st.bytesSkipped > 0;
+  for (size_t s = 0; ok && s < sink.frames.size(); s++)
+  {
+    size_t at = sink.sequences[s];
+    ok &= at < n && !lost[at] && same(sink.frames[s], frames[at]);
+  }
+  report(ok, "corrupted", name, packed);
+}
+
+// Re-signs a packet after its header or payload was edited
+static void resign(std::vector<uint8_t> &packet) {
+  size_t len = packet.size();
+  uint16_t crc = adis16470Crc16(&packet[2], len - 4);
+  packet[len - 2] = crc & 0xFF;
+  packet[len - 1] = crc >> 8;
+}
+
+// Packets with a valid CRC whose payload does not match the header
+static void malformed(bool packed) {
+  std::vector<ADIS16470Frame32> frames = makeFrames<ADIS16470Frame32>(ADIS16470_STREAM_SAMPLES, 17);
+  std::vector<uint8_t> packet = encode(frames, STREAM_INERTIAL32, packed);
+
+  // Header claims one sample fewer, leaving bytes after the last sample
+  std::vector<uint8_t> extra = packet;
+  extra[6]--;
+  resign(extra);
+
+  // Payload cut short inside the last sample
+  std::vector<uint8_t> shortened = packet;
+  shortened.erase(shortened.end() - 4, shortened.end() - 2);
+  size_t payload = shortened.size() - STREAM_HEADER_BYTES - STREAM_CRC_BYTES;
+  shortened[7] = payload & 0xFF;
+  shortened[8] = payload >> 8;
+  resign(shortened);
+
+  bool ok = true;
+  for (const std::vector<uint8_t> *bad : { &extra, &shortened })
+  {
+    Sink<ADIS16470Frame32> sink;
+    sink.type = STREAM_INERTIAL32;
+    ADIS16470StreamDecoder dec(Sink<ADIS16470Frame32>::handler, &sink);
+    dec.feed(bad->data(), bad->size());
+    ok &= sink.frames.empty() && dec.stats().samples == 0 && dec.stats().packets == 0 &&
+          dec.stats().formatErrors == 1;
+
+    // The decoder carries on with the next good packet
+    dec.feed(packet.data(), packet.size());
+    ok &= sink.frames.size() == ADIS16470_STREAM_SAMPLES && same(sink.frames.back(), frames.back());
+  }
+  report(ok, "malformed payload", "Frame32", packed);
+}
+
+template <typename Frame>
+static void runType(const char *name, uint8_t type) {
+  for (int packed = 0; packed < 2; packed++)
+  {
+    roundTrip<Frame>(name, type, packed, 1);
+    roundTrip<Frame>(name, type, packed, 1000 + 7); // Ends in a partial packet
+    corrupted<Frame>(name, type, packed);
+  }
+}
+
+int main(void) {
+
+  runType<ADIS16470Frame>("Frame", STREAM_INERTIAL16);
+  runType<ADIS16470DeltaFrame>("DeltaFrame", STREAM_DELTA16);
+  runType<ADIS16470Frame32>("Frame32", STREAM_INERTIAL32);
+  runType<ADIS16470DeltaFrame32>("DeltaFrame32", STREAM_DELTA32);
+
+  // Sequence counter wrap
+  roundTrip<ADIS16470Frame32>("Frame32", STREAM_INERTIAL32, true, 70000);
+
+  malformed(false);
+  malformed(true);
+
+  printf(failures ? "%d FAILED\n" : "all passed\n", failures);
+  return failures ? 1 : 0;
+}
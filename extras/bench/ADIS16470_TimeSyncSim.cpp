@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_TimeSyncSim.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Host simulation of ADIS16470TimeSync. A sensor sample clock with a fixed drift plus a
+//  slow thermal wander drives data ready edges. They are captured by an MCU clock with 
+//  interrupt latency jitter, occasional long latency spikes, dropped samples, 16-bit 
+//  TIME_STAMP wraps and one multi-second stall. Each configuration reports the raw
+//  capture error and the tracked timestamp error against the true edge times, the 
+//  tracked drift, and checks that TIME_STAMP was extended to 64 bits exactly. hostTime() is
+//  checked against the true edge one second ahead, against its own estimate one second 
+//  back, and against double math one hour ahead.
+//
+//  Build and run from the repository root:
+//    g++ -O2 -Isrc extras/bench/ADIS16470_TimeSyncSim.cpp src/ADIS16470_TimeSync.cpp -o timesync_sim
+//    ./timesync_sim
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "ADIS16470_TimeSync.h"
+
+static uint64_t hostNow; // Simulated MCU clock, 64-bit truth
+static uint32_t simClock(void) { return (uint32_t)hostNow; }
+
+struct Case {
+  const char *name;
+  double ticksPerUs;     // MCU clock rate
+  double driftPpm;       // Sensor clock error
+  double wanderPpm;      // Amplitude of a 60 s sinusoidal drift change
+  double jitterUs;       // Uniform interrupt latency jitter (plus 2 us fixed)
+  double spikeRate;      // Fraction of captures delayed by 50-150 us
+  double dropRate;       // Fraction of samples not read
+};
+
+struct Moments {
+  double sum = 0, sumSq = 0, maxAbs = 0;
+  uint64_t n = 0;
+  void add(double x) { sum += x; sumSq += x * x; maxAbs = std::max(maxAbs, fabs(x)); n++; }
+  double mean(void) const { return sum / n; }
+  double rms(void) const { return sqrt(sumSq / n - mean() * mean()); }
+};
+
+static bool run(const Case &c) {
+
+  const double odr = 2000, seconds = 120;
+  const double ticksPerSample = c.ticksPerUs * 1e6 / odr;
+  ADIS16470TimeSync sync(simClock, (float)ticksPerSample);
+  std::mt19937_64 rng(7);
+  std::uniform_real_distribution<double> uni(0, 1);
+
+  Moments raw, tracked, deviation;
+  double edgeUs = 1000;          // True time of the current edge
+  uint16_t timeStamp = 0xFF00;   // Starts near a wrap
+  uint64_t samples = 0, firstSample = 0, expected64 = 0;
+  bool first = true, stalled = false;
+  double trueDriftPpm = 0;
+
+  // hostTime() checks: one second back and ahead from an armed sample, and one hour ahead
+  uint64_t armIndex = 0, armEst = 0, aheadIndex = 0, aheadTicks = 0;
+  Moments back, ahead;
+  bool hostTimeOk = true;
+
+  while (edgeUs < seconds * 1e6)
+  {
+    double t = edgeUs * 1e-6;
+    trueDriftPpm = c.driftPpm + c.wanderPpm * sin(2 * M_PI * t / 60);
+    edgeUs += 1e6 / odr / (1 + trueDriftPpm * 1e-6);
+    timeStamp++;
+    samples++;
+
+    // 3 s stall at 70 s (e.g. the application blocked the interrupt)
+    if (t > 70 && t < 73)
+    {
+      stalled = true;
+      continue;
+    }
+    if (uni(rng) < c.dropRate)
+      continue;
+
+    double latencyUs = 2 + c.jitterUs * uni(rng);
+    if (uni(rng) < c.spikeRate)
+      latencyUs += 50 + 100 * uni(rng);
+    hostNow = (uint64_t)((edgeUs + latencyUs) * c.ticksPerUs); // Counter truncates
+
+    uint64_t est = sync.update(sync.now(), timeStamp);
+    if (first)
+    {
+      firstSample = samples;
+      expected64 = timeStamp;
+      first = false;
+    }
+    else
+      expected64 = (uint64_t)(uint16_t)(0xFF00 + firstSample) + (samples - firstSample);
+
+    // 64-bit extension of the simulated MCU clock and TIME_STAMP
+    if (sync.timeStamp64() != expected64)
+    {
+      printf("FAIL %s: TIME_STAMP extended to %llu, expected %llu\n", c.name,
+             (unsigned long long)sync.timeStamp64(), (unsigned long long)expected64);
+      return false;
+    }
+
+    // Score only while locked, excluding the reacquisition after the stall
+    if (!sync.stats().locked || (stalled && t < 75))
+      continue;
+    double trueTicks = edgeUs * c.ticksPerUs;
+    raw.add(((double)hostNow - trueTicks) / c.ticksPerUs);
+    tracked.add(((double)(int64_t)(est - (uint64_t)trueTicks) - (trueTicks - floor(trueTicks))) / c.ticksPerUs);
+    deviation.add(sync.stats().driftPpm - trueDriftPpm);
+
+    uint64_t index = sync.sampleIndex();
+    if (aheadIndex != 0 && index >= aheadIndex)
+    {
+      if (index == aheadIndex) // The predicted sample may have been dropped
+      {
+        ahead.add(((double)(int64_t)(aheadTicks - (uint64_t)trueTicks)) / c.ticksPerUs);
+        back.add(((double)(int64_t)(sync.hostTime(armIndex) - armEst)) / c.ticksPerUs);
+      }
+      aheadIndex = 0;
+    }
+    else if (aheadIndex == 0 && t > 80)
+    {
+      hostTimeOk = hostTimeOk && sync.hostTime(index) == est;
+      armIndex = index;
+      armEst = est;
+      aheadIndex = index + (uint64_t)odr;
+      aheadTicks = sync.hostTime(aheadIndex);
+
+      // An hour ahead only the drift estimate matters; compare with double math
+      double rate = -sync.stats().driftPpm * 1e-6;
+      double span = 3600 * odr * ticksPerSample * (1 + rate);
+      double got = (double)(int64_t)(sync.hostTime(index + (uint64_t)(3600 * odr)) - est);
+      hostTimeOk = hostTimeOk && fabs(got - span) < 1e-8 * span;
+    }
+  }
+
+  const ADIS16470TimeSyncStats &s = sync.stats();
+  bool ok = tracked.rms() < raw.rms() && tracked.maxAbs - fabs(tracked.mean()) < 5 && s.restarts == 1 &&
+            fabs(deviation.mean()) < 1 && hostTimeOk && ahead.n > 10 && ahead.maxAbs < 10 + fabs(tracked.mean()) &&
+            back.maxAbs < 5;
+  printf("%s\n", c.name);
+  printf("  raw capture  : mean %7.2f us  jitter rms %6.3f us  max %7.2f us\n", raw.mean(), raw.rms(), raw.maxAbs);
+  printf("  tracked stamp: mean %7.2f us  jitter rms %6.3f us  max %7.2f us\n", tracked.mean(), tracked.rms(), tracked.maxAbs);
+  printf("  drift error  : mean %6.3f ppm  max %6.3f ppm (final estimate %.2f ppm)\n",
+         deviation.mean(), deviation.maxAbs, s.driftPpm);
+  printf("  hostTime()   : 1 s ahead max %6.2f us, 1 s back max %5.2f us over %llu checks, 1 h ahead %s\n",
+         ahead.maxAbs, back.maxAbs, (unsigned long long)ahead.n, hostTimeOk ? "matches" : "FAILS");
+  printf("  updates %u  outliers %u  restarts %u  TIME_STAMP64 %llu  %s\n", s.updates, s.outliers,
+         s.restarts, (unsigned long long)sync.timeStamp64(), ok ? "ok" : "FAIL");
+  return ok;
+}
+
+int main(void) {
+  Case cases[] = {
+    { "micros(), +40 ppm, 5 ppm wander, 3 us jitter",            1,  40, 5, 3, 0.000, 0.000 },
+    { "micros(), -120 ppm, spikes 0.5%, drops 0.1%",              1, -120, 5, 3, 0.005, 0.001 },
+    { "96 MHz cycle counter (wraps every 45 s), spikes and drops", 96, 40, 10, 3, 0.005, 0.001 },
+  };
+  int failures = 0;
+  for (const Case &c : cases)
+    if (!run(c))
+      failures++;
+  printf(failures ? "%d FAILED\n" : "all passed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,559 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Sim.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Host model of the ADIS16470 SPI interface. See ADIS16470_Sim.h.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <string.h>
+#include "ADIS16470_Sim.h"
+
+ADIS16470Sim adis16470Sim;
+
+// Registers written by the host. Everything else is read-only
+static const uint8_t writableRegs[] = {
+  XG_BIAS_LOW, XG_BIAS_HIGH, YG_BIAS_LOW, YG_BIAS_HIGH, ZG_BIAS_LOW, ZG_BIAS_HIGH,
+  XA_BIAS_LOW, XA_BIAS_HIGH, YA_BIAS_LOW, YA_BIAS_HIGH, ZA_BIAS_LOW, ZA_BIAS_HIGH,
+  FILT_CTRL, MSC_CTRL, UP_SCALE, DEC_RATE, NULL_CFG, GLOB_CMD, USER_SCR1, USER_SCR2, USER_SCR3
+};
+
+// 32-bit delta output LSB per 32-bit rate output LSB for one internal sample
+static const double deltaAngleGain = (double)ADIS16470_DEVICE::gyroScale /
+  ADIS16470_DEVICE::deltaAngleScale / SIM_SAMPLE_HZ;
+static const double deltaVelocityGain = (double)ADIS16470_DEVICE::accelScale * 9.80665 /
+  ADIS16470_DEVICE::deltaVelocityScale / SIM_SAMPLE_HZ;
+
+static bool isWritable(uint8_t regAddr) {
+  for (size_t i = 0; i < sizeof(writableRegs); i++)
+    if (writableRegs[i] == (regAddr & 0x7E))
+      return true;
+  return false;
+}
+
+static int32_t saturate32(int64_t value) {
+  if (value > INT32_MAX) return INT32_MAX;
+  if (value < INT32_MIN) return INT32_MIN;
+  return (int32_t)value;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Built-in sensing elements: a fixed offset per axis plus a ramp which
+// repeats every 1024 samples, so every output word changes.
+////////////////////////////////////////////////////////////////////////////
+static void patternSource(uint64_t sample, int32_t *values, void *context) {
+  (void)context;
+  for (int c = 0; c < 6; c++)
+    values[c] = (c + 1) * 100 * 65536 + (int32_t)(sample % 1024) * (c + 1) * 977;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Starts in the factory state with the sample clock running.
+////////////////////////////////////////////////////////////////////////////
+ADIS16470Sim::ADIS16470Sim() {
+  memset(_regs, 0, sizeof(_regs));
+  _regs[MSC_CTRL >> 1] = 0x00C1;
+  _regs[UP_SCALE >> 1] = 0x07D0;
+  _regs[NULL_CFG >> 1] = 0x070A;
+  _regs[FIRM_REV >> 1] = 0x0104;
+  _regs[FIRM_DM >> 1] = 0x0101;
+  _regs[FIRM_Y >> 1] = 0x2017;
+  _regs[PROD_ID >> 1] = ADIS16470_DEVICE::prodId;
+  _regs[SERIAL_NUM >> 1] = 0x0001;
+  memcpy(_flash, _regs, sizeof(_flash));
+  memset(_sum, 0, sizeof(_sum));
+  memset(_nullSum, 0, sizeof(_nullSum));
+  memset(_nullEstimate, 0, sizeof(_nullEstimate));
+  setSource(nullptr);
+  setClockPpm(0);
+  _nextInternal = _internalPeriodNs;
+  clearStats();
+}
+
+void ADIS16470Sim::setSource(ADIS16470SimSource source, void *context) {
+  _source = source ? source : patternSource;
+  _sourceContext = context;
+}
+
+void ADIS16470Sim::setDataReadyHandler(ADIS16470SimHandler handler, void *context) {
+  _handler = handler;
+  _handlerContext = context;
+  _handlerPending = false;
+}
+
+void ADIS16470Sim::setClockPpm(double ppm) {
+  _internalPeriodNs = 1e9 / (SIM_SAMPLE_HZ * (1.0 + ppm * 1e-6));
+}
+
+void ADIS16470Sim::setOverheadNs(uint32_t ns) {
+  _overheadNs = ns;
+}
+
+void ADIS16470Sim::run(uint64_t ns) {
+  advance(ns);
+}
+
+uint16_t ADIS16470Sim::peek(uint8_t regAddr) const {
+  return _regs[(regAddr & 0x7F) >> 1];
+}
+
+void ADIS16470Sim::poke(uint8_t regAddr, uint16_t value) {
+  _regs[(regAddr & 0x7F) >> 1] = value;
+}
+
+void ADIS16470Sim::clearStats(void) {
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+uint32_t ADIS16470Sim::violations(void) const {
+  return _stats.sclkViolations + _stats.stallViolations + _stats.readRateViolations +
+         _stats.frameErrors + _stats.busyAccesses + _stats.tornBursts;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Binds the pin numbers the driver uses to the model's CS, DR and RST.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Sim::attach(int CS, int DR, int RST) {
+  _csPin = CS;
+  _drPin = DR;
+  _rstPin = RST;
+}
+
+void ADIS16470Sim::beginTransaction(uint32_t sclkHz) {
+  _sclkHz = sclkHz ? sclkHz : 1;
+  _inTransaction = true;
+  advance(_overheadNs);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Ends a transaction and runs a data ready handler held back by it.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Sim::endTransaction(void) {
+  _inTransaction = false;
+  if (_handlerPending && !_inHandler)
+  {
+    _handlerPending = false;
+    runHandler();
+  }
+  advance(_overheadNs);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Clocks one byte. Register frames reply with the word requested by the
+// previous frame; during a burst the latched burst bytes are shifted out.
+// Time advances by eight SCLK periods plus the host overhead.
+////////////////////////////////////////////////////////////////////////////
+uint8_t ADIS16470Sim::transfer(uint8_t mosi) {
+  uint64_t _byteNs = (8000000000ULL + _sclkHz - 1) / _sclkHz;
+  if (_cs)
+  {
+    advance(_byteNs + _overheadNs); // Not selected
+    return 0;
+  }
+
+  uint8_t _miso;
+  if (_burst)
+  {
+    uint32_t _index = _byteCount - 2;
+    _miso = (_index < _burstLength) ? _burstBytes[_index] : 0;
+  }
+  else
+  {
+    _miso = (_byteCount & 1) ? (_pipeline & 0xFF) : (_pipeline >> 8);
+    _rx[_byteCount & 1] = mosi;
+  }
+  if (!_rst)
+    _miso = 0;
+  _byteCount++;
+
+  advance(_byteNs + _overheadNs);
+  if (!_burst && !(_byteCount & 1))
+    frameComplete();
+  return _miso;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Drives CS or RST. Releasing RST reloads the flash image and starts the
+// reset recovery time.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Sim::pinWrite(int pin, bool high) {
+  if (pin == _csPin && high != _cs)
+  {
+    _cs = high;
+    if (high)
+      csRise();
+    else
+      csFall();
+  }
+  else if (pin == _rstPin && high != _rst)
+  {
+    _rst = high;
+    if (high)
+    {
+      restore(_flash);
+      _busyUntil = _now + SIM_RESET_NS;
+    }
+  }
+  advance(_overheadNs);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Reads DR (active except while the outputs update or the part is busy,
+// with the polarity in MSC_CTRL bit 0). Always takes some time so polling
+// loops make progress.
+////////////////////////////////////////////////////////////////////////////
+bool ADIS16470Sim::pinRead(int pin) {
+  advance(_overheadNs ? _overheadNs : 1);
+  if (pin != _drPin)
+    return false;
+  bool _activeHigh = _regs[MSC_CTRL >> 1] & 0x0001;
+  return dataReadyActive() == _activeHigh;
+}
+
+void ADIS16470Sim::delayNs(uint64_t ns) {
+  advance(ns);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Moves simulated time forward, producing internal samples and data ready
+// edges in order. The handler may itself advance time; events it covers
+// are not repeated here.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Sim::advance(uint64_t ns) {
+  uint64_t _target = _now + ns;
+  for (;;)
+  {
+    uint64_t _internal = (uint64_t)_nextInternal;
+    bool _edgeFirst = _edgePending && _updateUntil <= _internal;
+    uint64_t _next = _edgeFirst ? _updateUntil : _internal;
+    if (_next > _target)
+      break;
+    if (_next > _now)
+      _now = _next;
+    if (_edgeFirst)
+      dataReadyEdge();
+    else
+      internalSample();
+  }
+  if (_now < _target)
+    _now = _target;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// One 2000 SPS sample: accumulate for decimation and auto-null, and
+// publish an output sample every DEC_RATE + 1 samples.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Sim::internalSample(void) {
+  _nextInternal += _internalPeriodNs;
+  if (busy())
+    return;
+
+  int32_t _values[6];
+  _source(_internalCount++, _values, _sourceContext);
+
+  uint16_t _nullCfg = _regs[NULL_CFG >> 1];
+  uint32_t _timeBase = 1UL << ((_nullCfg & 0x000F) > 12 ? 12 : (_nullCfg & 0x000F));
+  for (int c = 0; c < 6; c++)
+  {
+    _sum[c] += _values[c];
+    _nullSum[c] += _values[c];
+  }
+  if (++_nullCount >= _timeBase)
+  {
+    for (int c = 0; c < 6; c++)
+    {
+      _nullEstimate[c] = saturate32(llround((double)_nullSum[c] / _nullCount));
+      _nullSum[c] = 0;
+    }
+    _nullCount = 0;
+    _haveNullEstimate = true;
+  }
+
+  uint16_t _decRate = _regs[DEC_RATE >> 1];
+  uint32_t _n = ((_decRate > 1999) ? 1999 : _decRate) + 1;
+  if (++_decimation >= _n)
+  {
+    outputSample();
+    _decimation = 0;
+    memset(_sum, 0, sizeof(_sum));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Writes the averaged rates, delta angles/velocities, TEMP_OUT and
+// TIME_STAMP, and starts the update window which ends with the DR edge.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Sim::outputSample(void) {
+  if (!_sampleRead)
+    _stats.samplesMissed++;
+  _sampleRead = false;
+  _stats.samples++;
+  _outputCount++;
+
+  for (int c = 0; c < 6; c++)
+  {
+    int32_t _bias = bias(c);
+    int32_t _rate = saturate32(llround((double)_sum[c] / _decimation) + _bias);
+    double _gain = (c < 3) ? deltaAngleGain : deltaVelocityGain;
+    int32_t _delta = saturate32(llround((double)(_sum[c] + (int64_t)_decimation * _bias) * _gain));
+    _regs[(X_GYRO_LOW >> 1) + 2 * c] = (uint16_t)_rate;
+    _regs[(X_GYRO_LOW >> 1) + 2 * c + 1] = (uint16_t)((uint32_t)_rate >> 16);
+    _regs[(X_DELTANG_LOW >> 1) + 2 * c] = (uint16_t)_delta;
+    _regs[(X_DELTANG_LOW >> 1) + 2 * c + 1] = (uint16_t)((uint32_t)_delta >> 16);
+  }
+  _regs[DIAG_STAT >> 1] = 0;
+  _regs[TEMP_OUT >> 1] = 250; // 25 C
+  _regs[TIME_STAMP >> 1] = (uint16_t)_outputCount;
+
+  _updateStart = _now;
+  _updateUntil = _now + SIM_UPDATE_NS;
+  _edgePending = true;
+}
+
+void ADIS16470Sim::dataReadyEdge(void) {
+  _edgePending = false;
+  runHandler();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Runs the data ready handler, or marks it pending while a transaction or
+// the handler itself is active. A second edge while pending is lost.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Sim::runHandler(void) {
+  if (_handler == nullptr)
+    return;
+  if (_inTransaction || _inHandler)
+  {
+    if (_handlerPending)
+      _stats.handlerMissed++;
+    _handlerPending = true;
+    return;
+  }
+  do
+  {
+    _handlerPending = false;
+    _inHandler = true;
+    _handler(_handlerContext);
+    _inHandler = false;
+  } while (_handlerPending && !_inTransaction);
+}
+
+void ADIS16470Sim::csFall(void) {
+  if (_haveFrame && _now - _csRiseTime < STALL_MIN_US * 1000ULL)
+    _stats.stallViolations++;
+  _csFallTime = _now;
+  _byteCount = 0;
+  _burst = false;
+}
+
+void ADIS16470Sim::csRise(void) {
+  _stats.busNs += _now - _csFallTime;
+  if (_byteCount & 1)
+    _stats.frameErrors++;
+  if (_byteCount > 0)
+    _haveFrame = true;
+  _csRiseTime = _now;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decodes a completed 16-bit frame: burst command, byte write or read
+// request, with the clock, tREADRATE and busy checks.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Sim::frameComplete(void) {
+  bool _first = (_byteCount == 2);
+  bool _burstCommand = _first && _rx[0] == 0x68 && _rx[1] == 0x00;
+
+  if (_first && _sclkHz > (_burstCommand ? SCLK_BURST_MAX_HZ : SCLK_MAX_HZ))
+    _stats.sclkViolations++;
+
+  if (_burstCommand)
+  {
+    _stats.bursts++;
+    if (busy())
+      _stats.busyAccesses++;
+    else if (_csFallTime >= _updateStart && _csFallTime < _updateUntil)
+      _stats.tornBursts++;
+    loadBurst();
+    _burst = true;
+    _lastWasRegister = false;
+    return;
+  }
+
+  _stats.frames++;
+  uint64_t _frameStart = _first ? _csFallTime : _now - 2 * ((8000000000ULL + _sclkHz - 1) / _sclkHz);
+  if (_lastWasRegister && _frameStart - _lastFrameStart < READRATE_MIN_US * 1000ULL)
+    _stats.readRateViolations++;
+  _lastFrameStart = _frameStart;
+  _lastWasRegister = true;
+
+  uint8_t _addr = _rx[0] & 0x7F;
+  if (_rx[0] & 0x80)
+  {
+    _stats.writes++;
+    if (!busy())
+      writeByte(_addr, _rx[1]);
+    else if (_addr != GLOB_CMD + 1) // Upper GLOB_CMD byte sent after a command is harmless
+      _stats.busyAccesses++;
+    _pipeline = 0;
+  }
+  else
+  {
+    _stats.reads++;
+    if (busy())
+      _stats.busyAccesses++;
+    _pipeline = busy() ? 0 : _regs[_addr >> 1];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Writes one byte of a writable register. GLOB_CMD executes its command
+// on the lower byte; writing NULL_CFG restarts the auto-null average.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Sim::writeByte(uint8_t regAddr, uint8_t value) {
+  if (!isWritable(regAddr))
+    return;
+  uint8_t _word = regAddr >> 1;
+  if ((regAddr & 0x7E) == GLOB_CMD)
+  {
+    if (!(regAddr & 1))
+      command(value);
+    return;
+  }
+  if (regAddr & 1)
+    _regs[_word] = (_regs[_word] & 0x00FF) | (value << 8);
+  else
+    _regs[_word] = (_regs[_word] & 0xFF00) | value;
+  if ((regAddr & 0x7E) == NULL_CFG)
+  {
+    memset(_nullSum, 0, sizeof(_nullSum));
+    _nullCount = 0;
+    _haveNullEstimate = false;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Executes GLOB_CMD bits and starts the matching busy time.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Sim::command(uint8_t bits) {
+  uint64_t _busy = 0;
+  if (bits & 0x01) // Bias correction update
+  {
+    uint16_t _axes = _regs[NULL_CFG >> 1] >> 8;
+    for (int c = 0; c < 6; c++)
+    {
+      if (!(_axes & (1 << c)))
+        continue;
+      int32_t _mean = _haveNullEstimate ? _nullEstimate[c] :
+        (_nullCount ? saturate32(llround((double)_nullSum[c] / _nullCount)) : 0);
+      int32_t _value = saturate32(-(int64_t)_mean);
+      _regs[(XG_BIAS_LOW >> 1) + 2 * c] = (uint16_t)_value;
+      _regs[(XG_BIAS_LOW >> 1) + 2 * c + 1] = (uint16_t)((uint32_t)_value >> 16);
+    }
+    _busy = SIM_BIAS_UPDATE_NS;
+  }
+  if (bits & 0x02) // Factory calibration restore
+  {
+    for (int i = 0; i < 12; i++)
+      _regs[(XG_BIAS_LOW >> 1) + i] = 0;
+    _busy = SIM_FACTORY_NS;
+  }
+  if (bits & 0x04) // Self test
+    _busy = SIM_SELF_TEST_NS;
+  if (bits & 0x08) // Flash memory update
+  {
+    for (size_t i = 0; i < sizeof(writableRegs); i++)
+      _flash[writableRegs[i] >> 1] = _regs[writableRegs[i] >> 1];
+    uint32_t _count = ((uint32_t)_regs[FLSHCNT_HIGH >> 1] << 16 | _regs[FLSHCNT_LOW >> 1]) + 1;
+    _regs[FLSHCNT_LOW >> 1] = (uint16_t)_count;
+    _regs[FLSHCNT_HIGH >> 1] = (uint16_t)(_count >> 16);
+    _busy = SIM_FLASH_UPDATE_NS;
+  }
+  if (bits & 0x80) // Software reset
+  {
+    restore(_flash);
+    _busy = SIM_RESET_NS;
+  }
+  if (_busy)
+    _busyUntil = _now + _busy;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Latches the burst for the current MSC_CTRL settings and computes its
+// checksum. Reading the same sample twice, or while busy, is counted.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Sim::loadBurst(void) {
+  uint16_t _msc = _regs[MSC_CTRL >> 1];
+  bool _wide = _msc & 0x0200;           // BURST32
+  uint8_t _base = (_msc & 0x0100) ? X_DELTANG_LOW : X_GYRO_LOW; // BURST_SEL
+  uint16_t _words[BURST32_WORDS];
+  int _n = 0;
+
+  _words[_n++] = _regs[DIAG_STAT >> 1];
+  for (int c = 0; c < 6; c++)
+  {
+    if (_wide)
+      _words[_n++] = _regs[(_base >> 1) + 2 * c];
+    _words[_n++] = _regs[(_base >> 1) + 2 * c + 1];
+  }
+  _words[_n++] = _regs[TEMP_OUT >> 1];
+  _words[_n++] = _regs[TIME_STAMP >> 1];
+  _words[_n] = (uint16_t)adis16470Checksum(_words, _n);
+  _n++;
+
+  if (busy())
+    memset(_words, 0, sizeof(_words));
+  else if (_sampleRead)
+    _stats.duplicateReads++;
+  else
+    _sampleRead = true;
+
+  for (int i = 0; i < _n; i++)
+  {
+    _burstBytes[2 * i] = _words[i] >> 8;
+    _burstBytes[2 * i + 1] = _words[i] & 0xFF;
+  }
+  _burstLength = 2 * _n;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Reloads the writable registers and restarts the output pipeline, as
+// after a reset.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Sim::restore(const uint16_t *image) {
+  for (size_t i = 0; i < sizeof(writableRegs); i++)
+    _regs[writableRegs[i] >> 1] = image[writableRegs[i] >> 1];
+  _regs[GLOB_CMD >> 1] = 0;
+  _decimation = 0;
+  memset(_sum, 0, sizeof(_sum));
+  memset(_nullSum, 0, sizeof(_nullSum));
+  _nullCount = 0;
+  _haveNullEstimate = false;
+  _outputCount = 0;
+  _sampleRead = true;
+  _edgePending = false;
+}
+
+int32_t ADIS16470Sim::bias(int channel) const {
+  int _word = (XG_BIAS_LOW >> 1) + 2 * channel;
+  return (int32_t)(((uint32_t)_regs[_word + 1] << 16) | _regs[_word]);
+}
@@ -0,0 +1,211 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Sim.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Host model of the ADIS16470 SPI interface for running the driver off-target. Time is
+//  simulated in nanoseconds and advances only as the driver clocks bytes at its configured
+//  SCLK, waits in delays, or when the host calls run(). The model covers:
+//
+//  - 16-bit frames per CS assertion with pipelined reads (each frame returns the register
+//    addressed by the previous frame) and byte writes (address | 0x80)
+//  - Burst command 0x68 with 16- or 32-bit, inertial or delta contents per MSC_CTRL and the
+//    byte-sum checksum
+//  - An internal 2000 SPS sample clock (optionally offset in ppm) decimated by DEC_RATE + 1,
+//    bias registers, TIME_STAMP counting output samples, and the DR pin with its polarity
+//  - GLOB_CMD software reset, flash update, factory restore and bias correction update
+//    (auto-null over the last complete NULL_CFG time base), with their busy times
+//  - Checks for SCLK above the datasheet limit, CS high shorter than tSTALL, frame starts
+//    closer than tREADRATE, partial frames, access while busy and bursts started while the
+//    output registers update
+//
+//  A data ready handler stands in for the ISR. It runs at each DR edge, deferred while a
+//  transaction is open, as SPI.usingInterrupt() would. ADIS16470_SimTransport.h binds the
+//  driver to this model.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ADIS16470_Types.h"
+#include "ADIS16470_Device.h"
+#include "ADIS16470_Timing.h"
+
+// Internal sample rate before decimation
+#define SIM_SAMPLE_HZ        2000
+
+// Time the output registers take to update; DR is inactive meanwhile
+#define SIM_UPDATE_NS        10000
+
+// GLOB_CMD execution and reset recovery times
+#define SIM_RESET_NS         193000000ULL
+#define SIM_FLASH_UPDATE_NS  72000000ULL
+#define SIM_FACTORY_NS       142000000ULL
+#define SIM_SELF_TEST_NS     14000000ULL
+#define SIM_BIAS_UPDATE_NS   400000ULL
+
+// Values produced by the sensing elements for one internal sample: X/Y/Z gyro then
+// X/Y/Z accel in 32-bit output LSB, before the bias registers are added
+typedef void (*ADIS16470SimSource)(uint64_t sample, int32_t *values, void *context);
+
+// Called at each data ready edge, in place of the DR interrupt
+typedef void (*ADIS16470SimHandler)(void *context);
+
+struct ADIS16470SimStats {
+  uint32_t frames;             // 16-bit register frames
+  uint32_t reads;              // Register read requests
+  uint32_t writes;             // Byte writes
+  uint32_t bursts;             // Burst reads
+  uint32_t sclkViolations;     // Transactions clocked above the datasheet maximum
+  uint32_t stallViolations;    // CS high for less than tSTALL
+  uint32_t readRateViolations; // Register frames starting less than tREADRATE apart
+  uint32_t frameErrors;        // CS released part way through a frame or burst
+  uint32_t busyAccesses;       // Reads or bursts while reset or a command was executing
+  uint32_t tornBursts;         // Bursts started while the output registers were updating
+  uint32_t samples;            // Output samples produced (data ready edges)
+  uint32_t samplesMissed;      // Output samples overwritten before any burst read them
+  uint32_t duplicateReads;     // Bursts returning a sample an earlier burst already read
+  uint32_t handlerMissed;      // Data ready edges lost while the handler was still pending
+  uint64_t busNs;              // Time CS was low
+};
+
+class ADIS16470Sim {
+
+public:
+  ADIS16470Sim();
+
+  // Sensing element model (nullptr restores the built-in deterministic pattern)
+  void setSource(ADIS16470SimSource source, void *context = nullptr);
+
+  // Data ready handler standing in for the ISR (nullptr to detach)
+  void setDataReadyHandler(ADIS16470SimHandler handler, void *context = nullptr);
+
+  // Sample clock error in ppm
+  void setClockPpm(double ppm);
+
+  // Host CPU time charged to every transfer and pin access, to model driver overhead
+  void setOverheadNs(uint32_t ns);
+
+  // Advance simulated time, running the data ready handler at each edge
+  void run(uint64_t ns);
+
+  // Current simulated time
+  uint64_t now(void) const { return _now; }
+
+  // Register backdoor (no SPI traffic, no timing checks)
+  uint16_t peek(uint8_t regAddr) const;
+  void poke(uint8_t regAddr, uint16_t value);
+
+  // Counters since construction or clearStats()
+  const ADIS16470SimStats &stats(void) const { return _stats; }
+  void clearStats(void);
+
+  // Sum of the protocol violation counters
+  uint32_t violations(void) const;
+
+  // Host side interface used by ADIS16470SimTransport
+  void attach(int CS, int DR, int RST);
+  void beginTransaction(uint32_t sclkHz);
+  void endTransaction(void);
+  uint8_t transfer(uint8_t mosi);
+  void pinWrite(int pin, bool high);
+  bool pinRead(int pin);
+  void delayNs(uint64_t ns);
+
+private:
+  void advance(uint64_t ns);
+  void internalSample(void);
+  void outputSample(void);
+  void dataReadyEdge(void);
+  void runHandler(void);
+  void csFall(void);
+  void csRise(void);
+  void frameComplete(void);
+  void writeByte(uint8_t regAddr, uint8_t value);
+  void command(uint8_t bits);
+  void loadBurst(void);
+  void restore(const uint16_t *image);
+  int32_t bias(int channel) const;
+  bool busy(void) const { return !_rst || _now < _busyUntil; }
+  bool dataReadyActive(void) const { return !busy() && _now >= _updateUntil; }
+
+  // Registers (word index = address / 2) and their flash copy
+  uint16_t _regs[64];
+  uint16_t _flash[64];
+
+  // Pins
+  int _csPin = -1;
+  int _drPin = -1;
+  int _rstPin = -1;
+  bool _cs = true;
+  bool _rst = true;
+
+  // SPI state
+  uint32_t _sclkHz = SCLK_MAX_HZ;
+  bool _inTransaction = false;
+  uint8_t _rx[2];
+  uint32_t _byteCount = 0;     // Bytes in the current CS assertion
+  bool _burst = false;
+  uint8_t _burstBytes[2 * BURST32_WORDS];
+  uint8_t _burstLength = 0;
+  uint16_t _pipeline = 0;      // Reply clocked out by the next frame
+  bool _haveFrame = false;     // A frame has ended, so tSTALL applies
+  bool _lastWasRegister = false;
+  uint64_t _csFallTime = 0;
+  uint64_t _csRiseTime = 0;
+  uint64_t _lastFrameStart = 0;
+  uint32_t _overheadNs = 50;
+
+  // Sample clock and outputs
+  uint64_t _now = 0;
+  double _internalPeriodNs;
+  double _nextInternal;
+  uint64_t _updateStart = 0;
+  uint64_t _updateUntil = 0;
+  uint64_t _busyUntil = 0;
+  bool _edgePending = false;
+  uint64_t _internalCount = 0;
+  uint32_t _decimation = 0;    // Internal samples in the current output
+  int64_t _sum[6];             // Raw sums over the current output
+  uint32_t _outputCount = 0;
+  bool _sampleRead = true;
+
+  // Auto-null: sums over the current NULL_CFG time base and the last complete estimate
+  int64_t _nullSum[6];
+  uint32_t _nullCount = 0;
+  int32_t _nullEstimate[6];
+  bool _haveNullEstimate = false;
+
+  // Sensing elements and data ready handler
+  ADIS16470SimSource _source = nullptr;
+  void *_sourceContext = nullptr;
+  ADIS16470SimHandler _handler = nullptr;
+  void *_handlerContext = nullptr;
+  bool _inHandler = false;
+  bool _handlerPending = false;
+
+  ADIS16470SimStats _stats;
+};
+
+// Simulator used by ADIS16470SimTransport::defaultBus()
+extern ADIS16470Sim adis16470Sim;
@@ -0,0 +1,497 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_SimCheck.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Runs the unmodified ADIS16470 driver against the host simulator and checks register
+//  access, configuration, data-ready-driven bursts in every mode, bias calibration and
+//  reset handling with zero protocol violations. Deliberately bad timing is then used
+//  to confirm the simulator reports SCLK, tSTALL and tREADRATE violations. Exits non-zero
+//  on any failure, so it can run in CI.
+//
+//  Build and run from the repository root:
+//    g++ -O2 -DADIS16470_TRANSPORT_HEADER='"ADIS16470_SimTransport.h"' -Isrc -Iextras/sim
+//        extras/sim/ADIS16470_SimCheck.cpp extras/sim/ADIS16470_Sim.cpp src/*.cpp -o sim_check
+//    ./sim_check
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "ADIS16470.h"
+
+#if !defined(ADIS16470_TRANSPORT_HEADER)
+#error Build with -DADIS16470_TRANSPORT_HEADER='"ADIS16470_SimTransport.h"'
+#endif
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+  if (!ok)
+    failures++;
+}
+
+static void report(const ADIS16470Sim &sim) {
+  const ADIS16470SimStats &s = sim.stats();
+  printf("  [frames %u reads %u writes %u bursts %u | sclk %u stall %u readrate %u partial %u busy %u torn %u]\n",
+         s.frames, s.reads, s.writes, s.bursts, s.sclkViolations, s.stallViolations,
+         s.readRateViolations, s.frameErrors, s.busyAccesses, s.tornBursts);
+}
+
+// Expected 16-bit output for the simulator's built-in pattern with no decimation or bias
+static int16_t patternOut(uint64_t sample, int channel) {
+  int32_t v = (channel + 1) * 100 * 65536 + (int32_t)(sample % 1024) * (channel + 1) * 977;
+  return (int16_t)(v >> 16);
+}
+
+// Data ready handler: the whole ISR, as in the examples
+static ADIS16470 *isrImu = nullptr;
+static void dataReadyIsr(void *context) {
+  (void)context;
+  isrImu->queueBurst();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Register reads, pipelined reads, writes and configuration profiles
+////////////////////////////////////////////////////////////////////////////
+static void registerAccess(void) {
+  printf("register access\n");
+  ADIS16470Sim sim;
+  ADIS16470 imu(10, 2, 6, sim);
+
+  check(imu.read<ADIS16470Traits::ProdId>() == 16470, "PROD_ID through read<ProdId>()");
+
+  uint8_t addrs[4] = { MSC_CTRL, UP_SCALE, NULL_CFG, PROD_ID };
+  int16_t data[4];
+  imu.regReadMany(addrs, data, 4);
+  bool match = true;
+  for (int i = 0; i < 4; i++)
+    match = match && (uint16_t)data[i] == sim.peek(addrs[i]);
+  check(match, "regReadMany() returns each register in order");
+
+  imu.regWrite(USER_SCR1, 0x1234);
+  check(sim.peek(USER_SCR1) == 0x1234 && imu.regRead(USER_SCR1) == 0x1234, "regWrite() then regRead()");
+
+  imu.regWrite(PROD_ID, 0);
+  check(sim.peek(PROD_ID) == 16470, "read-only register ignores writes");
+
+  const ADIS16470RegValue config[] = { { MSC_CTRL, 0xC1 }, { FILT_CTRL, 0x04 }, { DEC_RATE, 0x03 } };
+  int written = imu.applyConfig(config, 3, true);
+  check(written == 2, "applyConfig() writes only the two changed bytes");
+  check(imu.applyConfig(config, 3, true) == 0, "second applyConfig() writes nothing and verifies");
+
+  ADIS16470RegValue oversized[SHADOW_REGS + 1];
+  for (int i = 0; i <= SHADOW_REGS; i++)
+    oversized[i] = { USER_SCR1, (int16_t)i };
+  uint32_t frames = sim.stats().frames;
+  check(imu.applyConfig(oversized, SHADOW_REGS + 1) == -1 && sim.stats().frames == frames,
+        "oversized applyConfig() is rejected without bus traffic");
+
+  // Scaling follows the part, also through a base class reference
+  ADIS16465_2 part(10, 2, 6, sim);
+  ADIS16470 &base = part;
+  check(base.gyroScale(40) == 1.0f && base.accelScale(4000) == 1.0f, "ADIS16465_2 scaling through ADIS16470 &");
+  check(base.gyroScale32(40 << 16) == 1.0f && imu.gyroScale(10) == 1.0f, "32-bit scaling; ADIS16470 keeps its own");
+
+  report(sim);
+  check(sim.violations() == 0, "no protocol violations");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sync modes: MSC_CTRL sync field and UP_SCALE
+////////////////////////////////////////////////////////////////////////////
+static void syncModes(void) {
+  printf("sync modes\n");
+  ADIS16470Sim sim;
+  ADIS16470 imu(10, 2, 6, sim);
+  uint16_t msc = sim.peek(MSC_CTRL);
+
+  uint32_t writes = sim.stats().writes;
+  check(imu.setSyncMode(SYNC_SCALED, 0) == -1 && sim.stats().writes == writes, "SYNC_SCALED without UP_SCALE is rejected unwritten");
+
+  check(imu.setSyncMode(SYNC_SCALED, 1000) == 1, "setSyncMode(SYNC_SCALED, 1000) verifies");
+  check(sim.peek(UP_SCALE) == 1000, "UP_SCALE holds the scale factor");
+  check(sim.peek(MSC_CTRL) == ((msc & ~MSC_SYNC_MASK) | SYNC_SCALED), "sync field set, other MSC_CTRL bits kept");
+
+  check(imu.setSyncMode(SYNC_DIRECT) == 1 && sim.peek(UP_SCALE) == 1000, "SYNC_DIRECT leaves UP_SCALE alone");
+  check(imu.setSyncMode(SYNC_INTERNAL) == 1 && sim.peek(MSC_CTRL) == msc, "SYNC_INTERNAL restores MSC_CTRL");
+  writes = sim.stats().writes;
+  check(imu.setSyncMode(SYNC_INTERNAL) == 1 && sim.stats().writes == writes, "repeating the mode writes nothing");
+
+  report(sim);
+  check(sim.violations() == 0, "no protocol violations");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// DR rate follows DEC_RATE
+////////////////////////////////////////////////////////////////////////////
+static int edges = 0;
+static void countEdge(void *context) { (void)context; edges++; }
+
+static void dataReadyRate(void) {
+  printf("data ready rate\n");
+  const uint16_t decRates[] = { 0, 3, 9, 1999 };
+  for (uint16_t d : decRates)
+  {
+    ADIS16470Sim sim;
+    ADIS16470 imu(10, 2, 6, sim);
+    const ADIS16470RegValue config = { DEC_RATE, (int16_t)d };
+    imu.applyConfig(&config, 1);
+    sim.run(1000000); // Let the current output period finish
+    edges = 0;
+    sim.setDataReadyHandler(countEdge);
+    sim.run(2000000000ULL);
+    int expected = 2 * 2000 / (d + 1);
+    char text[80];
+    snprintf(text, sizeof(text), "DEC_RATE %4u: %5d edges in 2 s (expected %d)", d, edges, expected);
+    check(abs(edges - expected) <= 1, text);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// ISR-driven queueBurst() at 2000 SPS with loop() draining the queue
+////////////////////////////////////////////////////////////////////////////
+static void queuedBursts(void) {
+  printf("queued bursts at 2000 SPS\n");
+  ADIS16470Sim sim;
+  ADIS16470 imu(10, 2, 6, sim);
+  const ADIS16470RegValue config[] = { { MSC_CTRL, 0xC1 }, { DEC_RATE, 0 } };
+  imu.applyConfig(config, 2, true);
+  sim.run(1000000);
+
+  ADIS16470Frame frames[ADIS16470_QUEUE_DEPTH];
+  isrImu = &imu;
+  sim.setDataReadyHandler(dataReadyIsr);
+  sim.run(1000000);
+  imu.readFrames(frames, ADIS16470_QUEUE_DEPTH);
+  imu.clearIntegrityStats();
+  sim.clearStats();
+
+  uint32_t received = 0;
+  bool dataOk = true;
+  uint64_t start = sim.now();
+  for (int ms = 0; ms < 1000; ms++)
+  {
+    sim.run(1000000); // loop() body: idle 1 ms, then drain
+    size_t n = imu.readFrames(frames, ADIS16470_QUEUE_DEPTH);
+    for (size_t i = 0; i < n; i++)
+    {
+      // TIME_STAMP counts output samples from 1; the pattern is indexed from 0
+      uint64_t sample = (uint64_t)frames[i].timeStamp - 1;
+      for (int c = 0; c < 3; c++)
+        dataOk = dataOk && frames[i].gyro[c] == patternOut(sample, c) && frames[i].accl[c] == patternOut(sample, 3 + c);
+    }
+    received += n;
+  }
+  sim.setDataReadyHandler(nullptr);
+  double elapsed = (sim.now() - start) * 1e-9;
+
+  ADIS16470IntegrityStats is = imu.integrityStats();
+  const ADIS16470SimStats &ss = sim.stats();
+  printf("  %u frames in %.3f s, bus busy %.1f%%, %u samples produced\n", received, elapsed,
+         100.0 * ss.busNs / (elapsed * 1e9), ss.samples);
+  check(received + 1 >= ss.samples && received <= ss.samples, "every sample queued");
+  check(dataOk, "frame contents match the sensing elements");
+  check(is.badChecksum == 0 && is.gaps == 0 && is.duplicates == 0, "no checksum errors, gaps or duplicates");
+  check(ss.samplesMissed == 0 && ss.duplicateReads == 0 && ss.handlerMissed == 0, "simulator saw each sample read once");
+  report(sim);
+  check(sim.violations() == 0, "no protocol violations");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Bursts started by ADIS16470Scheduler through the asynchronous adapter
+////////////////////////////////////////////////////////////////////////////
+static ADIS16470Sim *schedSim = nullptr;
+static ADIS16470Scheduler *schedIsr = nullptr;
+static int schedDevice = -1;
+static uint32_t schedCallbacks = 0, schedBad = 0;
+static uint16_t schedLastTimeStamp = 0;
+static ADIS16470 *schedImu = nullptr;
+
+static uint32_t simMicros(void) { return (uint32_t)(schedSim->now() / 1000); }
+static void schedDataReady(void *context) { (void)context; schedIsr->dataReady(schedDevice); }
+
+static void schedBurstDone(uint16_t *burstWords, uint8_t status) {
+  schedCallbacks++;
+  if (status != 0 && schedCallbacks > 1) // The first sample has no TIME_STAMP to follow
+    schedBad++;
+  schedLastTimeStamp = burstWords[ADIS16470BurstLayout::timeStamp];
+  schedImu->releaseBurst(burstWords);
+}
+
+static void scheduledBursts(void) {
+  printf("scheduled asynchronous bursts\n");
+  ADIS16470Sim sim;
+  ADIS16470 imu(10, 2, 6, sim);
+  ADIS16470Scheduler scheduler(simMicros);
+  static uint16_t bufferA[BURST_WORDS], bufferB[BURST_WORDS];
+  schedSim = &sim;
+  schedIsr = &scheduler;
+  schedImu = &imu;
+
+  schedDevice = scheduler.addDevice(0, ADIS16470::scheduledBeginBurst, &imu);
+  check(imu.setBurstBuffers(bufferA, bufferB) == 1 && imu.attachScheduler(&scheduler, 0, schedBurstDone) == 1,
+        "buffers and scheduler attached");
+  sim.run(1000000);
+  sim.clearStats();
+  sim.setDataReadyHandler(schedDataReady);
+  for (int i = 0; i < 2000; i++) // 200 ms, polled every 100 us
+  {
+    sim.run(100000);
+    scheduler.poll();
+  }
+  sim.setDataReadyHandler(nullptr);
+
+  const ADIS16470DeviceStats &ds = scheduler.stats(schedDevice);
+  const ADIS16470SimStats &ss = sim.stats();
+  printf("  %u samples, %u serviced, %u callbacks, latency max %u us\n", ss.samples, ds.serviced,
+         schedCallbacks, ds.latencyMax);
+  check(ds.serviced == schedCallbacks && ds.dropped == 0, "every transaction completes through the callback");
+  check(schedCallbacks + 1 >= ss.samples && schedBad == 0, "every sample delivered, no BURST_* flags");
+  check(schedLastTimeStamp == sim.peek(TIME_STAMP), "last burst holds the latest TIME_STAMP");
+  check(scheduler.pending() == 0 && scheduler.poll() == 0, "bus released after the last burst");
+  report(sim);
+  check(sim.violations() == 0, "no protocol violations");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// 32-bit and delta bursts match the registers
+////////////////////////////////////////////////////////////////////////////
+static void burstModes(void) {
+  printf("burst modes\n");
+  ADIS16470Sim sim;
+  ADIS16470 imu(10, 2, 6, sim);
+  const ADIS16470RegValue config = { DEC_RATE, 3 };
+  imu.applyConfig(&config, 1);
+
+  check(imu.setBurstMode(BURST_INERTIAL32) == 1, "setBurstMode() reads MSC_CTRL back");
+  sim.run(3000000);
+  ADIS16470Frame32 f32;
+  // Gaps are expected across sim.run(); only the checksum matters here
+  uint8_t status = imu.burst32(&f32);
+  int32_t zAccel = (int32_t)((uint32_t)sim.peek(Z_ACCL_OUT) << 16 | sim.peek(Z_ACCL_LOW));
+  check(!(status & BURST_BAD_CHECKSUM) && f32.accl[2] == zAccel, "burst32() checksum and Z accel LOW:OUT");
+
+  imu.setBurstMode(BURST_DELTA32);
+  sim.run(3000000);
+  ADIS16470DeltaFrame32 d32;
+  status = imu.deltaBurst32(&d32);
+  // Delta angle over 4 samples of 0.1 deg/s/LSB output at 2000 SPS
+  double expected = (double)sim.peek(X_GYRO_OUT) * 0.1 * 4 / 2000;
+  double actual = imu.deltaAngleScale32(d32.deltAng[0]);
+  check(!(status & BURST_BAD_CHECKSUM) && fabs(actual - expected) < 0.001, "deltaBurst32() X delta angle matches rate x period");
+  sim.run(2000000); // One output period at 500 SPS
+  check(imu.deltaBurst32(&d32) == 0, "deltaBurst32() next sample is clean");
+
+  imu.setBurstMode(BURST_DELTA16);
+  sim.run(3000000);
+  ADIS16470DeltaFrame d16;
+  status = imu.deltaBurst(&d16);
+  check(!(status & BURST_BAD_CHECKSUM) && d16.deltVel[2] == (int16_t)sim.peek(Z_DELTVEL_OUT), "deltaBurst() Z delta velocity");
+  check(imu.integrityStats().bursts == 4 && imu.integrityStats().badChecksum == 0, "32-bit and delta bursts feed the integrity counters");
+
+  imu.setBurstMode(BURST_INERTIAL16);
+  sim.run(3000000);
+  ADIS16470Frame f;
+  check(imu.validatedBurst(&f) == 0 && f.gyro[1] == (int16_t)sim.peek(Y_GYRO_OUT), "validatedBurst() back in 16-bit mode");
+  report(sim);
+  check(sim.violations() == 0, "no protocol violations");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// calibrateBias() against a noisy stationary sensor with known offsets
+////////////////////////////////////////////////////////////////////////////
+struct NoisySensor {
+  std::mt19937 rng;
+  std::normal_distribution<double> noise;
+  double offset[6];
+};
+
+static void noisySource(uint64_t sample, int32_t *values, void *context) {
+  (void)sample;
+  NoisySensor *s = (NoisySensor *)context;
+  for (int c = 0; c < 6; c++)
+    values[c] = (int32_t)llround((s->offset[c] + s->noise(s->rng)) * 65536.0);
+}
+
+static void calibration(void) {
+  printf("bias calibration\n");
+  ADIS16470Sim sim;
+  NoisySensor sensor = { std::mt19937(7), std::normal_distribution<double>(0.0, 1.0),
+                         { 3.7, -12.25, 0.4, -5.5, 8.1, 800.0 + 20.3 } };
+  sim.setSource(noisySource, &sensor);
+  ADIS16470 imu(10, 2, 6, sim);
+
+  ADIS16470BiasEstimator estimator;
+  estimator.setChannels(CAL_ALL);
+  estimator.setTargets(0.02f, 0.05f);
+  estimator.setExpected(5, 800.0f); // 1 g on Z
+  int result = imu.calibrateBias(estimator);
+  printf("  converged after %u samples, %.3f s simulated\n", estimator.samples(), sim.now() * 1e-9);
+  check(result == 1, "calibrateBias() converged and verified");
+
+  bool ok = true;
+  for (int c = 0; c < 6; c++)
+  {
+    int32_t programmed = (int32_t)((uint32_t)sim.peek(XG_BIAS_HIGH + 4 * c) << 16 | sim.peek(XG_BIAS_LOW + 4 * c));
+    double target = (c == 5 ? 800.0 : 0.0) - sensor.offset[c];
+    double error = programmed / 65536.0 - target;
+    ok = ok && fabs(error) < 4 * (c < 3 ? 0.02 : 0.05);
+  }
+  check(ok, "bias registers cancel the offsets within 4 targets");
+  check((sim.peek(MSC_CTRL) & (MSC_BURST32 | MSC_BURST_SEL)) == 0, "burst mode restored");
+
+  int32_t difference[6];
+  uint16_t nullCfg = sim.peek(NULL_CFG);
+  check(imu.compareAutoNull(difference, 0x0709) == 1, "compareAutoNull() restores and verifies");
+  check(sim.peek(NULL_CFG) == nullCfg, "NULL_CFG restored after a 2^9 sample time base");
+  printf("  auto-null minus ours (16-bit LSB): %.3f %.3f %.3f\n",
+         difference[0] / 65536.0, difference[1] / 65536.0, difference[2] / 65536.0);
+  check(fabs(difference[0] / 65536.0) < 0.2, "auto-null agrees on X gyro");
+  report(sim);
+  check(sim.violations() == 0, "no protocol violations");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Reset recovery and flash
+////////////////////////////////////////////////////////////////////////////
+static void resets(void) {
+  printf("reset handling\n");
+  ADIS16470Sim sim;
+  ADIS16470 imu(10, 2, 6, sim);
+  const ADIS16470RegValue config = { FILT_CTRL, 3 };
+  imu.applyConfig(&config, 1);
+  imu.regWrite(GLOB_CMD, 0x0008); // Flash update
+  imu.regWrite(USER_SCR2, 0x55);  // Too early: lost while the flash is written
+  check(sim.stats().busyAccesses == 2, "write during flash update is detected");
+  sim.run(100000000);
+  sim.clearStats();
+
+  imu.regWrite(FILT_CTRL, 5);
+  imu.resetDUT(200);
+  check(imu.regRead(FILT_CTRL) == 3, "hardware reset reloads flash contents");
+  check(sim.violations() == 0, "no violations after a 200 ms reset");
+
+  imu.resetDUT(10);
+  imu.regRead(PROD_ID);
+  check(sim.stats().busyAccesses > 0, "access 10 ms after reset is detected");
+}
+
+////////////////////////////////////////////////////////////////////////////
+// The simulator must catch timing the driver would never produce
+////////////////////////////////////////////////////////////////////////////
+static void violations(void) {
+  printf("violation detection\n");
+  ADIS16470Sim sim;
+  ADIS16470 imu(10, 2, 6, sim);
+
+  check(imu.configSPI(4000000, SCLK_MAX_HZ, SCLK_BURST_MAX_HZ) == -1 &&
+        imu.configSPI(SCLK_MAX_HZ, SCLK_MAX_HZ, 2000000) == -1, "configSPI() rejects clocks above the limits");
+  check(imu.configSPI(SCLK_MAX_HZ, SCLK_MAX_HZ, SCLK_BURST_MAX_HZ) == 1, "configSPI() accepts the limits");
+  imu.regRead(PROD_ID);
+  sim.run(3000000);
+  imu.wordBurst();
+  check(sim.stats().sclkViolations == 0, "driver at the limits is clean");
+
+  // The driver refuses to overclock, so drive the bus directly
+  ADIS16470SimTransport bus(sim);
+  bus.beginTransaction(ADIS16470SimTransport::settings(4000000));
+  for (int i = 0; i < 2; i++)
+  {
+    bus.pinWrite(10, false);
+    bus.transfer(PROD_ID);
+    bus.transfer(0);
+    bus.pinWrite(10, true);
+    bus.delayUs(STALL_MIN_US);
+  }
+  bus.endTransaction();
+  check(sim.stats().sclkViolations == 2, "4 MHz register reads");
+  sim.run(3000000);
+  bus.beginTransaction(ADIS16470SimTransport::settings(2000000));
+  bus.pinWrite(10, false);
+  for (int i = 0; i < 2 + 2 * BURST_WORDS; i++)
+    bus.transfer(i == 0 ? 0x68 : 0);
+  bus.pinWrite(10, true);
+  bus.endTransaction();
+  check(sim.stats().sclkViolations == 3, "2 MHz burst");
+
+  sim.run(100000);
+  sim.clearStats();
+  ADIS16470SimTransport::Settings s = ADIS16470SimTransport::settings(SCLK_MAX_HZ);
+  for (int i = 0; i < 2; i++) // Two frames with no stall
+  {
+    bus.beginTransaction(s);
+    bus.pinWrite(10, false);
+    bus.transfer(PROD_ID);
+    bus.transfer(0);
+    bus.pinWrite(10, true);
+    bus.endTransaction();
+  }
+  check(sim.stats().stallViolations == 1, "CS high shorter than tSTALL");
+
+  sim.run(100000);
+  sim.clearStats();
+  for (int i = 0; i < 2; i++) // Frames 8 us long, 17 us stall: starts 25 us apart is fine...
+  {
+    bus.beginTransaction(s);
+    bus.pinWrite(10, false);
+    bus.transfer(PROD_ID);
+    bus.transfer(0);
+    bus.pinWrite(10, true);
+    bus.endTransaction();
+    bus.delayUs(17);
+  }
+  check(sim.stats().readRateViolations == 0 && sim.stats().stallViolations == 0, "17 us stall at 2 MHz meets both limits");
+  bus.beginTransaction(ADIS16470SimTransport::settings(8000000));
+  for (int i = 0; i < 2; i++) // ...but 2 us frames with a 16 us stall are only 18 us apart
+  {
+    bus.pinWrite(10, false);
+    bus.transfer(PROD_ID);
+    bus.transfer(0);
+    bus.pinWrite(10, true);
+    bus.delayUs(16);
+  }
+  bus.endTransaction();
+  check(sim.stats().readRateViolations >= 1, "frame starts closer than tREADRATE");
+
+  bus.beginTransaction(s);
+  bus.pinWrite(10, false);
+  bus.transfer(PROD_ID); // Half a frame
+  bus.pinWrite(10, true);
+  bus.endTransaction();
+  check(sim.stats().frameErrors == 1, "CS released mid-frame");
+}
+
+int main(void) {
+  registerAccess();
+  syncModes();
+  dataReadyRate();
+  queuedBursts();
+  scheduledBursts();
+  burstModes();
+  calibration();
+  resets();
+  violations();
+  printf(failures ? "%d FAILED\n" : "all passed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_SimTransport.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Transport which connects the ADIS16470 driver to the host simulator (ADIS16470_Sim.h)
+//  instead of the Arduino SPI library. Select it for the whole build with
+//    -DADIS16470_TRANSPORT_HEADER='"ADIS16470_SimTransport.h"' -Isrc -Iextras/sim
+//  and pass an ADIS16470Sim as the constructor's bus (adis16470Sim by default). Delays
+//  and millis() run on simulated time.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ADIS16470_Sim.h"
+
+class ADIS16470SimTransport {
+
+public:
+  typedef ADIS16470Sim Bus;
+  struct Settings { uint32_t sclkHz; };
+
+  ADIS16470SimTransport(Bus &bus) : _bus(&bus) {}
+
+  static Bus &defaultBus(void) { return adis16470Sim; }
+
+  void begin(int CS, int DR, int RST) { _bus->attach(CS, DR, RST); }
+
+  static Settings settings(uint32_t sclkHz) { Settings s = { sclkHz }; return s; }
+
+  void beginTransaction(const Settings &settings) { _bus->beginTransaction(settings.sclkHz); }
+  void endTransaction(void) { _bus->endTransaction(); }
+  uint8_t transfer(uint8_t data) { return _bus->transfer(data); }
+
+  void pinWrite(int pin, bool high) { _bus->pinWrite(pin, high); }
+  bool pinRead(int pin) { return _bus->pinRead(pin); }
+
+  void delayUs(uint32_t us) { _bus->delayNs(us * 1000ULL); }
+  void delayMs(uint32_t ms) { _bus->delayNs(ms * 1000000ULL); }
+  uint32_t millis(void) { return (uint32_t)(_bus->now() / 1000000ULL); }
+
+private:
+  Bus *_bus;
+};
+
+#define ADIS16470_TRANSPORT ADIS16470SimTransport
@@ -0,0 +1,828 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Decode.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Command-line decoder and replay tool for captured ADIS16470 serial streams. Reads either 
+//  the legacy Datalog format (0xA5 0xA5 0xA5 followed by the 20 byteBurst() bytes) or the 
+//  packet format of ADIS16470_Stream.h, validates every frame, and writes scaled CSV or 
+//  columnar binary using the library scale factors.
+//
+//  Legacy captures are memory-mapped and may be decoded by several threads, each taking a 
+//  chunk of the file. Chunks are stitched at the boundaries so the output is identical to a 
+//  single-threaded pass. Replay mode serves every burst of either format on the fake bus of
+//  ADIS16470_RecordingTransport.h at the recorded output data rate (or a multiple of it). A
+//  producer thread reads them with queueBurst() (burst32()/deltaBurst32() for 32-bit samples)
+//  as the data ready ISR would, so the driver checks each checksum and tracks DIAG_STAT and 
+//  TIME_STAMP, and a consumer drains them with readFrames() and scales them in batches.
+//
+//  Build from the repository root (Linux/macOS):
+//    g++ -O3 -march=native -std=c++17 -pthread -Isrc -Iextras/bench
+//        -DADIS16470_TRANSPORT_HEADER='"ADIS16470_RecordingTransport.h"'
+//        extras/tools/ADIS16470_Decode.cpp src/*.cpp -o adis16470_decode
+//
+//  Usage:
+//    adis16470_decode [options] capture.bin
+//      -f legacy|stream   Input format (default legacy)
+//      -o csv|bin         Output format (default csv)
+//      -w file            Output file (default stdout)
+//      -j threads         Decoder threads for legacy input (default 1)
+//      -r rate            Replay at rate x the output data rate (0 = as fast as possible)
+//      -d odr             Output data rate used by replay, in Hz (default 2000)
+//      -s step            TIME_STAMP increment per sample checked by replay (default 1, 0 = off)
+//
+//  Binary output is a sequence of blocks: the ASCII tag "A16C", a little-endian uint32 sample 
+//  count n, then n uint16 DIAG_STAT, n float X/Y/Z gyro, n float X/Y/Z accel, n float temp 
+//  and n uint16 TIME_STAMP.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ADIS16470.h"
+#include "ADIS16470_Ring.h"
+#include "ADIS16470_Scale.h"
+#include "ADIS16470_Stream.h"
+
+#if !defined(ADIS16470_TRANSPORT_HEADER)
+#error Build with -DADIS16470_TRANSPORT_HEADER='"ADIS16470_RecordingTransport.h"'
+#endif
+
+// Legacy frame: three delimiter bytes followed by BURST_WORDS big-endian words
+#define LEGACY_DELIMITER  0xA5
+#define LEGACY_FRAME      (3 + 2 * BURST_WORDS)
+
+// Default chunk size handed to each thread
+#ifndef CHUNK_BYTES
+#define CHUNK_BYTES       (32u << 20)
+#endif
+
+// Frame counters
+struct Counters {
+  uint64_t frames = 0;       // Valid frames
+  uint64_t badChecksum = 0;  // Delimiters followed by a bad checksum
+  uint64_t skipped = 0;      // Bytes outside valid frames
+
+  Counters &operator+=(const Counters &c) {
+    frames += c.frames;
+    badChecksum += c.badChecksum;
+    skipped += c.skipped;
+    return *this;
+  }
+  Counters &operator-=(const Counters &c) {
+    frames -= c.frames;
+    badChecksum -= c.badChecksum;
+    skipped -= c.skipped;
+    return *this;
+  }
+};
+
+// Decoded frame and the file offset of its delimiter
+struct Located {
+  uint64_t offset;
+  ADIS16470Frame frame;
+};
+
+// Result of decoding one chunk
+struct Chunk {
+  uint64_t begin = 0;        // First scan position
+  uint64_t next = 0;         // Scan position where the walk stopped (>= end)
+  std::vector<Located> frames;
+  Counters counters;
+  // Scan positions and counters seen in the first LEGACY_FRAME bytes, used for stitching
+  std::vector<std::pair<uint64_t, Counters>> head;
+  std::string text;          // Formatted output
+};
+
+////////////////////////////////////////////////////////////////////////////
+// Returns true if the 20 burst bytes at p carry a valid checksum. The sum 
+// is the same as ADIS16470::checksum(): every byte of the first nine words.
+// The fixed-length loop is unrolled and vectorized by the compiler.
+////////////////////////////////////////////////////////////////////////////
+static inline bool legacyChecksumOk(const uint8_t *p) {
+  uint32_t sum = 0;
+  for (int i = 0; i < 2 * (BURST_WORDS - 1); i++)
+    sum += p[i];
+  return (uint16_t)sum == (uint16_t)((p[18] << 8) | p[19]);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decodes the 20 big-endian burst bytes at p
+////////////////////////////////////////////////////////////////////////////
+static inline void legacyDecode(const uint8_t *p, ADIS16470Frame *frame) {
+  uint16_t words[BURST_WORDS];
+  for (int i = 0; i < BURST_WORDS; i++)
+    words[i] = (p[2 * i] << 8) | p[2 * i + 1];
+  adis16470DecodeBurst(words, frame);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Walks legacy frames from pos while pos < end, calling emit for every 
+// valid frame. A delimiter with a bad checksum is treated as data and the 
+// scan resumes one byte later. Returns the scan position where it stopped.
+////////////////////////////////////////////////////////////////////////////
+template <typename Emit, typename Visit>
+static uint64_t walkLegacy(const uint8_t *data, uint64_t size, uint64_t pos, uint64_t end,
+                           Counters &counters, Emit emit, Visit visit) {
+  while (pos < end)
+  {
+    visit(pos);
+    if (pos + LEGACY_FRAME > size)
+    {
+      counters.skipped += size - pos; // Truncated frame at the end of the capture
+      return size;
+    }
+    const uint8_t *p = data + pos;
+    if (p[0] == LEGACY_DELIMITER && p[1] == LEGACY_DELIMITER && p[2] == LEGACY_DELIMITER)
+    {
+      if (legacyChecksumOk(p + 3))
+      {
+        emit(pos, p + 3);
+        counters.frames++;
+        pos += LEGACY_FRAME;
+        continue;
+      }
+      counters.badChecksum++;
+    }
+    // Jump to the next possible delimiter
+    const void *hit = memchr(p + 1, LEGACY_DELIMITER, size - pos - 1);
+    uint64_t nextPos = hit ? (const uint8_t *)hit - data : size;
+    if (nextPos > end)
+      nextPos = end;
+    counters.skipped += nextPos - pos;
+    pos = nextPos;
+  }
+  return pos;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decodes one chunk into c.frames, recording the early scan positions
+////////////////////////////////////////////////////////////////////////////
+static void decodeChunk(const uint8_t *data, uint64_t size, uint64_t begin, uint64_t end, Chunk &c) {
+  c.begin = begin;
+  c.frames.clear();
+  c.head.clear();
+  c.counters = Counters();
+  c.frames.reserve((end - begin) / LEGACY_FRAME + 1);
+  c.next = walkLegacy(data, size, begin, end, c.counters,
+    [&](uint64_t offset, const uint8_t *p) {
+      c.frames.emplace_back();
+      c.frames.back().offset = offset;
+      legacyDecode(p, &c.frames.back().frame);
+    },
+    [&](uint64_t pos) {
+      if (pos < begin + LEGACY_FRAME)
+        c.head.emplace_back(pos, c.counters);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Makes chunk c continue exactly where the previous walk stopped (start). 
+// If c's own walk passed through start, everything before it is dropped; 
+// otherwise c is decoded again from start.
+////////////////////////////////////////////////////////////////////////////
+static void stitchChunk(const uint8_t *data, uint64_t size, uint64_t start, uint64_t end, Chunk &c) {
+  if (start == c.begin)
+    return;
+  for (auto &h : c.head)
+  {
+    if (h.first == start)
+    {
+      size_t drop = 0;
+      while (drop < c.frames.size() && c.frames[drop].offset < start)
+        drop++;
+      c.frames.erase(c.frames.begin(), c.frames.begin() + drop);
+      c.counters -= h.second;
+      c.begin = start;
+      return;
+    }
+  }
+  decodeChunk(data, size, start, end, c); // The walks never converged
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Appends v with a fixed number of decimals. Much faster than printf.
+////////////////////////////////////////////////////////////////////////////
+static void appendFixed(std::string &out, float v, int decimals) {
+  static const int64_t pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+  int64_t scaled = (int64_t)(v * pow10[decimals] + (v < 0 ? -0.5f : 0.5f));
+  if (scaled < 0)
+  {
+    out += '-';
+    scaled = -scaled;
+  }
+  char buf[24];
+  int n = 0;
+  int64_t whole = scaled / pow10[decimals];
+  int64_t frac = scaled % pow10[decimals];
+  for (int i = 0; i < decimals; i++, frac /= 10)
+    buf[n++] = '0' + frac % 10;
+  if (decimals > 0)
+    buf[n++] = '.';
+  do
+  {
+    buf[n++] = '0' + whole % 10;
+    whole /= 10;
+  } while (whole);
+  while (n > 0)
+    out += buf[--n];
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Appends one CSV row. Decimal places follow the resolution of each output
+////////////////////////////////////////////////////////////////////////////
+static void appendCsvRow(std::string &out, uint64_t index, uint16_t diag, const float *values,
+                         uint16_t timeStamp) {
+  static const int decimals[7] = { 1, 1, 1, 5, 5, 5, 1 };
+  out += std::to_string(index);
+  out += ',';
+  out += std::to_string(diag);
+  for (int i = 0; i < 7; i++)
+  {
+    out += ',';
+    appendFixed(out, values[i], decimals[i]);
+  }
+  out += ',';
+  out += std::to_string(timeStamp);
+  out += '\n';
+}
+
+// Column header used for CSV output
+static const char csvHeader[] = "sample,diag_stat,x_gyro,y_gyro,z_gyro,x_accl,y_accl,z_accl,temp,time_stamp\n";
+
+////////////////////////////////////////////////////////////////////////////
+// Scales a batch of frames with scale and formats it as CSV or one binary 
+// block
+////////////////////////////////////////////////////////////////////////////
+template <typename Frame, typename Scale>
+static void formatBatch(const Frame *frames, size_t count, uint64_t firstIndex, bool binary, std::string &out,
+                        Scale scale) {
+  std::vector<float> soa(7 * count + 1);
+  ADIS16470ScaledData scaled = { &soa[0], &soa[count], &soa[2 * count], &soa[3 * count],
+                                 &soa[4 * count], &soa[5 * count], &soa[6 * count] };
+  scale(frames, count, scaled);
+
+  if (binary)
+  {
+    uint32_t n = count;
+    out.append("A16C", 4);
+    out.append((const char *)&n, 4);
+    for (size_t i = 0; i < count; i++)
+      out.append((const char *)&frames[i].diagStat, 2);
+    out.append((const char *)soa.data(), 7 * count * sizeof(float));
+    for (size_t i = 0; i < count; i++)
+      out.append((const char *)&frames[i].timeStamp, 2);
+    return;
+  }
+
+  out.reserve(out.size() + count * 72);
+  for (size_t i = 0; i < count; i++)
+  {
+    float values[7];
+    for (int j = 0; j < 7; j++)
+      values[j] = soa[j * count + i];
+    appendCsvRow(out, firstIndex + i, frames[i].diagStat, values, frames[i].timeStamp);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Formats 16-bit frames using the batch scaling kernel from the library
+////////////////////////////////////////////////////////////////////////////
+static void formatFrames(const ADIS16470Frame *frames, size_t count, uint64_t firstIndex, bool binary,
+                         std::string &out) {
+  formatBatch(frames, count, firstIndex, binary, out, adis16470ScaleFrames);
+}
+
+// Command-line options
+struct Options {
+  const char *input = nullptr;
+  const char *output = nullptr;
+  bool stream = false;
+  bool binary = false;
+  int threads = 1;
+  double replayRate = -1; // Negative: no replay
+  double odr = 2000;
+  uint16_t step = 1;      // TIME_STAMP increment checked by replay
+};
+
+////////////////////////////////////////////////////////////////////////////
+// Decodes a legacy capture with opts.threads threads, chunk by chunk
+////////////////////////////////////////////////////////////////////////////
+static Counters decodeLegacy(const uint8_t *data, uint64_t size, const Options &opts, FILE *out) {
+
+  Counters total;
+  uint64_t index = 0;
+  uint64_t carry = 0; // Where the previous round stopped
+  std::vector<Chunk> chunks(opts.threads);
+
+  while (carry < size)
+  {
+    // Phase 1: decode one chunk per thread
+    std::vector<uint64_t> ends(opts.threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < opts.threads; t++)
+    {
+      // Chunks end on multiples of CHUNK_BYTES, so the output blocks are the same for any thread count
+      uint64_t begin = (t == 0) ? carry : ends[t - 1];
+      ends[t] = (begin / CHUNK_BYTES + 1) * CHUNK_BYTES;
+      if (ends[t] > size)
+        ends[t] = size;
+      if (begin > ends[t])
+        begin = ends[t];
+      workers.emplace_back(decodeChunk, data, size, begin, ends[t], std::ref(chunks[t]));
+    }
+    for (auto &w : workers)
+      w.join();
+    workers.clear();
+
+    // Phase 2: stitch the chunks so they continue exactly where the previous one stopped
+    for (int t = 1; t < opts.threads; t++)
+      stitchChunk(data, size, chunks[t - 1].next, ends[t], chunks[t]);
+    carry = chunks[opts.threads - 1].next;
+
+    // Phase 3: format in parallel
+    std::vector<uint64_t> first(opts.threads);
+    for (int t = 0; t < opts.threads; t++)
+    {
+      first[t] = index;
+      index += chunks[t].frames.size();
+      total += chunks[t].counters;
+    }
+    for (int t = 0; t < opts.threads; t++)
+    {
+      workers.emplace_back([&, t]() {
+        Chunk &c = chunks[t];
+        c.text.clear();
+        if (c.frames.empty())
+          return; // No empty blocks for chunks past the end of the capture
+        std::vector<ADIS16470Frame> frames(c.frames.size());
+        for (size_t i = 0; i < frames.size(); i++)
+          frames[i] = c.frames[i].frame;
+        formatFrames(frames.data(), frames.size(), first[t], opts.binary, c.text);
+      });
+    }
+    for (auto &w : workers)
+      w.join();
+
+    // Phase 4: write in order
+    for (auto &c : chunks)
+      fwrite(c.text.data(), 1, c.text.size(), out);
+  }
+
+  return total;
+}
+
+// Samples collected before formatting a stream-format batch
+#define STREAM_BATCH  4096
+
+// Output state for stream-format decoding. Samples of one type are 
+// collected and formatted together; a change of type flushes the batch.
+struct StreamOutput {
+  bool binary;
+  uint64_t index = 0;
+  std::string text;
+  uint8_t type = STREAM_INERTIAL16;      // Type of the pending samples
+  std::vector<ADIS16470Frame> inertial16;
+  std::vector<ADIS16470DeltaFrame> delta16;
+  std::vector<ADIS16470Frame32> inertial32;
+  std::vector<ADIS16470DeltaFrame32> delta32;
+};
+
+////////////////////////////////////////////////////////////////////////////
+// Formats the pending samples into s.text
+////////////////////////////////////////////////////////////////////////////
+static void flushStream(StreamOutput &s) {
+  if (s.inertial16.empty() && s.delta16.empty() && s.inertial32.empty() && s.delta32.empty())
+    return;
+  size_t n = 0;
+  switch (s.type)
+  {
+    case STREAM_INERTIAL16:
+      n = s.inertial16.size();
+      formatFrames(s.inertial16.data(), n, s.index, s.binary, s.text);
+      s.inertial16.clear();
+      break;
+    case STREAM_DELTA16:
+      n = s.delta16.size();
+      formatBatch(s.delta16.data(), n, s.index, s.binary, s.text, adis16470ScaleDeltaFrames);
+      s.delta16.clear();
+      break;
+    case STREAM_INERTIAL32:
+      n = s.inertial32.size();
+      formatBatch(s.inertial32.data(), n, s.index, s.binary, s.text, adis16470ScaleFrames32);
+      s.inertial32.clear();
+      break;
+    default:
+      n = s.delta32.size();
+      formatBatch(s.delta32.data(), n, s.index, s.binary, s.text, adis16470ScaleDeltaFrames32);
+      s.delta32.clear();
+      break;
+  }
+  s.index += n;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Appends the decoded frame to v and returns the number pending
+////////////////////////////////////////////////////////////////////////////
+template <typename Frame>
+static size_t collect(std::vector<Frame> &v, const uint32_t *fields) {
+  v.emplace_back();
+  adis16470FieldsToFrame(fields, &v.back());
+  return v.size();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// ADIS16470StreamDecoder handler. Collects one sample for the next batch
+////////////////////////////////////////////////////////////////////////////
+static void streamSample(void *context, uint8_t type, uint16_t sequence, const uint32_t *fields) {
+  (void)sequence;
+  StreamOutput &s = *(StreamOutput *)context;
+  if (type != s.type)
+  {
+    flushStream(s);
+    s.type = type;
+  }
+
+  size_t pending;
+  switch (type)
+  {
+    case STREAM_INERTIAL16:  pending = collect(s.inertial16, fields); break;
+    case STREAM_DELTA16:     pending = collect(s.delta16, fields); break;
+    case STREAM_INERTIAL32:  pending = collect(s.inertial32, fields); break;
+    default:                 pending = collect(s.delta32, fields); break;
+  }
+  if (pending >= STREAM_BATCH)
+    flushStream(s);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decodes a stream-format capture
+////////////////////////////////////////////////////////////////////////////
+static void decodeStream(const uint8_t *data, uint64_t size, const Options &opts, FILE *out) {
+
+  StreamOutput s;
+  s.binary = opts.binary;
+  ADIS16470StreamDecoder decoder(streamSample, &s);
+  const uint64_t block = 1 << 20;
+
+  for (uint64_t pos = 0; pos < size; pos += block)
+  {
+    decoder.feed(data + pos, (size - pos < block) ? size - pos : block);
+    fwrite(s.text.data(), 1, s.text.size(), out);
+    s.text.clear();
+  }
+  flushStream(s);
+  fwrite(s.text.data(), 1, s.text.size(), out);
+
+  const ADIS16470StreamStats &st = decoder.stats();
+  fprintf(stderr, "packets %u, samples %u, crc errors %u, format errors %u, skipped bytes %u, lost samples %u\n",
+          st.packets, st.samples, st.crcErrors, st.formatErrors, st.bytesSkipped, st.samplesLost);
+}
+
+// Replay bus: each burst clocks out the two command bytes, then the captured words
+static ADIS16470RecordingBus replayBus;
+static uint8_t replayReply[2 + 2 * BURST32_WORDS];
+
+// Samples of the 32-bit types. The driver queue holds 16-bit frames only, so 
+// these are read with burst32()/deltaBurst32() into a ring of their own
+#define REPLAY_QUEUE32  256
+
+static_assert(sizeof(ADIS16470DeltaFrame32) == sizeof(ADIS16470Frame32), "32-bit frames share the replay ring");
+
+// Replay state shared by the producer (the data ready ISR) and the consumer (loop())
+struct Replay {
+  ADIS16470 *imu;
+  ADIS16470Ring<ADIS16470Frame32, REPLAY_QUEUE32> queue32;
+  std::atomic<uint8_t> type{ STREAM_INERTIAL16 }; // Type of the frames being queued
+  std::atomic<uint64_t> queued{ 0 };    // Frames accepted into either queue
+  std::atomic<uint64_t> consumed{ 0 };  // Frames formatted by the consumer
+  std::atomic<bool> done{ false };
+  std::chrono::steady_clock::time_point start;
+  double period = 0;                    // Seconds per sample, 0 for unpaced replay
+  uint64_t bursts = 0;                  // Bursts replayed
+};
+
+////////////////////////////////////////////////////////////////////////////
+// Producer side of a replay: serves words (big-endian bytes of a burst of
+// the given type) on the replay bus and reads them back the way the data 
+// ready ISR would, so the driver checks the checksum, decodes DIAG_STAT 
+// and tracks TIME_STAMP through its integrity engine. Paced replay drops 
+// samples on overrun like the ISR; unpaced replay waits for the consumer.
+// A change of type waits until every earlier frame has been formatted.
+////////////////////////////////////////////////////////////////////////////
+static void replayBurst(Replay &r, uint8_t type, const uint8_t *bytes) {
+  bool wide = (type == STREAM_INERTIAL32 || type == STREAM_DELTA32);
+  if (type != r.type)
+  {
+    while (r.consumed < r.queued)
+      std::this_thread::yield();
+    r.type = type;
+  }
+
+  if (r.period > 0)
+    std::this_thread::sleep_until(r.start + std::chrono::duration<double>(r.period * r.bursts));
+  else if (wide)
+    while (r.queue32.available() >= r.queue32.capacity())
+      std::this_thread::yield();
+  else
+    while (r.imu->framesAvailable() >= ADIS16470_QUEUE_DEPTH)
+      std::this_thread::yield();
+  r.bursts++;
+
+  int words = wide ? BURST32_WORDS : BURST_WORDS;
+  memcpy(replayReply + 2, bytes, 2 * words);
+  replayBus.reply = replayReply;
+  replayBus.replyLength = 2 + 2 * words;
+
+  if (!wide)
+  {
+    if (!(r.imu->queueBurst() & (BURST_BAD_CHECKSUM | BURST_OVERRUN)))
+      r.queued++;
+    return;
+  }
+
+  ADIS16470Frame32 frame;
+  uint8_t status;
+  if (type == STREAM_DELTA32)
+  {
+    ADIS16470DeltaFrame32 delta;
+    status = r.imu->deltaBurst32(&delta);
+    memcpy(&frame, &delta, sizeof(frame));
+  }
+  else
+    status = r.imu->burst32(&frame);
+  if (!(status & BURST_BAD_CHECKSUM) && r.queue32.push(frame))
+    r.queued++;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Consumer side of a replay: drains both queues in batches and formats 
+// them as loop() would on the target, until the producer is done
+////////////////////////////////////////////////////////////////////////////
+static uint64_t replayConsume(Replay &r, const Options &opts, FILE *out) {
+  ADIS16470Frame batch[64];
+  ADIS16470Frame32 batch32[64];
+  std::string text;
+  uint64_t index = 0;
+  while (true)
+  {
+    bool finished = r.done; // Read before draining so no frame is missed
+    size_t n = r.imu->readFrames(batch, 64);
+    if (n > 0)
+    {
+      if (r.type == STREAM_DELTA16) // Read after the frames, so it is their type
+      {
+        ADIS16470DeltaFrame delta[64];
+        for (size_t i = 0; i < n; i++)
+        {
+          delta[i].diagStat = batch[i].diagStat;
+          for (int j = 0; j < 3; j++)
+          {
+            delta[i].deltAng[j] = batch[i].gyro[j];
+            delta[i].deltVel[j] = batch[i].accl[j];
+          }
+          delta[i].temp = batch[i].temp;
+          delta[i].timeStamp = batch[i].timeStamp;
+          delta[i].checksum = batch[i].checksum;
+        }
+        formatBatch(delta, n, index, opts.binary, text, adis16470ScaleDeltaFrames);
+      }
+      else
+        formatFrames(batch, n, index, opts.binary, text);
+    }
+    else if ((n = r.queue32.popBatch(batch32, 64)) > 0)
+    {
+      if (r.type == STREAM_DELTA32)
+      {
+        ADIS16470DeltaFrame32 delta[64];
+        memcpy(delta, batch32, n * sizeof(delta[0]));
+        formatBatch(delta, n, index, opts.binary, text, adis16470ScaleDeltaFrames32);
+      }
+      else
+        formatBatch(batch32, n, index, opts.binary, text, adis16470ScaleFrames32);
+    }
+    if (n > 0)
+    {
+      index += n;
+      r.consumed += n;
+      fwrite(text.data(), 1, text.size(), out);
+      text.clear();
+    }
+    else if (finished)
+      break;
+    else
+      std::this_thread::yield();
+  }
+  return index;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Replays a capture through the driver at opts.odr * opts.replayRate Hz 
+// (as fast as the consumer allows with a rate of 0). A producer thread 
+// runs feed, which hands every burst to replayBurst(), while this thread 
+// drains the frames with readFrames(). Prints the driver's integrity 
+// counters at the end.
+////////////////////////////////////////////////////////////////////////////
+template <typename Feed>
+static void replay(const Options &opts, FILE *out, Feed feed) {
+
+  static Replay r;
+  ADIS16470 imu(10, 2, 6, replayBus);
+  imu.setTimeStampStep(opts.step);
+  r.imu = &imu;
+  r.period = (opts.replayRate > 0) ? 1.0 / (opts.odr * opts.replayRate) : 0;
+  r.start = std::chrono::steady_clock::now();
+
+  std::thread producer([&]() {
+    feed(r);
+    r.done = true;
+  });
+  uint64_t delivered = replayConsume(r, opts, out);
+  producer.join();
+
+  ADIS16470IntegrityStats s = imu.integrityStats();
+  fprintf(stderr, "replay: delivered %llu, bursts %u, bad checksums %u, gaps %u (%u samples), duplicates %u, "
+                  "diag errors %u, overruns %u, queue high water %u\n",
+          (unsigned long long)delivered, s.bursts, s.badChecksum, s.gaps, s.samplesMissed, s.duplicates,
+          s.diagErrors, s.overruns + r.queue32.overruns(), imu.queueHighWater());
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Replays a legacy capture. Delimiters followed by a bad checksum are 
+// replayed too, so the driver sees every burst the capture holds.
+////////////////////////////////////////////////////////////////////////////
+static Counters replayLegacy(const uint8_t *data, uint64_t size, const Options &opts, FILE *out) {
+  Counters counters;
+  replay(opts, out, [&](Replay &r) {
+    walkLegacy(data, size, 0, size, counters,
+      [&](uint64_t, const uint8_t *p) { replayBurst(r, STREAM_INERTIAL16, p); },
+      [&](uint64_t pos) {
+        const uint8_t *p = data + pos;
+        if (pos + LEGACY_FRAME <= size && p[0] == LEGACY_DELIMITER && p[1] == LEGACY_DELIMITER &&
+            p[2] == LEGACY_DELIMITER && !legacyChecksumOk(p + 3))
+          replayBurst(r, STREAM_INERTIAL16, p + 3);
+      });
+  });
+  return counters;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// ADIS16470StreamDecoder handler for replay. Rebuilds the burst words of 
+// one sample (32-bit outputs as LOW then OUT words) and replays them
+////////////////////////////////////////////////////////////////////////////
+static void replaySample(void *context, uint8_t type, uint16_t sequence, const uint32_t *fields) {
+  (void)sequence;
+  bool wide = (type == STREAM_INERTIAL32 || type == STREAM_DELTA32);
+  uint16_t words[BURST32_WORDS];
+  int n = 0;
+  words[n++] = (uint16_t)fields[0];
+  for (int i = 1; i <= 6; i++)
+  {
+    words[n++] = (uint16_t)fields[i];
+    if (wide)
+      words[n++] = (uint16_t)(fields[i] >> 16);
+  }
+  for (int i = 7; i < STREAM_FIELDS; i++)
+    words[n++] = (uint16_t)fields[i];
+
+  uint8_t bytes[2 * BURST32_WORDS];
+  for (int i = 0; i < n; i++)
+  {
+    bytes[2 * i] = words[i] >> 8;
+    bytes[2 * i + 1] = words[i] & 0xFF;
+  }
+  replayBurst(*(Replay *)context, type, bytes);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Replays a stream-format capture. Every decoded sample is rebuilt as the
+// burst it came from and replayed; packets lost to CRC errors show up as 
+// TIME_STAMP gaps.
+////////////////////////////////////////////////////////////////////////////
+static void replayStream(const uint8_t *data, uint64_t size, const Options &opts, FILE *out) {
+  ADIS16470StreamStats st = {};
+  replay(opts, out, [&](Replay &r) {
+    ADIS16470StreamDecoder decoder(replaySample, &r);
+    decoder.feed(data, size);
+    st = decoder.stats();
+  });
+  fprintf(stderr, "packets %u, samples %u, crc errors %u, format errors %u, skipped bytes %u, lost samples %u\n",
+          st.packets, st.samples, st.crcErrors, st.formatErrors, st.bytesSkipped, st.samplesLost);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Prints usage and exits
+////////////////////////////////////////////////////////////////////////////
+static void usage(void) {
+  fprintf(stderr, "usage: adis16470_decode [-f legacy|stream] [-o csv|bin] [-w file] [-j threads] "
+                  "[-r rate] [-d odr] [-s step] capture\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+
+  Options opts;
+  int c;
+  while ((c = getopt(argc, argv, "f:o:w:j:r:d:s:")) != -1)
+  {
+    switch (c)
+    {
+      case 'f': opts.stream = !strcmp(optarg, "stream"); break;
+      case 'o': opts.binary = !strcmp(optarg, "bin"); break;
+      case 'w': opts.output = optarg; break;
+      case 'j': opts.threads = atoi(optarg); break;
+      case 'r': opts.replayRate = atof(optarg); break;
+      case 'd': opts.odr = atof(optarg); break;
+      case 's': opts.step = (uint16_t)atoi(optarg); break;
+      default: usage();
+    }
+  }
+  if (optind != argc - 1 || opts.threads < 1 || opts.odr <= 0)
+    usage();
+  opts.input = argv[optind];
+
+  // Map the whole capture
+  int fd = open(opts.input, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0)
+  {
+    perror(opts.input);
+    return 1;
+  }
+  uint64_t size = st.st_size;
+  const uint8_t *data = (const uint8_t *)"";
+  if (size > 0)
+  {
+    void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+    {
+      perror("mmap");
+      return 1;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+    data = (const uint8_t *)map;
+  }
+
+  FILE *out = opts.output ? fopen(opts.output, "wb") : stdout;
+  if (out == nullptr)
+  {
+    perror(opts.output);
+    return 1;
+  }
+  static char outBuffer[1 << 20];
+  setvbuf(out, outBuffer, _IOFBF, sizeof(outBuffer));
+  if (!opts.binary)
+    fputs(csvHeader, out);
+
+  auto start = std::chrono::steady_clock::now();
+  if (opts.stream)
+  {
+    if (opts.replayRate >= 0)
+      replayStream(data, size, opts, out);
+    else
+      decodeStream(data, size, opts, out);
+  }
+  else
+  {
+    Counters total = (opts.replayRate >= 0) ? replayLegacy(data, size, opts, out)
+                                            : decodeLegacy(data, size, opts, out);
+    fprintf(stderr, "frames %llu, bad checksums %llu, skipped bytes %llu\n",
+            (unsigned long long)total.frames, (unsigned long long)total.badChecksum,
+            (unsigned long long)total.skipped);
+  }
+  fflush(out);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  fprintf(stderr, "%.1f MB in %.3f s (%.1f MB/s)\n", size / 1e6, seconds, size / 1e6 / seconds);
+
+  if (out != stdout)
+    fclose(out);
+  return 0;
+}
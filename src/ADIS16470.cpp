@@ -32,26 +32,37 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "ADIS16470.h"
+#include "ADIS16470_Irq.h"
+
+// Writable configuration registers mirrored in the shadow cache
+static const uint8_t shadowRegs[SHADOW_REGS] = {
+  XG_BIAS_LOW, XG_BIAS_HIGH, YG_BIAS_LOW, YG_BIAS_HIGH, ZG_BIAS_LOW, ZG_BIAS_HIGH,
+  XA_BIAS_LOW, XA_BIAS_HIGH, YA_BIAS_LOW, YA_BIAS_HIGH, ZA_BIAS_LOW, ZA_BIAS_HIGH,
+  FILT_CTRL, MSC_CTRL, UP_SCALE, DEC_RATE, NULL_CFG, USER_SCR1, USER_SCR2, USER_SCR3
+};
+
+// Burst command followed by zeros to clock out the burst data
+static const uint8_t burstCommand[BURST_WORDS * 2 + 2] = { 0x68, 0x00 };
 
 ////////////////////////////////////////////////////////////////////////////
-// Constructor with configurable CS, DR, and RST
+// Constructor with configurable CS, DR, RST and SPI bus
 ////////////////////////////////////////////////////////////////////////////
 // CS - Chip select pin
 // DR - DR output pin for data ready
 // RST - Hardware reset pin
+// spi - SPI bus the sensor is connected to (SPI, SPI1, ... or a simulator)
 ////////////////////////////////////////////////////////////////////////////
-ADIS16470::ADIS16470(int CS, int DR, int RST) {
+ADIS16470::ADIS16470(int CS, int DR, int RST, ADIS16470Transport::Bus &spi) : _transport(spi) {
   _CS = CS;
   _DR = DR;
   _RST = RST;
-  // Initialize SPI
-  SPI.begin();
-  // Set default pin states
-  pinMode(_CS, OUTPUT); // Set CS pin to be an output
-  pinMode(_DR, INPUT); // Set DR pin to be an input
-  pinMode(_RST, OUTPUT); // Set RST pin to be an output
-  digitalWrite(_CS, HIGH); // Initialize CS pin to be high
-  digitalWrite(_RST, HIGH); // Initialize RST pin to be high
+  // Initialize SPI and set default pin states (CS and RST high, DR input)
+  _transport.begin(_CS, _DR, _RST);
+  configSPI(); // Default clocks: datasheet maximum for each kind of access
+#if defined(ADIS16470_TRANSPORT_ASYNC)
+  _burstEvent.setContext(this); // Lets the completion handler find this instance
+  _burstEvent.attachImmediate(burstEventHandler); // Run the handler from the DMA interrupt
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -65,10 +76,37 @@ ADIS16470::~ADIS16470() {
 // Returns 1 when complete.
 ////////////////////////////////////////////////////////////////////////////
 int ADIS16470::resetDUT(uint8_t ms) {
-  digitalWrite(_RST, LOW);
-  delay(ms);
-  digitalWrite(_RST, HIGH);
-  delay(ms);
+  _transport.pinWrite(_RST, false);
+  _transport.delayMs(ms);
+  _transport.pinWrite(_RST, true);
+  _transport.delayMs(ms);
+  invalidateShadow(); // Registers revert to their flash contents
+  return(1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the SPI clock used for register reads, register writes and burst 
+// reads. The transport settings are built once here instead of on every
+// transaction, and the stall after each frame is derived from the clock 
+// so that both tSTALL and tREADRATE are met (see ADIS16470_Timing.h).
+// The datasheet allows up to SCLK_MAX_HZ for register access and 
+// SCLK_BURST_MAX_HZ for bursts; faster clocks return corrupt data, so 
+// they are rejected and the previous settings are kept.
+// Returns 1 when complete, or -1 if a clock is 0 or above its limit.
+////////////////////////////////////////////////////////////////////////////
+// regReadHz - SCLK for regRead() and regReadMany()
+// regWriteHz - SCLK for regWrite()
+// burstHz - SCLK for burst reads
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::configSPI(uint32_t regReadHz, uint32_t regWriteHz, uint32_t burstHz) {
+  if (regReadHz == 0 || regReadHz > SCLK_MAX_HZ || regWriteHz == 0 || regWriteHz > SCLK_MAX_HZ ||
+      burstHz == 0 || burstHz > SCLK_BURST_MAX_HZ)
+    return(-1);
+  _regReadSettings = ADIS16470Transport::settings(regReadHz);
+  _regWriteSettings = ADIS16470Transport::settings(regWriteHz);
+  _burstSettings = ADIS16470Transport::settings(burstHz);
+  _regReadStall = adis16470StallUs(regReadHz);
+  _regWriteStall = adis16470StallUs(regWriteHz);
   return(1);
 }
 
@@ -81,12 +119,28 @@ int ADIS16470::resetDUT(uint8_t ms) {
 // Returns 1 when complete.
 ////////////////////////////////////////////////////////////////////////////
 int ADIS16470::select() {
-  SPISettings IMUSettings(1000000, MSBFIRST, SPI_MODE3);
-  SPI.beginTransaction(IMUSettings);
-  digitalWrite(_CS, LOW); // Set CS low to enable device
+  select(_regReadSettings);
   return (1);
 }
 
+////////////////////////////////////////////////////////////////////////////
+// Begins an SPI transaction with cached settings and sets chip select LOW.
+// Bursts skip the stall afterwards (the next one is a data ready period
+// away), so a register frame straight after a burst waits tSTALL here.
+////////////////////////////////////////////////////////////////////////////
+// settings - one of the settings built by configSPI()
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470::select(const ADIS16470Transport::Settings &settings) {
+  ADIS16470_PROFILE_SCOPE(PROF_SELECT);
+  if (_burstStall && &settings != &_burstSettings)
+  {
+    _transport.delayUs(STALL_MIN_US);
+    _burstStall = false;
+  }
+  _transport.beginTransaction(settings);
+  _transport.pinWrite(_CS, false); // Set CS low to enable device
+}
+
 ////////////////////////////////////////////////////////////////////////////
 // Deselects the ADIS16470 for read/write operations.
 // Frees up the SPi bus for other devices.
@@ -94,8 +148,8 @@ int ADIS16470::select() {
 // Returns 1 when complete.
 ////////////////////////////////////////////////////////////////////////////
 int ADIS16470::deselect() {
-  SPI.endTransaction();
-  digitalWrite(_CS, HIGH); // Set CS high to disable device
+  _transport.endTransaction();
+  _transport.pinWrite(_CS, true); // Set CS high to disable device
   return (1);
 }
 
@@ -106,23 +160,24 @@ int ADIS16470::deselect() {
 // regAddr - address of register to be read
 ////////////////////////////////////////////////////////////////////////////////////////////
 int16_t ADIS16470::regRead(uint8_t regAddr) {
+  ADIS16470_PROFILE_SCOPE(PROF_REG_READ);
 //Read registers using SPI
   
   // Write register address to be read
-  select();              // select the device
-  SPI.transfer(regAddr); // Write address over SPI bus
-  SPI.transfer(0x00); // Write 0x00 to the SPI bus fill the 16 bit transaction requirement
+  select(_regReadSettings); // select the device
+  _transport.transfer(regAddr); // Write address over SPI bus
+  _transport.transfer(0x00); // Write 0x00 to the SPI bus fill the 16 bit transaction requirement
   deselect();            // deselect the device
 
-  delayMicroseconds(_stall); // Delay to not violate read rate 
+  _transport.delayUs(_regReadStall); // Delay to not violate read rate 
 
   // Read data from requested register
-  select();              // select the device
-  uint8_t _msbData = SPI.transfer(0x00); // Send (0x00) and place upper byte into variable
-  uint8_t _lsbData = SPI.transfer(0x00); // Send (0x00) and place lower byte into variable
+  select(_regReadSettings); // select the device
+  uint8_t _msbData = _transport.transfer(0x00); // Send (0x00) and place upper byte into variable
+  uint8_t _lsbData = _transport.transfer(0x00); // Send (0x00) and place lower byte into variable
   deselect();            // deselect the device
 
-  delayMicroseconds(_stall); // Delay to not violate read rate 
+  _transport.delayUs(_regReadStall); // Delay to not violate read rate 
   
   int16_t _dataOut = (_msbData << 8) | (_lsbData & 0xFF); // Concatenate upper and lower bytes
   // Shift MSB data left by 8 bits, mask LSB data with 0xFF, and OR both bits.
@@ -130,8 +185,79 @@ int16_t ADIS16470::regRead(uint8_t regAddr) {
   return(_dataOut);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////
+// Reads several registers using pipelined SPI frames. The ADIS16470 returns
+// the data for the address sent in the previous frame, so each frame sends
+// the next address while clocking out the previous result. Reading n
+// registers takes n+1 frames instead of 2n.
+// Returns the number of registers read.
+////////////////////////////////////////////////////////////////////////////////////////////
+// regAddrs - array of register addresses to be read
+// regData - array receiving the (int) signed 16 bit register contents
+// count - number of registers to read
+////////////////////////////////////////////////////////////////////////////////////////////
+int ADIS16470::regReadMany(const uint8_t *regAddrs, int16_t *regData, size_t count) {
+
+  ADIS16470_PROFILE_SCOPE(PROF_REG_READ);
+
+  if (count == 0)
+    return(0); // No frames, not even the trailing one
+
+  for (size_t i = 0; i <= count; i++)
+  {
+    // Send the next address (or 0x00 on the final frame) and collect the previous result
+    uint8_t _addr = (i < count) ? (regAddrs[i] & 0x7F) : 0x00; // Clear the write bit
+    select(_regReadSettings); // select the device
+    uint8_t _msbData = _transport.transfer(_addr); // Write address, place upper byte into variable
+    uint8_t _lsbData = _transport.transfer(0x00); // Send (0x00) and place lower byte into variable
+    deselect();            // deselect the device
+
+    _transport.delayUs(_regReadStall); // Delay to not violate read rate 
+
+    if (i > 0) // The first reply belongs to a previous transaction
+      regData[i - 1] = (_msbData << 8) | (_lsbData & 0xFF); // Concatenate upper and lower bytes
+  }
+
+  return(count);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Reads a 32-bit output using the LOW and OUT register pair (e.g. X_DELTANG_LOW 
+// and X_DELTANG_OUT) in three pipelined frames.
+// Returns an (int32_t) signed 32 bit 2's complement number
+////////////////////////////////////////////////////////////////////////////////////////////
+// regAddrLow - address of the lower word. The upper word is read from regAddrLow + 2
+////////////////////////////////////////////////////////////////////////////////////////////
+int32_t ADIS16470::regRead32(uint8_t regAddrLow) {
+
+  uint8_t _addrs[2] = { regAddrLow, (uint8_t)(regAddrLow + 2) };
+  int16_t _words[2];
+  regReadMany(_addrs, _words, 2);
+
+  // Upper word carries the sign, lower word is unsigned
+  int32_t _dataOut = (int32_t)(((uint32_t)(uint16_t)_words[1] << 16) | (uint16_t)_words[0]);
+
+  return(_dataOut);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Writes one byte to the specified register using a single 16-bit frame.
 ////////////////////////////////////////////////////////////////////////////
-// Writes one byte of data to the specified register over SPI.
+// regAddr - address of the byte to be written
+// regByte - data to be written
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470::writeByte(uint8_t regAddr, uint8_t regByte) {
+
+  select(_regWriteSettings); // select the device
+  _transport.transfer((regAddr & 0x7F) | 0x80); // Write address with the write bit set
+  _transport.transfer(regByte); // Write data byte
+  deselect();            // deselect the device
+
+  _transport.delayUs(_regWriteStall); // Delay to not violate read rate 
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Writes one word of data to the specified register over SPI.
 // Returns 1 when complete.
 ////////////////////////////////////////////////////////////////////////////
 // regAddr - address of register to be written
@@ -139,36 +265,147 @@ int16_t ADIS16470::regRead(uint8_t regAddr) {
 ////////////////////////////////////////////////////////////////////////////
 int ADIS16470::regWrite(uint8_t regAddr, int16_t regData) {
 
-  // Write register address and data
-  uint16_t addr = (((regAddr & 0x7F) | 0x80) << 8); // Toggle sign bit, and check that the address is 8 bits
-  uint16_t lowWord = (addr | (regData & 0xFF)); // OR Register address (A) with data(D) (AADD)
-  uint16_t highWord = ((addr | 0x100) | ((regData >> 8) & 0xFF)); // OR Register address with data and increment address
-
-  // Split words into chars
-  uint8_t highBytehighWord = (highWord >> 8);
-  uint8_t lowBytehighWord = (highWord & 0xFF);
-  uint8_t highBytelowWord = (lowWord >> 8);
-  uint8_t lowBytelowWord = (lowWord & 0xFF);
-
-  // Write highWord to SPI bus
-  select();              // select the device
-  SPI.transfer(highBytelowWord); // Write high byte from low word to SPI bus
-  SPI.transfer(lowBytelowWord); // Write low byte from low word to SPI bus
-  deselect();            // deselect the device
+  ADIS16470_PROFILE_SCOPE(PROF_REG_WRITE);
 
-  delayMicroseconds(_stall);; // Delay to not violate read rate 
+  writeByte(regAddr, regData & 0xFF); // Write lower byte
+  writeByte(regAddr + 1, (regData >> 8) & 0xFF); // Write upper byte to the next address
 
-  // Write lowWord to SPI bus
-  select();              // select the device
-  SPI.transfer(highBytehighWord); // Write high byte from high word to SPI bus
-  SPI.transfer(lowBytehighWord); // Write low byte from high word to SPI bus
-  deselect();            // deselect the device
+  // Keep the shadow cache in step with the device
+  int _slot = shadowIndex(regAddr);
+  if (_slot >= 0)
+  {
+    _shadow[_slot] = regData;
+    _shadowValid |= (1UL << _slot);
+  }
+  else if (regAddr == GLOB_CMD)
+    invalidateShadow(); // Global commands may reload or reset registers
+
+  return(1);
+}
 
-  delayMicroseconds(_stall);; // Delay to not violate read rate 
+////////////////////////////////////////////////////////////////////////////
+// Returns the shadow cache slot of a writable register, or -1 if the 
+// register is not cached.
+////////////////////////////////////////////////////////////////////////////
+// regAddr - register address
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::shadowIndex(uint8_t regAddr) {
+  for (int i = 0; i < SHADOW_REGS; i++)
+    if (shadowRegs[i] == regAddr)
+      return i;
+  return -1;
+}
 
+////////////////////////////////////////////////////////////////////////////
+// Returns the cached contents of a writable configuration register, 
+// reading it from the device first if the cache entry is unknown. 
+// Registers outside the cache are always read.
+////////////////////////////////////////////////////////////////////////////
+// regAddr - register address
+////////////////////////////////////////////////////////////////////////////
+int16_t ADIS16470::shadowRead(uint8_t regAddr) {
+  int _slot = shadowIndex(regAddr);
+  if (_slot < 0)
+    return regRead(regAddr);
+  if (!(_shadowValid & (1UL << _slot)))
+  {
+    _shadow[_slot] = regRead(regAddr); // Fetch the current contents once
+    _shadowValid |= (1UL << _slot);
+  }
+  return _shadow[_slot];
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Marks every shadow cache entry as unknown. The next applyConfig() will 
+// read the registers back before writing.
+// Returns 1 when complete.
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::invalidateShadow(void) {
+  _shadowValid = 0;
   return(1);
 }
 
+////////////////////////////////////////////////////////////////////////////
+// Applies a configuration profile. Registers missing from the shadow cache
+// are read back first in a single pipelined batch, then only the bytes 
+// that differ from the cached contents are written (one frame per byte).
+// With verify set, the profile registers are read back afterwards.
+// Returns the number of bytes written, or -1 if the profile is invalid or
+// verification failed.
+////////////////////////////////////////////////////////////////////////////
+// profile - array of register address/value pairs (writable registers only)
+// count - number of entries in profile, at most SHADOW_REGS
+// verify - read the registers back and compare when true
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::applyConfig(const ADIS16470RegValue *profile, size_t count, bool verify) {
+
+  uint8_t _addrs[SHADOW_REGS];
+  int16_t _data[SHADOW_REGS];
+  size_t _n = 0;
+  if (count > SHADOW_REGS)
+    return(-1); // Larger than the readback batches
+
+  // Collect profile registers that are not cached yet
+  for (size_t i = 0; i < count; i++)
+  {
+    int _slot = shadowIndex(profile[i].regAddr);
+    if (_slot < 0)
+      return(-1); // Not a writable configuration register
+    if (!(_shadowValid & (1UL << _slot)))
+      _addrs[_n++] = profile[i].regAddr;
+  }
+
+  // Fill the cache with one pipelined readback
+  if (_n > 0)
+    regReadMany(_addrs, _data, _n);
+  for (size_t i = 0; i < _n; i++)
+  {
+    int _slot = shadowIndex(_addrs[i]);
+    _shadow[_slot] = _data[i];
+    _shadowValid |= (1UL << _slot);
+  }
+
+  // Write only the bytes that changed
+  int _written = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    int _slot = shadowIndex(profile[i].regAddr);
+    uint16_t _old = _shadow[_slot];
+    uint16_t _new = profile[i].regData;
+    if ((_old ^ _new) & 0x00FF)
+    {
+      writeByte(profile[i].regAddr, _new & 0xFF);
+      _written++;
+    }
+    if ((_old ^ _new) & 0xFF00)
+    {
+      writeByte(profile[i].regAddr + 1, _new >> 8);
+      _written++;
+    }
+    _shadow[_slot] = _new;
+  }
+
+  if (!verify)
+    return(_written);
+
+  // Read everything back in one pipelined batch
+  _n = 0;
+  for (size_t i = 0; i < count; i++)
+    _addrs[_n++] = profile[i].regAddr;
+  if (_n > 0)
+    regReadMany(_addrs, _data, _n);
+  int _result = _written;
+  for (size_t i = 0; i < _n; i++)
+  {
+    int _slot = shadowIndex(_addrs[i]);
+    _shadow[_slot] = _data[i]; // Cache what the device actually holds
+    if (_data[i] != profile[i].regData)
+      _result = -1;
+  }
+
+  return(_result);
+}
+
 ////////////////////////////////////////////////////////////////////////////
 // Intiates a burst read from the sensor.
 // Returns a pointer to an array of sensor data. 
@@ -177,37 +414,36 @@ int ADIS16470::regWrite(uint8_t regAddr, int16_t regData) {
 ////////////////////////////////////////////////////////////////////////////
 uint8_t *ADIS16470::byteBurst(void) {
 
-  static uint8_t burstdata[20];
-
   // Trigger Burst Read
-  select(); // select the device
-  SPI.transfer(0x68);
-  SPI.transfer(0x00);
+  select(_burstSettings); // select the device
+  _transport.transfer(0x68);
+  _transport.transfer(0x00);
 
   // Read Burst Data
-  burstdata[0] = SPI.transfer(0x00); //DIAG_STAT
-  burstdata[1] = SPI.transfer(0x00);
-  burstdata[2] = SPI.transfer(0x00); //XGYRO_OUT
-  burstdata[3] = SPI.transfer(0x00);
-  burstdata[4] = SPI.transfer(0x00); //YGYRO_OUT
-  burstdata[5] = SPI.transfer(0x00);
-  burstdata[6] = SPI.transfer(0x00); //ZGYRO_OUT
-  burstdata[7] = SPI.transfer(0x00);
-  burstdata[8] = SPI.transfer(0x00); //XACCEL_OUT
-  burstdata[9] = SPI.transfer(0x00);
-  burstdata[10] = SPI.transfer(0x00); //YACCEL_OUT
-  burstdata[11] = SPI.transfer(0x00);
-  burstdata[12] = SPI.transfer(0x00); //ZACCEL_OUT
-  burstdata[13] = SPI.transfer(0x00);
-  burstdata[14] = SPI.transfer(0x00); //TEMP_OUT
-  burstdata[15] = SPI.transfer(0x00);
-  burstdata[16] = SPI.transfer(0x00); //TIME_STMP
-  burstdata[17] = SPI.transfer(0x00);
-  burstdata[18] = SPI.transfer(0x00); //CHECKSUM
-  burstdata[19] = SPI.transfer(0x00);
+  _burstBytes[0] = _transport.transfer(0x00); //DIAG_STAT
+  _burstBytes[1] = _transport.transfer(0x00);
+  _burstBytes[2] = _transport.transfer(0x00); //XGYRO_OUT
+  _burstBytes[3] = _transport.transfer(0x00);
+  _burstBytes[4] = _transport.transfer(0x00); //YGYRO_OUT
+  _burstBytes[5] = _transport.transfer(0x00);
+  _burstBytes[6] = _transport.transfer(0x00); //ZGYRO_OUT
+  _burstBytes[7] = _transport.transfer(0x00);
+  _burstBytes[8] = _transport.transfer(0x00); //XACCEL_OUT
+  _burstBytes[9] = _transport.transfer(0x00);
+  _burstBytes[10] = _transport.transfer(0x00); //YACCEL_OUT
+  _burstBytes[11] = _transport.transfer(0x00);
+  _burstBytes[12] = _transport.transfer(0x00); //ZACCEL_OUT
+  _burstBytes[13] = _transport.transfer(0x00);
+  _burstBytes[14] = _transport.transfer(0x00); //TEMP_OUT
+  _burstBytes[15] = _transport.transfer(0x00);
+  _burstBytes[16] = _transport.transfer(0x00); //TIME_STMP
+  _burstBytes[17] = _transport.transfer(0x00);
+  _burstBytes[18] = _transport.transfer(0x00); //CHECKSUM
+  _burstBytes[19] = _transport.transfer(0x00);
   deselect(); // deselect the device
+  _burstStall = true;
 
-  return burstdata;
+  return _burstBytes;
 
 }
 
@@ -219,29 +455,681 @@ uint8_t *ADIS16470::byteBurst(void) {
 ////////////////////////////////////////////////////////////////////////////
 uint16_t *ADIS16470::wordBurst(void) {
 
-  static uint16_t burstwords[10];
+  burstTransfer(_burstWords, BURST_WORDS); // DIAG_STAT, XGYRO..ZACCEL, TEMP_OUT, TIME_STMP, CHECKSUM
+
+  return _burstWords;
+
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sends the burst command and reads count words. The checksum is summed
+// while the bytes arrive so validation needs no second pass.
+// Returns the checksum of every word except the last (the sensor checksum).
+////////////////////////////////////////////////////////////////////////////
+// words - array receiving count words
+// count - BURST_WORDS or BURST32_WORDS
+////////////////////////////////////////////////////////////////////////////
+int16_t ADIS16470::burstTransfer(uint16_t *words, int count) {
+
+  ADIS16470_PROFILE_SCOPE(PROF_BURST);
+  int16_t _sum = 0;
 
   // Trigger Burst Read
-  select(); // select the device
-  SPI.transfer(0x68);
-  SPI.transfer(0x00);
+  select(_burstSettings); // select the device
+  _transport.transfer(0x68);
+  _transport.transfer(0x00);
 
   // Read Burst Data
-  burstwords[0] = ((SPI.transfer(0x00) << 8) | (SPI.transfer(0x00) & 0xFF)); //DIAG_STAT
-  burstwords[1] = ((SPI.transfer(0x00) << 8) | (SPI.transfer(0x00) & 0xFF)); //XGYRO
-  burstwords[2] = ((SPI.transfer(0x00) << 8) | (SPI.transfer(0x00) & 0xFF)); //YGYRO
-  burstwords[3] = ((SPI.transfer(0x00) << 8) | (SPI.transfer(0x00) & 0xFF)); //ZGYRO
-  burstwords[4] = ((SPI.transfer(0x00) << 8) | (SPI.transfer(0x00) & 0xFF)); //XACCEL
-  burstwords[5] = ((SPI.transfer(0x00) << 8) | (SPI.transfer(0x00) & 0xFF)); //YACCEL
-  burstwords[6] = ((SPI.transfer(0x00) << 8) | (SPI.transfer(0x00) & 0xFF)); //ZACCEL
-  burstwords[7] = ((SPI.transfer(0x00) << 8) | (SPI.transfer(0x00) & 0xFF)); //TEMP_OUT
-  burstwords[8] = ((SPI.transfer(0x00) << 8) | (SPI.transfer(0x00) & 0xFF)); //TIME_STMP
-  burstwords[9] = ((SPI.transfer(0x00) << 8) | (SPI.transfer(0x00) & 0xFF)); //CHECKSUM
+  for (int i = 0; i < count; i++)
+  {
+    uint8_t _msbData = _transport.transfer(0x00);
+    uint8_t _lsbData = _transport.transfer(0x00);
+    words[i] = (_msbData << 8) | _lsbData;
+    _sum += _msbData + _lsbData;
+  }
 
   deselect();  // deselect the device
+  _burstStall = true;
+
+  return _sum - (words[count - 1] >> 8) - (words[count - 1] & 0xFF); // Checksum value is not part of the sum!!
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Reads a standard burst, checks the checksum computed during the transfer,
+// decodes DIAG_STAT and tracks TIME_STAMP continuity. Counters are 
+// available from integrityStats().
+// Returns BURST_* status flags (0 for a good sample).
+////////////////////////////////////////////////////////////////////////////
+// frame - decoded output
+////////////////////////////////////////////////////////////////////////////
+uint8_t ADIS16470::validatedBurst(ADIS16470Frame *frame) {
+  uint16_t _words[BURST_WORDS];
+  int16_t _sum = burstTransfer(_words, BURST_WORDS);
+  adis16470DecodeBurst(_words, frame);
+  return _integrity.update(frame->diagStat, frame->timeStamp, _sum == (int16_t)frame->checksum);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the expected TIME_STAMP increment between samples used for gap and
+// duplicate detection. 0 disables the check.
+// Returns 1 when complete.
+////////////////////////////////////////////////////////////////////////////
+// step - expected increment
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::setTimeStampStep(uint16_t step) {
+  _integrity.setTimeStampStep(step);
+  return(1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Returns a copy of the integrity counters. The copy is taken with 
+// interrupts masked so a data ready ISR cannot update them halfway through.
+////////////////////////////////////////////////////////////////////////////
+ADIS16470IntegrityStats ADIS16470::integrityStats(void) const {
+  uint32_t _irq = adis16470IrqSave();
+  ADIS16470IntegrityStats _snapshot = _integrity.stats();
+  adis16470IrqRestore(_irq);
+  return _snapshot;
+}
 
-  return burstwords;
+////////////////////////////////////////////////////////////////////////////
+// Clears the integrity counters.
+// Returns 1 when complete.
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::clearIntegrityStats(void) {
+  _integrity.clear();
+  return(1);
+}
 
+#if defined(ADIS16470_PROFILE) && defined(ARDUINO)
+////////////////////////////////////////////////////////////////////////////
+// Prints a summary of the timing histograms (see ADIS16470_Profile.h).
+// Returns 1 when complete.
+////////////////////////////////////////////////////////////////////////////
+// out - destination, e.g. Serial
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::printProfile(Print &out) {
+  char _text[512];
+  adis16470ProfileFormat(_text, sizeof(_text));
+  out.print(_text);
+  return(1);
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+// Selects the burst contents (gyro/accel or delta angle/delta velocity) and
+// size (16 or 32-bit) by updating the BURST_SEL and BURST32 bits of 
+// MSC_CTRL. Other MSC_CTRL bits are preserved. The register is read back,
+// since a wrong burst layout would otherwise decode as garbage.
+// Returns 1 when complete, or -1 if MSC_CTRL does not read back.
+////////////////////////////////////////////////////////////////////////////
+// mode - BURST_INERTIAL16, BURST_DELTA16, BURST_INERTIAL32 or BURST_DELTA32
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::setBurstMode(uint16_t mode) {
+
+  uint16_t _msc = shadowRead(MSC_CTRL);
+  _msc = (_msc & ~(MSC_BURST_SEL | MSC_BURST32)) | (mode & (MSC_BURST_SEL | MSC_BURST32));
+
+  ADIS16470RegValue _profile = { MSC_CTRL, (int16_t)_msc };
+  // Only the upper byte is written when other bits are unchanged
+  return((applyConfig(&_profile, 1, true) < 0) ? -1 : 1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Startup bias calibration. Reads 32-bit bursts on each data ready edge 
+// (polling the DR pin, so detach any data ready interrupt first) into the
+// estimator until every selected channel meets its standard error target
+// or the sample limit is reached. The corrections are then added to the 
+// current bias registers, and all changed bias words are written and read
+// back in one applyConfig() batch. The burst mode is restored afterwards.
+// Keep the sensor still. Returns 1 when the targets were met, 0 when the 
+// sample limit was reached first (biases are still programmed), or -1 on
+// timeout or readback mismatch.
+////////////////////////////////////////////////////////////////////////////
+// estimator - configured bias estimator; holds the statistics afterwards
+// timeoutMs - overall time limit
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::calibrateBias(ADIS16470BiasEstimator &estimator, uint32_t timeoutMs) {
+
+  uint16_t _msc = shadowRead(MSC_CTRL);
+  bool _activeHigh = _msc & 0x0001; // DR polarity
+
+  if (setBurstMode(BURST_INERTIAL32) < 0) // Full resolution for the means
+    return(-1);
+  estimator.reset();
+
+  ADIS16470Frame32 _frame;
+  uint32_t _start = _transport.millis();
+  bool _first = true;
+  bool _timedOut = false;
+  for (;;)
+  {
+    if (!waitDataReady(_activeHigh, _start, timeoutMs))
+    {
+      _timedOut = true;
+      break;
+    }
+    uint8_t _status = burst32(&_frame);
+    if (_first)
+    {
+      _first = false; // May still hold the previous burst layout
+      continue;
+    }
+    if (!(_status & BURST_BAD_CHECKSUM) && estimator.add(_frame))
+      break;
+  }
+  if (setBurstMode(_msc) < 0 || _timedOut)
+    return(-1);
+
+  // New bias = current bias + correction, for the selected channels
+  int32_t _bias[CAL_CHANNELS];
+  readBiases(_bias);
+  ADIS16470RegValue _profile[2 * CAL_CHANNELS];
+  size_t _n = 0;
+  for (int c = 0; c < CAL_CHANNELS; c++)
+  {
+    if (!(estimator.channels() & (1 << c)))
+      continue;
+    int32_t _new = (int32_t)((uint32_t)_bias[c] + (uint32_t)estimator.correction(c));
+    _profile[_n++] = { (uint8_t)(XG_BIAS_LOW + 4 * c), (int16_t)(_new & 0xFFFF) };
+    _profile[_n++] = { (uint8_t)(XG_BIAS_HIGH + 4 * c), (int16_t)(_new >> 16) };
+  }
+  if (applyConfig(_profile, _n, true) < 0)
+    return(-1);
+
+  return(estimator.converged() ? 1 : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Cross-checks the current bias registers against the sensor's own 
+// auto-null. Writes NULL_CFG, waits two time bases for the continuous 
+// bias estimator to fill, issues the GLOB_CMD bias correction update, 
+// reads back the bias registers and reports each minus the value before.
+// The previous biases and NULL_CFG are then restored and verified. Keep 
+// the sensor still. Returns 1 when complete, or -1 if NULL_CFG cannot be 
+// set or the restore does not verify.
+////////////////////////////////////////////////////////////////////////////
+// difference - six values (X/Y/Z gyro, X/Y/Z accel), 32-bit bias LSB
+// nullCfg - NULL_CFG value (axes and time base)
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::compareAutoNull(int32_t *difference, uint16_t nullCfg) {
+
+  int32_t _before[CAL_CHANNELS];
+  int32_t _after[CAL_CHANNELS];
+  readBiases(_before);
+  int16_t _nullBefore = shadowRead(NULL_CFG);
+
+  ADIS16470RegValue _null = { NULL_CFG, (int16_t)nullCfg };
+  if (applyConfig(&_null, 1, true) < 0)
+  {
+    _null.regData = _nullBefore;
+    applyConfig(&_null, 1);
+    return(-1);
+  }
+  uint32_t _timeBase = (1UL << (nullCfg & 0x000F)) / 2; // ms at 2000 SPS
+  _transport.delayMs(2 * _timeBase + 10);
+
+  regWrite(GLOB_CMD, GLOB_BIAS_UPDATE); // Also invalidates the shadow cache
+  _transport.delayMs(10);
+  readBiases(_after);
+
+  ADIS16470RegValue _profile[2 * CAL_CHANNELS + 1];
+  for (int c = 0; c < CAL_CHANNELS; c++)
+  {
+    difference[c] = (int32_t)((uint32_t)_after[c] - (uint32_t)_before[c]);
+    _profile[2 * c] = { (uint8_t)(XG_BIAS_LOW + 4 * c), (int16_t)(_before[c] & 0xFFFF) };
+    _profile[2 * c + 1] = { (uint8_t)(XG_BIAS_HIGH + 4 * c), (int16_t)(_before[c] >> 16) };
+  }
+  _profile[2 * CAL_CHANNELS] = { NULL_CFG, _nullBefore };
+
+  return((applyConfig(_profile, 2 * CAL_CHANNELS + 1, true) < 0) ? -1 : 1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Reads all six 32-bit bias registers (twelve words) in one pipelined 
+// batch and refreshes their shadow entries.
+////////////////////////////////////////////////////////////////////////////
+// biases - six values (X/Y/Z gyro, X/Y/Z accel)
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::readBiases(int32_t *biases) {
+  uint8_t _addrs[2 * CAL_CHANNELS];
+  int16_t _words[2 * CAL_CHANNELS];
+  for (int i = 0; i < 2 * CAL_CHANNELS; i++)
+    _addrs[i] = XG_BIAS_LOW + 2 * i;
+  regReadMany(_addrs, _words, 2 * CAL_CHANNELS);
+  for (int i = 0; i < 2 * CAL_CHANNELS; i++)
+  {
+    int _slot = shadowIndex(_addrs[i]);
+    _shadow[_slot] = _words[i];
+    _shadowValid |= (1UL << _slot);
+  }
+  for (int c = 0; c < CAL_CHANNELS; c++)
+    biases[c] = adis16470Combine32((uint16_t)_words[2 * c], (uint16_t)_words[2 * c + 1]);
+  return(1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Waits for the DR pin to go inactive and then active again.
+// Returns false if the timeout passes first.
+////////////////////////////////////////////////////////////////////////////
+// activeHigh - DR polarity (MSC_CTRL bit 0)
+// start - transport millis() at the start of the timed operation
+// timeoutMs - time limit from start
+////////////////////////////////////////////////////////////////////////////
+bool ADIS16470::waitDataReady(bool activeHigh, uint32_t start, uint32_t timeoutMs) {
+  while (_transport.pinRead(_DR) == activeHigh)
+    if (_transport.millis() - start > timeoutMs)
+      return false;
+  while (_transport.pinRead(_DR) != activeHigh)
+    if (_transport.millis() - start > timeoutMs)
+      return false;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Intiates a 32-bit burst read from the sensor. MSC_CTRL must have been 
+// set to BURST_INERTIAL32 or BURST_DELTA32 with setBurstMode().
+// Returns a pointer to an array of BURST32_WORDS words.
+////////////////////////////////////////////////////////////////////////////
+// No inputs required.
+////////////////////////////////////////////////////////////////////////////
+uint16_t *ADIS16470::wordBurst32(void) {
+
+  burstTransfer(_burstWords32, BURST32_WORDS); // DIAG_STAT, LOW/OUT pairs, TEMP_OUT, TIME_STMP, CHECKSUM
+
+  return _burstWords32;
+
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Reads a 16-bit delta angle/delta velocity burst (BURST_DELTA16) with the
+// same checksum, DIAG_STAT and TIME_STAMP checks as validatedBurst().
+// Returns BURST_* status flags (0 for a good sample).
+////////////////////////////////////////////////////////////////////////////
+// frame - decoded output
+////////////////////////////////////////////////////////////////////////////
+uint8_t ADIS16470::deltaBurst(ADIS16470DeltaFrame *frame) {
+  uint16_t _words[BURST_WORDS];
+  int16_t _sum = burstTransfer(_words, BURST_WORDS); // Checksum accumulated during the transfer
+  adis16470DecodeDeltaBurst(_words, frame);
+  return _integrity.update(frame->diagStat, frame->timeStamp, _sum == (int16_t)frame->checksum);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Reads a 32-bit gyro/accel burst (BURST_INERTIAL32) with the same checks
+// as validatedBurst().
+// Returns BURST_* status flags (0 for a good sample).
+////////////////////////////////////////////////////////////////////////////
+// frame - decoded output
+////////////////////////////////////////////////////////////////////////////
+uint8_t ADIS16470::burst32(ADIS16470Frame32 *frame) {
+  uint16_t _words[BURST32_WORDS];
+  int16_t _sum = burstTransfer(_words, BURST32_WORDS); // Checksum accumulated during the transfer
+  adis16470DecodeBurst32(_words, frame);
+  return _integrity.update(frame->diagStat, frame->timeStamp, _sum == (int16_t)frame->checksum);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Reads a 32-bit delta angle/delta velocity burst (BURST_DELTA32) with the
+// same checks as validatedBurst().
+// Returns BURST_* status flags (0 for a good sample).
+////////////////////////////////////////////////////////////////////////////
+// frame - decoded output
+////////////////////////////////////////////////////////////////////////////
+uint8_t ADIS16470::deltaBurst32(ADIS16470DeltaFrame32 *frame) {
+  uint16_t _words[BURST32_WORDS];
+  int16_t _sum = burstTransfer(_words, BURST32_WORDS); // Checksum accumulated during the transfer
+  adis16470DecodeDeltaBurst32(_words, frame);
+  return _integrity.update(frame->diagStat, frame->timeStamp, _sum == (int16_t)frame->checksum);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the caller-owned buffers used by beginBurst(). Completed bursts 
+// alternate between the two buffers, so the application may process one 
+// while the next is being filled. Each buffer stays with the application
+// until it is handed back with releaseBurst(). The asynchronous path 
+// decodes the standard 10 word layout only, so MSC_CTRL must select a 
+// 16-bit burst mode (BURST_INERTIAL16 or BURST_DELTA16).
+// Returns 1 when complete, or -1 if a 32-bit burst mode is selected.
+////////////////////////////////////////////////////////////////////////////
+// bufferA - first buffer, BURST_WORDS long
+// bufferB - second buffer, BURST_WORDS long
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::setBurstBuffers(uint16_t *bufferA, uint16_t *bufferB) {
+  if (shadowRead(MSC_CTRL) & MSC_BURST32) // Also primes the cache checked by beginBurst()
+    return(-1);
+  _burstBuffers[0] = bufferA;
+  _burstBuffers[1] = bufferB;
+  _burstIndex = 0;
+  _burstHeld = 0;
+  return(1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Starts a non-blocking burst read. The transfer is handed to the SPI DMA
+// engine when the transport supports it (ADIS16470_TRANSPORT_ASYNC), otherwise it 
+// falls back to a blocking transfer. The callback runs in interrupt context
+// once the data has been decoded into a free ping-pong buffer and checked 
+// like validatedBurst(). When the application still holds both buffers the
+// burst is read and checked but dropped, and counted as an overrun.
+// Returns 1 if the burst was started, 0 if busy or no buffers are set, or
+// -1 if the cached MSC_CTRL selects a 32-bit burst mode.
+////////////////////////////////////////////////////////////////////////////
+// callback - function called with the filled buffer and its BURST_* flags
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::beginBurst(ADIS16470BurstCallback callback) {
+
+  ADIS16470_PROFILE_DATA_READY(_profLatency); // Called at the data ready edge
+
+  if (_burstBusy || _burstBuffers[0] == nullptr || _burstBuffers[1] == nullptr)
+    return(0);
+
+  // Only the cache is checked here, a register read has no place in the ISR
+  int _slot = shadowIndex(MSC_CTRL);
+  if ((_shadowValid & (1UL << _slot)) && (_shadow[_slot] & MSC_BURST32))
+    return(-1);
+
+  _burstBusy = true;
+  _burstCallback = callback;
+
+  select(_burstSettings); // select the device
+#if defined(ADIS16470_TRANSPORT_ASYNC)
+  if (!_transport.transferAsync(burstCommand, _burstRx, sizeof(_burstRx), _burstEvent))
+  {
+    deselect(); // DMA unavailable, release the bus
+    _burstBusy = false;
+    return(0);
+  }
+#else
+  for (size_t i = 0; i < sizeof(_burstRx); i++)
+    _burstRx[i] = _transport.transfer(burstCommand[i]);
+  finishBurst();
+#endif
+
+  return(1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Hands a buffer received by the burst callback back to the driver so it 
+// can be filled again. May be called from the callback itself or from 
+// loop().
+// Returns 1 when complete, or -1 if burstWords is not a burst buffer.
+////////////////////////////////////////////////////////////////////////////
+// burstWords - buffer passed to the callback
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::releaseBurst(uint16_t *burstWords) {
+  uint8_t _bit;
+  if (burstWords == _burstBuffers[0])
+    _bit = 1;
+  else if (burstWords == _burstBuffers[1])
+    _bit = 2;
+  else
+    return(-1);
+
+  uint32_t _irq = adis16470IrqSave(); // finishBurst() updates the same mask
+  _burstHeld &= ~_bit;
+  adis16470IrqRestore(_irq);
+  return(1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Returns true while an asynchronous burst is in progress.
+////////////////////////////////////////////////////////////////////////////
+bool ADIS16470::burstBusy(void) {
+  return _burstBusy;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Completes an asynchronous burst. Deselects the device, decodes the 
+// received bytes into a buffer the application does not hold, runs the 
+// integrity checks and calls the user callback. With both buffers held 
+// the sample is dropped; only valid samples count as overruns, as in 
+// queueBurst(). An attached scheduler is then told the bus is free.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470::finishBurst(void) {
+
+  deselect(); // deselect the device
+  _burstStall = true;
+
+  uint8_t _index = _burstIndex;
+  if (_burstHeld & (1 << _index))
+    _index ^= 1; // Released out of order, the other buffer may be free
+  bool _overrun = (_burstHeld & (1 << _index)) != 0;
+
+  uint16_t _dropped[BURST_WORDS];
+  uint16_t *_words = _overrun ? _dropped : _burstBuffers[_index];
+  for (int i = 0; i < BURST_WORDS; i++) // Skip the two command bytes
+    _words[i] = (_burstRx[2 * i + 2] << 8) | (_burstRx[2 * i + 3] & 0xFF);
+
+  typedef ADIS16470BurstLayout L;
+  int16_t _sum = adis16470Checksum(_words, BURST_WORDS - 1);
+  uint8_t _status = _integrity.update(_words[L::diagStat], _words[L::timeStamp], _sum == (int16_t)_words[L::checksum]);
+  ADIS16470_PROFILE_DATA_DONE(_profLatency);
+
+  if (_overrun)
+  {
+    if (!(_status & BURST_BAD_CHECKSUM))
+      _integrity.countOverrun();
+    _burstBusy = false;
+  }
+  else
+  {
+    _burstHeld |= (1 << _index);
+    _burstIndex = _index ^ 1; // Fill the other buffer next time
+    _burstBusy = false;
+
+    if (_burstCallback)
+      _burstCallback(_words, _status);
+  }
+
+  if (_scheduler != nullptr)
+    _scheduler->complete(_schedulerBus); // Release the bus for the next device
+}
+
+#if defined(ADIS16470_TRANSPORT_ASYNC)
+////////////////////////////////////////////////////////////////////////////
+// SPI DMA completion handler. Runs in interrupt context.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470::burstEventHandler(EventResponderRef event) {
+  ((ADIS16470 *)event.getContext())->finishBurst();
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+// Performs a validated burst read and decodes the result directly into the
+// frame queue. Intended to be the whole data ready ISR; loop() drains the 
+// queue with readFrames(). Samples with a bad checksum are counted and not
+// queued. When the queue is full the burst is still read (to keep the 
+// sensor in step) but the sample is dropped. The integrity engine owns the
+// overrun count, and only valid samples count as dropped; a burst with a
+// bad checksum is reported as BURST_BAD_CHECKSUM alone.
+// Returns BURST_* status flags (0 for a good, queued sample).
+////////////////////////////////////////////////////////////////////////////
+// No inputs required.
+////////////////////////////////////////////////////////////////////////////
+uint8_t ADIS16470::queueBurst(void) {
+
+  ADIS16470_PROFILE_DATA_READY(_profLatency); // Called at the data ready edge
+  ADIS16470_PROFILE_SCOPE(PROF_ISR);
+  uint32_t _edge = (_timeSync != nullptr) ? _timeSync->now() : 0;
+
+  QueuedFrame *_slot = _frameQueue.acquire();
+  if (_slot == nullptr)
+  {
+    ADIS16470Frame _dropped;
+    uint8_t _status = validatedBurst(&_dropped);
+    ADIS16470_PROFILE_DATA_DONE(_profLatency);
+    if (_status & BURST_BAD_CHECKSUM)
+      return(_status); // Would not have been queued anyway
+    _integrity.countOverrun();
+    if (_timeSync != nullptr)
+      _timeSync->update(_edge, _dropped.timeStamp); // Keep tracking
+    return(_status | BURST_OVERRUN);
+  }
+
+  uint8_t _status = validatedBurst(&_slot->frame);
+  ADIS16470_PROFILE_DATA_DONE(_profLatency);
+  if (!(_status & BURST_BAD_CHECKSUM))
+  {
+    _slot->hostTime = (_timeSync != nullptr) ? _timeSync->update(_edge, _slot->frame.timeStamp) : 0;
+    _frameQueue.commit(); // Frame and host time are published together
+  }
+
+  return(_status);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Scheduler service function. Lets several sensors sharing a bus be read 
+// from loop() in data ready order through ADIS16470Scheduler, with the 
+// samples landing in each sensor's own frame queue. The transfer is 
+// blocking, so it always completes before returning and the bus is held 
+// for the whole burst; scheduledBeginBurst() is the DMA alternative.
+////////////////////////////////////////////////////////////////////////////
+// context - the ADIS16470 instance to read
+////////////////////////////////////////////////////////////////////////////
+bool ADIS16470::scheduledBurst(void *context) {
+  ((ADIS16470 *)context)->queueBurst();
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the scheduler and bus used by scheduledBeginBurst(), and the 
+// callback that receives its bursts. Once attached, start bursts only 
+// through the scheduler, since every finished burst completes the bus.
+// Returns 1 when complete.
+////////////////////////////////////////////////////////////////////////////
+// scheduler - scheduler this device was added to, or nullptr to detach
+// bus - bus number passed to addDevice()
+// callback - function called with each filled buffer and its BURST_* flags
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::attachScheduler(ADIS16470Scheduler *scheduler, uint8_t bus, ADIS16470BurstCallback callback) {
+  _scheduler = scheduler;
+  _schedulerBus = bus;
+  _schedulerCallback = callback;
+  return(1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Asynchronous scheduler service function. Starts a beginBurst() and 
+// leaves the bus busy; finishBurst() calls complete() on the attached 
+// scheduler from the DMA completion handler, so poll() can start other 
+// buses in the meantime. Without ADIS16470_TRANSPORT_ASYNC the burst 
+// completes before this returns. If the burst cannot be started the bus
+// is released at once and the sample is lost.
+// Needs setBurstBuffers() and attachScheduler() first.
+////////////////////////////////////////////////////////////////////////////
+// context - the ADIS16470 instance to read
+////////////////////////////////////////////////////////////////////////////
+bool ADIS16470::scheduledBeginBurst(void *context) {
+  ADIS16470 *_imu = (ADIS16470 *)context;
+  if (_imu->_scheduler == nullptr)
+    return true;
+  return (_imu->beginBurst(_imu->_schedulerCallback) != 1); // complete() follows from finishBurst()
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Removes up to maxFrames decoded frames from the queue, oldest first.
+// Returns the number of frames copied.
+////////////////////////////////////////////////////////////////////////////
+// frames - array receiving the frames
+// maxFrames - length of frames
+////////////////////////////////////////////////////////////////////////////
+size_t ADIS16470::readFrames(ADIS16470Frame *frames, size_t maxFrames) {
+  return readFrames(frames, nullptr, maxFrames);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Removes up to maxFrames decoded frames from the queue, oldest first, 
+// with the host time of each frame's data ready edge as estimated by the
+// ADIS16470TimeSync given to setTimeSync(). Times are 0 when no tracking 
+// loop is attached. Returns the number of frames copied.
+////////////////////////////////////////////////////////////////////////////
+// frames - array receiving the frames
+// hostTimes - array receiving the host times (may be nullptr)
+// maxFrames - length of frames and hostTimes
+////////////////////////////////////////////////////////////////////////////
+size_t ADIS16470::readFrames(ADIS16470Frame *frames, uint64_t *hostTimes, size_t maxFrames) {
+  size_t _count = 0;
+  const QueuedFrame *_slot;
+  while (_count < maxFrames && (_slot = _frameQueue.front()) != nullptr)
+  {
+    frames[_count] = _slot->frame;
+    if (hostTimes != nullptr)
+      hostTimes[_count] = _slot->hostTime;
+    _frameQueue.release(); // Free the slot only after both are copied
+    _count++;
+  }
+  return _count;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Attaches a tracking loop which stamps every queued frame with the host 
+// time of its data ready edge. queueBurst() reads the loop's clock on 
+// entry, so call it first in the ISR. Attach before enabling the data 
+// ready interrupt; frames already queued are discarded. Use nullptr to 
+// detach.
+////////////////////////////////////////////////////////////////////////////
+// sync - tracking loop, or nullptr
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::setTimeSync(ADIS16470TimeSync *sync) {
+  while (_frameQueue.front() != nullptr)
+    _frameQueue.release();
+  _timeSync = sync;
+  return(1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Selects the sample clock by updating the sync mode field of MSC_CTRL.
+// In SYNC_SCALED mode the output rate is the SYNC input frequency times
+// UP_SCALE (e.g. 1 Hz PPS and UP_SCALE 2000 for 2000 SPS), which locks 
+// samples to the external clock. Other MSC_CTRL bits are preserved and
+// the written registers are read back.
+// Returns 1 when complete, or -1 if SYNC_SCALED is requested with 
+// upScale 0 or a register does not read back.
+////////////////////////////////////////////////////////////////////////////
+// mode - SYNC_INTERNAL, SYNC_DIRECT, SYNC_SCALED or SYNC_OUTPUT
+// upScale - UP_SCALE value for SYNC_SCALED (ignored otherwise)
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470::setSyncMode(uint16_t mode, uint16_t upScale) {
+
+  if (mode == SYNC_SCALED && upScale == 0)
+    return(-1);
+
+  uint16_t _msc = shadowRead(MSC_CTRL);
+  _msc = (_msc & ~MSC_SYNC_MASK) | (mode & MSC_SYNC_MASK);
+
+  // Scale factor first so the new mode starts at the right rate
+  ADIS16470RegValue _profile[2] = { { UP_SCALE, (int16_t)upScale }, { MSC_CTRL, (int16_t)_msc } };
+  int _written;
+  if (mode == SYNC_SCALED)
+    _written = applyConfig(_profile, 2, true);
+  else
+    _written = applyConfig(&_profile[1], 1, true);
+
+  return((_written < 0) ? -1 : 1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Returns the number of frames waiting in the queue.
+////////////////////////////////////////////////////////////////////////////
+size_t ADIS16470::framesAvailable(void) {
+  return _frameQueue.available();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Returns the number of valid frames dropped because the queue was full.
+// This is the integrity engine's count; the ring's own counter also sees
+// bursts rejected for their checksum and is not reported.
+////////////////////////////////////////////////////////////////////////////
+uint32_t ADIS16470::queueOverruns(void) {
+  return _integrity.stats().overruns; // A single word, no masking needed
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Returns the largest number of frames held in the queue at once.
+////////////////////////////////////////////////////////////////////////////
+uint32_t ADIS16470::queueHighWater(void) {
+  return _frameQueue.highWater();
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -252,14 +1140,33 @@ uint16_t *ADIS16470::wordBurst(void) {
 // return - (int16_t) signed calculated checksum
 ////////////////////////////////////////////////////////////////////////////
 int16_t ADIS16470::checksum(uint16_t * burstArray) {
-  int16_t s = 0;
-  for (int i = 0; i < 9; i++) // Checksum value is not part of the sum!!
-  {
-      s += (burstArray[i] & 0xFF); // Count lower byte
-      s += ((burstArray[i] >> 8) & 0xFF); // Count upper byte
-  }
+  return adis16470Checksum(burstArray, BURST_WORDS - 1); // Checksum value is not part of the sum!!
+}
 
-  return s;
+////////////////////////////////////////////////////////////////////////////
+// Calculates checksum based on 32-bit burst data.
+// Returns the calculated checksum.
+////////////////////////////////////////////////////////////////////////////
+// *burstArray - array of BURST32_WORDS burst words
+// return - (int16_t) signed calculated checksum
+////////////////////////////////////////////////////////////////////////////
+int16_t ADIS16470::checksum32(uint16_t * burstArray) {
+  return adis16470Checksum(burstArray, BURST32_WORDS - 1); // Checksum value is not part of the sum!!
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Calculates checksum of a decoded frame (see readFrames()).
+// Returns the calculated checksum.
+////////////////////////////////////////////////////////////////////////////
+// *frame - decoded burst frame
+// return - (int16_t) signed calculated checksum
+////////////////////////////////////////////////////////////////////////////
+int16_t ADIS16470::checksum(const ADIS16470Frame *frame) {
+  uint16_t words[BURST_WORDS - 1] = { frame->diagStat,
+    (uint16_t)frame->gyro[0], (uint16_t)frame->gyro[1], (uint16_t)frame->gyro[2],
+    (uint16_t)frame->accl[0], (uint16_t)frame->accl[1], (uint16_t)frame->accl[2],
+    (uint16_t)frame->temp, frame->timeStamp };
+  return checksum(words);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -270,7 +1177,7 @@ int16_t ADIS16470::checksum(uint16_t * burstArray) {
 /////////////////////////////////////////////////////////////////////////////////////////
 float ADIS16470::accelScale(int16_t sensorData)
 {
-  float finalData = sensorData * 0.00125; // Multiply by accel sensitivity (0.00125g/LSB)
+  float finalData = sensorData * _sensitivity.accel; // Multiply by accel sensitivity (0.00125g/LSB)
   return finalData;
 }
 
@@ -282,7 +1189,7 @@ float ADIS16470::accelScale(int16_t sensorData)
 /////////////////////////////////////////////////////////////////////////////////////////
 float ADIS16470::gyroScale(int16_t sensorData)
 {
-  float finalData = sensorData * 0.1; // Multiply by gyro sensitivity (0.1 deg/LSB)
+  float finalData = sensorData * _sensitivity.gyro; // Multiply by gyro sensitivity (0.1 deg/LSB)
   return finalData;
 }
 
@@ -294,7 +1201,7 @@ float ADIS16470::gyroScale(int16_t sensorData)
 /////////////////////////////////////////////////////////////////////////////////////////
 float ADIS16470::tempScale(int16_t sensorData)
 {
-  float finalData = (sensorData * 0.1); // Multiply by temperature scale (0.1 deg C/LSB)
+  float finalData = sensorData * _sensitivity.temp; // Multiply by temperature scale (0.1 deg C/LSB)
   return finalData;
 }
 
@@ -306,7 +1213,7 @@ float ADIS16470::tempScale(int16_t sensorData)
 /////////////////////////////////////////////////////////////////////////////////////////
 float ADIS16470::deltaAngleScale(int16_t sensorData)
 {
-  float finalData = sensorData * 0.061; // Multiply by delta angle scale (0.061 degrees/LSB)
+  float finalData = sensorData * _sensitivity.deltaAngle; // Multiply by delta angle scale (0.061 degrees/LSB)
   return finalData;
 }
 
@@ -318,6 +1225,54 @@ float ADIS16470::deltaAngleScale(int16_t sensorData)
 /////////////////////////////////////////////////////////////////////////////////////////
 float ADIS16470::deltaVelocityScale(int16_t sensorData)
 {
-  float finalData = sensorData * 0.01221; // Multiply by velocity scale (0.01221 m/sec/LSB)
+  float finalData = sensorData * _sensitivity.deltaVelocity; // Multiply by velocity scale (0.01221 m/sec/LSB)
+  return finalData;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+// Converts 32-bit accelerometer data (OUT:LOW)
+// Returns (float) signed/scaled accelerometer in g's
+/////////////////////////////////////////////////////////////////////////////////////////
+// sensorData - 32-bit data from burst32() or regRead32()
+/////////////////////////////////////////////////////////////////////////////////////////
+float ADIS16470::accelScale32(int32_t sensorData)
+{
+  float finalData = sensorData * (_sensitivity.accel / 65536.0f); // Multiply by accel sensitivity (0.00125g/2^16 LSB)
+  return finalData;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+// Converts 32-bit gyro data (OUT:LOW)
+// Returns (float) signed/scaled gyro in degrees/sec
+/////////////////////////////////////////////////////////////////////////////////////////
+// sensorData - 32-bit data from burst32() or regRead32()
+/////////////////////////////////////////////////////////////////////////////////////////
+float ADIS16470::gyroScale32(int32_t sensorData)
+{
+  float finalData = sensorData * (_sensitivity.gyro / 65536.0f); // Multiply by gyro sensitivity (0.1 deg/2^16 LSB)
+  return finalData;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+// Converts 32-bit delta angle data (OUT:LOW)
+// Returns (float) signed/scaled delta angle in degrees
+/////////////////////////////////////////////////////////////////////////////////////////
+// sensorData - 32-bit data from deltaBurst32() or regRead32()
+/////////////////////////////////////////////////////////////////////////////////////////
+float ADIS16470::deltaAngleScale32(int32_t sensorData)
+{
+  float finalData = sensorData * (_sensitivity.deltaAngle / 65536.0f); // Multiply by delta angle scale (0.061 degrees/2^16 LSB)
+  return finalData;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+// Converts 32-bit delta velocity data (OUT:LOW)
+// Returns (float) signed/scaled delta velocity in m/sec
+/////////////////////////////////////////////////////////////////////////////////////////
+// sensorData - 32-bit data from deltaBurst32() or regRead32()
+/////////////////////////////////////////////////////////////////////////////////////////
+float ADIS16470::deltaVelocityScale32(int32_t sensorData)
+{
+  float finalData = sensorData * (_sensitivity.deltaVelocity / 65536.0f); // Multiply by velocity scale (0.01221 m/sec/2^16 LSB)
   return finalData;
 }
@@ -7,8 +7,8 @@
 // 
 //  This library provides all the functions necessary to interface the ADIS16470 IMU with a 
 //  PJRC 32-Bit Teensy 3.2 Development Board. Functions for SPI configuration, reads and writes,
-//  and scaling are included. This library may be used for the entire ADIS1646X family of devices 
-//  with some modification.
+//  and scaling are included. Other members of the ADIS1646x/1647x family are supported through
+//  the device traits in ADIS16470_Device.h.
 //
 //  Permission is hereby granted, free of charge, to any person obtaining
 //  a copy of this software and associated documentation files (the
@@ -34,76 +34,69 @@
 #pragma once
 
 #define ADIS16470_h
-#include "Arduino.h"
-#include <SPI.h>
-
-// User Register Memory Map from Table 6
-#define FLASH_CNT   	0x00  //Flash memory write count
-#define DIAG_STAT   	0x02  //Diagnostic and operational status
-#define X_GYRO_LOW  	0x04  //X-axis gyroscope output, lower word
-#define X_GYRO_OUT  	0x06  //X-axis gyroscope output, upper word
-#define Y_GYRO_LOW  	0x08  //Y-axis gyroscope output, lower word
-#define Y_GYRO_OUT  	0x0A  //Y-axis gyroscope output, upper word
-#define Z_GYRO_LOW  	0x0C  //Z-axis gyroscope output, lower word
-#define Z_GYRO_OUT  	0x0E  //Z-axis gyroscope output, upper word
-#define X_ACCL_LOW  	0x10  //X-axis accelerometer output, lower word
-#define X_ACCL_OUT  	0x12  //X-axis accelerometer output, upper word
-#define Y_ACCL_LOW  	0x14  //Y-axis accelerometer output, lower word
-#define Y_ACCL_OUT  	0x16  //Y-axis accelerometer output, upper word
-#define Z_ACCL_LOW  	0x18  //Z-axis accelerometer output, lower word
-#define Z_ACCL_OUT  	0x1A  //Z-axis accelerometer output, upper word
-#define TEMP_OUT    	0x1C  //Temperature output (internal, not calibrated)
-#define TIME_STAMP  	0x1E  //PPS mode time stamp
-#define X_DELTANG_LOW	0x24  //X-axis delta angle output, lower word
-#define X_DELTANG_OUT	0x26  //X-axis delta angle output, upper word
-#define Y_DELTANG_LOW	0x28  //Y-axis delta angle output, lower word
-#define Y_DELTANG_OUT	0x2A  //Y-axis delta angle output, upper word
-#define Z_DELTANG_LOW	0x2C  //Z-axis delta angle output, lower word
-#define Z_DELTANG_OUT	0x2E  //Z-axis delta angle output, upper word
-#define X_DELTVEL_LOW	0x30  //X-axis delta velocity output, lower word
-#define X_DELTVEL_OUT	0x32  //X-axis delta velocity output, upper word
-#define Y_DELTVEL_LOW	0x34  //Y-axis delta velocity output, lower word
-#define Y_DELTVEL_OUT	0x36  //Y-axis delta velocity output, upper word
-#define Z_DELTVEL_LOW	0x38  //Z-axis delta velocity output, lower word
-#define Z_DELTVEL_OUT	0x3A  //Z-axis delta velocity output, upper word
-#define XG_BIAS_LOW		0x40  //X-axis gyroscope bias offset correction, lower word
-#define XG_BIAS_HIGH	0x42  //X-axis gyroscope bias offset correction, upper word
-#define YG_BIAS_LOW		0x44  //Y-axis gyroscope bias offset correction, lower word
-#define YG_BIAS_HIGH	0x46  //Y-axis gyroscope bias offset correction, upper word
-#define ZG_BIAS_LOW		0x48  //Z-axis gyroscope bias offset correction, lower word
-#define ZG_BIAS_HIGH	0x4A  //Z-axis gyroscope bias offset correction, upper word
-#define XA_BIAS_LOW		0x4C  //X-axis accelerometer bias offset correction, lower word
-#define XA_BIAS_HIGH	0x4E  //X-axis accelerometer bias offset correction, upper word
-#define YA_BIAS_LOW		0x50  //Y-axis accelerometer bias offset correction, lower word
-#define YA_BIAS_HIGH	0x52  //Y-axis accelerometer bias offset correction, upper word
-#define ZA_BIAS_LOW		0x54  //Z-axis accelerometer bias offset correction, lower word
-#define ZA_BIAS_HIGH	0x56  //Z-axis accelerometer bias offset correction, upper word
-#define FILT_CTRL    	0x5C  //Filter control
-#define MSC_CTRL    	0x60  //Miscellaneous control
-#define UP_SCALE    	0x62  //Clock scale factor, PPS mode
-#define DEC_RATE    	0x64  //Decimation rate control (output data rate)
-#define NULL_CFG    	0x66  //Auto-null configuration control
-#define GLOB_CMD    	0x68  //Global commands
-#define FIRM_REV    	0x6C  //Firmware revision
-#define FIRM_DM    		0x6E  //Firmware revision date, month and day
-#define FIRM_Y    		0x70  //Firmware revision date, year
-#define PROD_ID    		0x72  //Product identification 
-#define SERIAL_NUM    0x74  //Serial number (relative to assembly lot)
-#define USER_SCR1    	0x76  //User scratch register 1 
-#define USER_SCR2    	0x78  //User scratch register 2 
-#define USER_SCR3    	0x7A  //User scratch register 3 
-#define FLSHCNT_LOW   0x7C  //Flash update count, lower word 
-#define FLSHCNT_HIGH  0x7E  //Flash update count, upper word 
+#include "ADIS16470_Transport.h"
+#include "ADIS16470_Types.h"
+#include "ADIS16470_Device.h"
+#include "ADIS16470_Ring.h"
+#include "ADIS16470_Scale.h"
+#include "ADIS16470_Stream.h"
+#include "ADIS16470_Integrity.h"
+#include "ADIS16470_Profile.h"
+#include "ADIS16470_Timing.h"
+#include "ADIS16470_Scheduler.h"
+#include "ADIS16470_Filter.h"
+#include "ADIS16470_Strapdown.h"
+#include "ADIS16470_TimeSync.h"
+#include "ADIS16470_Calibration.h"
 
+// Number of decoded frames held between the data ready ISR and loop(). Must be a power of two
+#ifndef ADIS16470_QUEUE_DEPTH
+#define ADIS16470_QUEUE_DEPTH 32
+#endif
+
+// MSC_CTRL burst configuration bits
+#define MSC_BURST_SEL 0x0100  //Burst returns delta angle/delta velocity instead of gyro/accel
+#define MSC_BURST32   0x0200  //Burst returns 32-bit (LOW and OUT) outputs
+
+// Burst modes accepted by setBurstMode()
+#define BURST_INERTIAL16  0x0000                        //16-bit gyro/accel (default)
+#define BURST_DELTA16     MSC_BURST_SEL                 //16-bit delta angle/delta velocity
+#define BURST_INERTIAL32  MSC_BURST32                   //32-bit gyro/accel
+#define BURST_DELTA32     (MSC_BURST32 | MSC_BURST_SEL) //32-bit delta angle/delta velocity
+
+// MSC_CTRL sync modes accepted by setSyncMode()
+#define MSC_SYNC_MASK 0x001C  //Sync mode field, bits [4:2]
+#define SYNC_INTERNAL 0x0000  //Internal sample clock (default)
+#define SYNC_DIRECT   0x0004  //Each SYNC pin edge starts a sample
+#define SYNC_SCALED   0x0008  //Sample clock locked to SYNC (e.g. PPS) times UP_SCALE
+#define SYNC_OUTPUT   0x000C  //SYNC pin outputs the internal sample clock
+
+// GLOB_CMD and NULL_CFG settings used by compareAutoNull()
+#define GLOB_BIAS_UPDATE 0x0001  //Load the continuous bias estimate into the bias registers
+#define NULL_CFG_GYROS   0x070A  //Null X/Y/Z gyro, time base 2^10 samples (datasheet default)
+
+// Number of writable configuration registers held in the shadow cache
+#define SHADOW_REGS   20
+
+// Register address/value pair used to describe a configuration profile
+struct ADIS16470RegValue {
+  uint8_t regAddr;
+  int16_t regData;
+};
+
+// Called when an asynchronous burst read completes. burstWords points to the
+// caller-owned buffer that was just filled and status holds its BURST_* 
+// flags. The buffer belongs to the application until releaseBurst().
+typedef void (*ADIS16470BurstCallback)(uint16_t *burstWords, uint8_t status);
 
 // ADIS16470 class definition
 class ADIS16470 {
 
 public:
-  // Constructor with configurable CS, data ready, and HW reset pins
+  // Constructor with configurable CS, data ready, and HW reset pins, and SPI bus (see ADIS16470_Transport.h)
 
   // ADIS16470(int CS, int DR, int RST, int MOSI, int MISO, int CLK);
-  ADIS16470(int CS, int DR, int RST);
+  ADIS16470(int CS, int DR, int RST, ADIS16470Transport::Bus &spi = ADIS16470Transport::defaultBus());
 
   // Destructor
   ~ADIS16470();
@@ -111,6 +104,11 @@ public:
   // Performs hardware reset by sending pin 8 low on the DUT for n milliseconds
   int resetDUT(uint8_t ms);
 
+  // Sets the SPI clock for register reads, register writes and bursts. Stall times follow.
+  // Returns -1 for clocks above SCLK_MAX_HZ (registers) or SCLK_BURST_MAX_HZ (bursts)
+  int configSPI(uint32_t regReadHz = SCLK_MAX_HZ, uint32_t regWriteHz = SCLK_MAX_HZ,
+                uint32_t burstHz = SCLK_BURST_MAX_HZ);
+
   // Sets SPI bit order, clock divider, and data mode and sets CS chip to LOW.
   int select();
 
@@ -120,18 +118,138 @@ public:
   // Read single register from sensor
   int16_t regRead(uint8_t regAddr);
 
+  // Read several registers using pipelined (full-duplex) frames
+  int regReadMany(const uint8_t *regAddrs, int16_t *regData, size_t count);
+
+  // Read a 32-bit LOW/OUT register pair (e.g. X_DELTANG_LOW)
+  int32_t regRead32(uint8_t regAddrLow);
+
   // Write register
   int regWrite(uint8_t regAddr, int16_t regData);
 
+  // Apply a configuration profile of at most SHADOW_REGS entries, writing only bytes that differ from the device
+  int applyConfig(const ADIS16470RegValue *profile, size_t count, bool verify = false);
+
+  // Forget cached register contents (e.g. after a reset or GLOB_CMD)
+  int invalidateShadow(void);
+
+  // Typed register access with descriptors from ADIS16470_Device.h, e.g. read<ADIS16470Traits::ProdId>().
+  // Using a descriptor of the wrong width, or writing a read-only register, does not compile
+  template <class Reg> int16_t read(void) {
+    static_assert(Reg::width == 16, "32-bit register: use read32()");
+    return regRead(Reg::addr);
+  }
+  template <class Reg> int32_t read32(void) {
+    static_assert(Reg::width == 32, "16-bit register: use read()");
+    return regRead32(Reg::addr);
+  }
+  template <class Reg> int write(int16_t value) {
+    static_assert(Reg::writable, "Register is read-only");
+    static_assert(Reg::width == 16, "32-bit register: use write32()");
+    return regWrite(Reg::addr, value);
+  }
+  template <class Reg> int write32(int32_t value) {
+    static_assert(Reg::writable, "Register is read-only");
+    static_assert(Reg::width == 32, "16-bit register: use write()");
+    regWrite(Reg::addr, (int16_t)(value & 0xFFFF));
+    return regWrite(Reg::addr + 2, (int16_t)(value >> 16));
+  }
+
   // Read sensor data using a burst read. Returns bits
   uint8_t *byteBurst(void);
 
   // Read sensor data using a burst read. Returns bytes
   uint16_t *wordBurst(void);
 
+  // Set the two caller-owned ping-pong buffers (BURST_WORDS each) used by beginBurst(). 16-bit burst modes only
+  int setBurstBuffers(uint16_t *bufferA, uint16_t *bufferB);
+
+  // Start a non-blocking burst read. Call from the data ready ISR
+  int beginBurst(ADIS16470BurstCallback callback);
+
+  // Hand a buffer passed to the burst callback back to the driver
+  int releaseBurst(uint16_t *burstWords);
+
+  // Returns true while an asynchronous burst is in progress
+  bool burstBusy(void);
+
+  // Burst read with inline checksum, DIAG_STAT and TIME_STAMP checks. Returns BURST_* flags
+  uint8_t validatedBurst(ADIS16470Frame *frame);
+
+  // Expected TIME_STAMP increment per sample for gap detection (0 disables)
+  int setTimeStampStep(uint16_t step);
+
+  // Snapshot of the integrity counters (checksum, gaps, duplicates, overruns, DIAG_STAT flags)
+  ADIS16470IntegrityStats integrityStats(void) const;
+
+  // Clear the integrity counters
+  int clearIntegrityStats(void);
+
+#if defined(ADIS16470_PROFILE) && defined(ARDUINO)
+  // Print timing histograms (count, min, mean, p50, p99, max) to a serial port.
+  // Arduino only; host builds call adis16470ProfileFormat() and print the text themselves
+  int printProfile(Print &out);
+#endif
+
+  // Validated burst read into the frame queue. Call from the data ready ISR. Returns BURST_* flags
+  uint8_t queueBurst(void);
+
+  // ADIS16470ServiceFn adapter for ADIS16470Scheduler. context is an ADIS16470 *. Blocking: the bus is held for the whole burst
+  static bool scheduledBurst(void *context);
+
+  // Asynchronous ADIS16470ServiceFn adapter: starts beginBurst() and completes the bus from the DMA handler
+  static bool scheduledBeginBurst(void *context);
+
+  // Set the scheduler, bus and burst callback used by scheduledBeginBurst()
+  int attachScheduler(ADIS16470Scheduler *scheduler, uint8_t bus, ADIS16470BurstCallback callback);
+
+  // Remove up to maxFrames decoded frames from the queue. Call from loop()
+  size_t readFrames(ADIS16470Frame *frames, size_t maxFrames);
+
+  // Remove frames together with their host times (see setTimeSync())
+  size_t readFrames(ADIS16470Frame *frames, uint64_t *hostTimes, size_t maxFrames);
+
+  // Stamp queued frames with host time from a tracking loop. Attach before enabling the data ready interrupt
+  int setTimeSync(ADIS16470TimeSync *sync);
+
+  // Select the sample clock source through MSC_CTRL (and UP_SCALE for SYNC_SCALED)
+  int setSyncMode(uint16_t mode, uint16_t upScale = 0);
+
+  // Estimate biases from data-ready-paced bursts and program the bias registers. 1 = converged, 0 = sample limit reached
+  int calibrateBias(ADIS16470BiasEstimator &estimator, uint32_t timeoutMs = 20000);
+
+  // Run the sensor's auto-null and report how far its bias values differ from the current ones, then restore them
+  int compareAutoNull(int32_t *difference, uint16_t nullCfg = NULL_CFG_GYROS);
+
+  // Number of frames waiting in the queue
+  size_t framesAvailable(void);
+
+  // Number of valid frames dropped because the queue was full (integrityStats().overruns)
+  uint32_t queueOverruns(void);
+
+  // Largest number of frames held in the queue at once
+  uint32_t queueHighWater(void);
+
+  // Select the burst contents and size through MSC_CTRL
+  int setBurstMode(uint16_t mode);
+
+  // Read sensor data using a 32-bit burst read. Returns BURST32_WORDS words
+  uint16_t *wordBurst32(void);
+
+  // Burst read and decode in the matching mode, with the validatedBurst() checks. Return BURST_* flags
+  uint8_t deltaBurst(ADIS16470DeltaFrame *frame);
+  uint8_t burst32(ADIS16470Frame32 *frame);
+  uint8_t deltaBurst32(ADIS16470DeltaFrame32 *frame);
+
   // Calculate checksum
   int16_t checksum(uint16_t * burstArray);
 
+  // Calculate checksum of a 32-bit burst
+  int16_t checksum32(uint16_t * burstArray);
+
+  // Calculate checksum of a decoded frame
+  int16_t checksum(const ADIS16470Frame *frame);
+
   // Scale accelerator data
   float accelScale(int16_t sensorData);
 
@@ -147,11 +265,131 @@ public:
   // Scale delta velocity
   float deltaVelocityScale(int16_t sensorData);
 
+  // Scale 32-bit accelerometer data
+  float accelScale32(int32_t sensorData);
+
+  // Scale 32-bit gyro data
+  float gyroScale32(int32_t sensorData);
+
+  // Scale 32-bit delta angle data
+  float deltaAngleScale32(int32_t sensorData);
+
+  // Scale 32-bit delta velocity
+  float deltaVelocityScale32(int32_t sensorData);
+
+  // Sensitivities used by the scaling functions (ADIS16470_DEVICE unless set by ADIS1647x)
+  const ADIS16470Sensitivity &sensitivity(void) const { return _sensitivity; }
+
+protected:
+  // Lets ADIS1647x<Traits> install its part's sensitivities
+  void setSensitivity(const ADIS16470Sensitivity &sensitivity) { _sensitivity = sensitivity; }
+
 private:
   // Variables to store hardware pin assignments
   int _CS;
   int _DR;
   int _RST;
-  int _stall = 20;
 
-};
\ No newline at end of file
+  // Bus, pin and delay access for this instance
+  ADIS16470Transport _transport;
+
+  // Scale factors of the part this instance drives
+  ADIS16470Sensitivity _sensitivity = adis16470Sensitivity<ADIS16470_DEVICE>();
+
+  // Per-instance buffers returned by byteBurst(), wordBurst() and wordBurst32()
+  uint8_t _burstBytes[BURST_WORDS * 2];
+  uint16_t _burstWords[BURST_WORDS];
+  uint16_t _burstWords32[BURST32_WORDS];
+
+  // Cached SPI settings and stall times (us) for each kind of access
+  ADIS16470Transport::Settings _regReadSettings;
+  ADIS16470Transport::Settings _regWriteSettings;
+  ADIS16470Transport::Settings _burstSettings;
+  uint16_t _regReadStall;
+  uint16_t _regWriteStall;
+  volatile bool _burstStall = false; // A burst ended without the stall register frames leave
+
+  // Begins a transaction with the given settings and sets CS low
+  void select(const ADIS16470Transport::Settings &settings);
+
+  // Sends the burst command and reads count words. Returns the computed checksum
+  int16_t burstTransfer(uint16_t *words, int count);
+
+  // Burst integrity tracking
+  ADIS16470Integrity _integrity;
+
+  // Writes one byte using a single 16-bit frame
+  void writeByte(uint8_t regAddr, uint8_t regByte);
+
+  // Returns the shadow cache slot of a writable register, or -1
+  static int shadowIndex(uint8_t regAddr);
+
+  // Returns the cached contents of a writable register, reading it first if unknown
+  int16_t shadowRead(uint8_t regAddr);
+
+  // Read the six 32-bit bias registers in one pipelined batch
+  int readBiases(int32_t *biases);
+
+  // Wait for the next data ready edge. Returns false once timeoutMs has passed since start
+  bool waitDataReady(bool activeHigh, uint32_t start, uint32_t timeoutMs);
+
+  // Shadow copy of the writable configuration registers
+  int16_t _shadow[SHADOW_REGS];
+  uint32_t _shadowValid = 0; // One bit per _shadow entry
+
+  // Decoded frame and the host time of its data ready edge (0 without a tracking loop)
+  struct QueuedFrame {
+    ADIS16470Frame frame;
+    uint64_t hostTime;
+  };
+
+  // Decoded frames waiting for the application
+  ADIS16470Ring<QueuedFrame, ADIS16470_QUEUE_DEPTH> _frameQueue;
+  ADIS16470TimeSync *_timeSync = nullptr;
+
+  // Asynchronous burst state
+  uint8_t _burstRx[BURST_WORDS * 2 + 2];
+  uint16_t *_burstBuffers[2] = { nullptr, nullptr };
+  uint8_t _burstIndex = 0;
+  volatile uint8_t _burstHeld = 0; // One bit per buffer handed to the callback and not yet released
+  volatile bool _burstBusy = false;
+  ADIS16470BurstCallback _burstCallback = nullptr;
+  ADIS16470Scheduler *_scheduler = nullptr; // Told when a scheduledBeginBurst() transfer ends
+  uint8_t _schedulerBus = 0;
+  ADIS16470BurstCallback _schedulerCallback = nullptr;
+
+  // Decodes and validates _burstRx, releases the bus and hands a free buffer to the callback
+  void finishBurst(void);
+
+#if defined(ADIS16470_PROFILE)
+  ADIS16470ProfileLatency _profLatency; // Data ready edge of the burst in progress
+#endif
+
+#if defined(ADIS16470_TRANSPORT_ASYNC)
+  EventResponder _burstEvent;
+  static void burstEventHandler(EventResponderRef event);
+#endif
+
+};
+
+// Driver bound to one member of the family. The inherited scaling functions use the 
+// part's sensitivities, also when called through an ADIS16470 reference
+template <class Traits>
+class ADIS1647x : public ADIS16470 {
+
+public:
+  typedef Traits Device;
+
+  ADIS1647x(int CS, int DR, int RST, ADIS16470Transport::Bus &spi = ADIS16470Transport::defaultBus())
+    : ADIS16470(CS, DR, RST, spi) { setSensitivity(adis16470Sensitivity<Traits>()); }
+
+  // Returns 1 if PROD_ID matches the part, 0 otherwise
+  int checkProdId(void) { return (uint16_t)read<typename Traits::ProdId>() == Traits::prodId; }
+};
+
+typedef ADIS1647x<ADIS16465_1Traits> ADIS16465_1;
+typedef ADIS1647x<ADIS16465_2Traits> ADIS16465_2;
+typedef ADIS1647x<ADIS16465_3Traits> ADIS16465_3;
+typedef ADIS1647x<ADIS16475_1Traits> ADIS16475_1;
+typedef ADIS1647x<ADIS16475_2Traits> ADIS16475_2;
+typedef ADIS1647x<ADIS16475_3Traits> ADIS16475_3;
@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Calibration.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Streaming bias estimation for startup calibration.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include "ADIS16470_Calibration.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Constructor
+////////////////////////////////////////////////////////////////////////////
+ADIS16470BiasEstimator::ADIS16470BiasEstimator() {
+  for (int c = 0; c < CAL_CHANNELS; c++)
+    _expected[c] = 0.0f;
+  setTargets(0.01f, 0.01f);
+  reset();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Selects the channels to estimate. Returns 1, or -1 for an empty mask.
+////////////////////////////////////////////////////////////////////////////
+// mask - CAL_GYRO, CAL_ACCEL, CAL_ALL or individual channel bits
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470BiasEstimator::setChannels(uint8_t mask) {
+  if ((mask & CAL_ALL) == 0)
+    return -1;
+  _mask = mask & CAL_ALL;
+  return reset();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the standard error the means must reach. With white noise of 
+// standard deviation s this takes (s / target)^2 samples, so the sensor's
+// own noise sets the calibration time.
+////////////////////////////////////////////////////////////////////////////
+// gyroLsb - gyro target, 16-bit LSB
+// accelLsb - accelerometer target, 16-bit LSB
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470BiasEstimator::setTargets(float gyroLsb, float accelLsb) {
+  if (!(gyroLsb > 0.0f) || !(accelLsb > 0.0f))
+    return -1;
+  for (int c = 0; c < CAL_CHANNELS; c++)
+  {
+    float t = ((c < 3) ? gyroLsb : accelLsb) * 65536.0f;
+    _limit[c] = t * t;
+  }
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the sample count limits. The minimum guards the variance estimate 
+// itself; the maximum bounds calibration time on a noisy or moving unit.
+////////////////////////////////////////////////////////////////////////////
+// minSamples - earliest stop (at least 2)
+// maxSamples - latest stop
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470BiasEstimator::setLimits(uint32_t minSamples, uint32_t maxSamples) {
+  if (minSamples < 2 || maxSamples < minSamples)
+    return -1;
+  _minSamples = minSamples;
+  _maxSamples = maxSamples;
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the reading a channel should have at rest. Gyros normally expect 0;
+// accelerometer axes expect their share of gravity.
+////////////////////////////////////////////////////////////////////////////
+// channel - 0-2 gyro X/Y/Z, 3-5 accel X/Y/Z
+// lsb - expected reading, 16-bit LSB
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470BiasEstimator::setExpected(uint8_t channel, float lsb) {
+  if (channel >= CAL_CHANNELS)
+    return -1;
+  _expected[channel] = lsb;
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Clears the accumulators.
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470BiasEstimator::reset(void) {
+  for (int c = 0; c < CAL_CHANNELS; c++)
+    _acc[c].clear();
+  _floor = 0.0f;
+  _converged = false;
+  _done = false;
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Adds one 16-bit burst frame. Returns true once estimation is complete.
+////////////////////////////////////////////////////////////////////////////
+// frame - decoded burst
+////////////////////////////////////////////////////////////////////////////
+bool ADIS16470BiasEstimator::add(const ADIS16470Frame &frame) {
+  int32_t v[CAL_CHANNELS];
+  for (int i = 0; i < 3; i++)
+  {
+    v[i] = (int32_t)frame.gyro[i] * 65536;
+    v[3 + i] = (int32_t)frame.accl[i] * 65536;
+  }
+  return update(v, 65536.0f * 65536.0f / 12.0f);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Adds one 32-bit burst frame. Returns true once estimation is complete.
+////////////////////////////////////////////////////////////////////////////
+// frame - decoded 32-bit burst
+////////////////////////////////////////////////////////////////////////////
+bool ADIS16470BiasEstimator::add(const ADIS16470Frame32 &frame) {
+  int32_t v[CAL_CHANNELS];
+  for (int i = 0; i < 3; i++)
+  {
+    v[i] = frame.gyro[i];
+    v[3 + i] = frame.accl[i];
+  }
+  return update(v, 1.0f / 12.0f);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Accumulates one sample of every selected channel (32-bit LSB) and checks
+// the stopping rule: squared standard error m2 / (n (n - 1)) at or below 
+// the target for every channel, without a square root or division. The 
+// variance never counts below the quantization floor LSB^2 / 12, so a 
+// quiet channel that reads the same code every sample cannot stop early.
+////////////////////////////////////////////////////////////////////////////
+// values - one sample per channel, 32-bit LSB
+// quantization - LSB^2 / 12 of the frame the values came from, 32-bit LSB^2
+////////////////////////////////////////////////////////////////////////////
+bool ADIS16470BiasEstimator::update(const int32_t *values, float quantization) {
+  if (_done)
+    return true;
+
+  if (quantization > _floor)
+    _floor = quantization;
+
+  bool _met = true;
+  for (int c = 0; c < CAL_CHANNELS; c++)
+  {
+    ADIS16470Welford &a = _acc[c];
+    a.add(values[c]);
+    float _m2 = fmaxf(a.m2, _floor * (float)(a.n - 1));
+    if ((_mask & (1 << c)) && _m2 > _limit[c] * (float)a.n * (float)(a.n - 1))
+      _met = false;
+  }
+
+  uint32_t _n = _acc[0].n;
+  if (_n >= _minSamples && _met)
+    _converged = true;
+  _done = _converged || _n >= _maxSamples;
+  return _done;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Returns the mean of a channel in 16-bit LSB.
+////////////////////////////////////////////////////////////////////////////
+// channel - 0-2 gyro X/Y/Z, 3-5 accel X/Y/Z
+////////////////////////////////////////////////////////////////////////////
+float ADIS16470BiasEstimator::mean(uint8_t channel) const {
+  const ADIS16470Welford &a = _acc[channel];
+  return ((float)a.shift + a.mean) * (1.0f / 65536.0f);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Returns the standard error of a channel's mean in 16-bit LSB, never below 
+// the quantization floor.
+////////////////////////////////////////////////////////////////////////////
+// channel - 0-2 gyro X/Y/Z, 3-5 accel X/Y/Z
+////////////////////////////////////////////////////////////////////////////
+float ADIS16470BiasEstimator::standardError(uint8_t channel) const {
+  const ADIS16470Welford &a = _acc[channel];
+  if (a.n < 2)
+    return INFINITY;
+  return sqrtf(fmaxf(a.variance(), _floor) / (float)a.n) * (1.0f / 65536.0f);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Returns the value to add to a channel's 32-bit bias register so that the
+// output at rest reads the expected value. Subtracting in integer first 
+// keeps the full 32-bit resolution.
+////////////////////////////////////////////////////////////////////////////
+// channel - 0-2 gyro X/Y/Z, 3-5 accel X/Y/Z
+////////////////////////////////////////////////////////////////////////////
+int32_t ADIS16470BiasEstimator::correction(uint8_t channel) const {
+  const ADIS16470Welford &a = _acc[channel];
+  if (a.n == 0)
+    return 0;
+  int64_t _expected32 = (int64_t)llroundf(_expected[channel] * 65536.0f);
+  return (int32_t)(_expected32 - a.shift - (int64_t)lroundf(a.mean));
+}
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Calibration.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Streaming bias estimation for startup calibration. Gyro and accelerometer samples feed 
+//  per-axis Welford mean/variance accumulators, and estimation stops as soon as the 
+//  standard error of every selected mean meets its target, so a quiet sensor is 
+//  calibrated in the minimum number of samples. Results are expressed as corrections to
+//  the 32-bit bias registers. This header has no Arduino dependencies; 
+//  ADIS16470::calibrateBias() drives it from burst reads and programs the registers.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ADIS16470_Types.h"
+
+// Channels: X/Y/Z gyro then X/Y/Z accel
+#define CAL_CHANNELS  6
+#define CAL_GYRO      0x07  //Gyro channels
+#define CAL_ACCEL     0x38  //Accelerometer channels (set the expected gravity first)
+#define CAL_ALL       0x3F
+
+// Running mean and variance of one channel. Values are shifted by the first sample
+// to keep single precision accurate
+struct ADIS16470Welford {
+  uint32_t n;
+  int32_t shift;  // First sample
+  float mean;     // Mean minus shift
+  float m2;       // Sum of squared deviations
+
+  void clear(void) { n = 0; shift = 0; mean = 0.0f; m2 = 0.0f; }
+
+  void add(int32_t x) {
+    if (n == 0)
+      shift = x;
+    n++;
+    float d = (float)((int64_t)x - shift) - mean;
+    mean += d / (float)n;
+    m2 += d * ((float)((int64_t)x - shift) - mean);
+  }
+
+  // Sample variance
+  float variance(void) const { return (n > 1) ? m2 / (float)(n - 1) : 0.0f; }
+};
+
+class ADIS16470BiasEstimator {
+
+public:
+  // Gyros only, targets of 0.01 LSB, 64 to 20000 samples
+  ADIS16470BiasEstimator();
+
+  // Channels to estimate (CAL_* mask)
+  int setChannels(uint8_t mask);
+
+  // Standard error targets for the means, in 16-bit output LSB
+  int setTargets(float gyroLsb, float accelLsb);
+
+  // Sample count limits. Estimation never stops before minSamples and always stops at maxSamples
+  int setLimits(uint32_t minSamples, uint32_t maxSamples);
+
+  // Expected reading of one channel at rest, in 16-bit LSB (e.g. 1 g on the vertical accelerometer axis)
+  int setExpected(uint8_t channel, float lsb);
+
+  // Restart estimation
+  int reset(void);
+
+  // Add one sample. Return true once estimation is complete
+  bool add(const ADIS16470Frame &frame);
+  bool add(const ADIS16470Frame32 &frame);
+
+  // True once every selected channel has met its target
+  bool converged(void) const { return _converged; }
+
+  // Samples accumulated
+  uint32_t samples(void) const { return _acc[0].n; }
+
+  // Mean and standard error of a channel, 16-bit LSB
+  float mean(uint8_t channel) const;
+  float standardError(uint8_t channel) const;
+
+  // Correction to add to the channel's 32-bit bias register (expected minus mean, 32-bit LSB)
+  int32_t correction(uint8_t channel) const;
+
+  // Selected channels
+  uint8_t channels(void) const { return _mask; }
+
+private:
+  bool update(const int32_t *values, float quantization);
+
+  ADIS16470Welford _acc[CAL_CHANNELS];
+  float _expected[CAL_CHANNELS];
+  float _limit[CAL_CHANNELS];  // Squared standard error target, 32-bit LSB^2
+  float _floor = 0.0f;         // Quantization variance LSB^2 / 12 of the coarsest frames, 32-bit LSB^2
+  uint8_t _mask = CAL_GYRO;
+  uint32_t _minSamples = 64;
+  uint32_t _maxSamples = 20000;
+  bool _converged = false;
+  bool _done = false;
+};
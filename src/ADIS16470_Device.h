@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Device.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Register map and compile-time device traits for the ADIS1646x/1647x family. The parts 
+//  share one register map and burst layout and differ in measurement ranges, so each 
+//  traits struct carries typed register descriptors (address, width, writability), the 
+//  burst layouts, PROD_ID and constexpr sensitivities. The driver-wide scale factors in 
+//  ADIS16470_Scale.h follow ADIS16470_DEVICE; ADIS1647x<Traits> in ADIS16470.h binds one 
+//  driver instance, and the scaling functions it inherits, to a specific part. This header has no Arduino dependencies.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ADIS16470_Types.h"
+
+// Device whose sensitivities the library-wide scale factors use. Uncomment one line (or
+// define it for the whole build) to target another member of the family
+//#define ADIS16470_DEVICE ADIS16465_1Traits
+//#define ADIS16470_DEVICE ADIS16465_2Traits
+//#define ADIS16470_DEVICE ADIS16465_3Traits
+//#define ADIS16470_DEVICE ADIS16475_1Traits
+//#define ADIS16470_DEVICE ADIS16475_2Traits
+//#define ADIS16470_DEVICE ADIS16475_3Traits
+#ifndef ADIS16470_DEVICE
+#define ADIS16470_DEVICE ADIS16470Traits
+#endif
+
+// User Register Memory Map from Table 6
+#define FLASH_CNT   	0x00  //Flash memory write count
+#define DIAG_STAT   	0x02  //Diagnostic and operational status
+#define X_GYRO_LOW  	0x04  //X-axis gyroscope output, lower word
+#define X_GYRO_OUT  	0x06  //X-axis gyroscope output, upper word
+#define Y_GYRO_LOW  	0x08  //Y-axis gyroscope output, lower word
+#define Y_GYRO_OUT  	0x0A  //Y-axis gyroscope output, upper word
+#define Z_GYRO_LOW  	0x0C  //Z-axis gyroscope output, lower word
+#define Z_GYRO_OUT  	0x0E  //Z-axis gyroscope output, upper word
+#define X_ACCL_LOW  	0x10  //X-axis accelerometer output, lower word
+#define X_ACCL_OUT  	0x12  //X-axis accelerometer output, upper word
+#define Y_ACCL_LOW  	0x14  //Y-axis accelerometer output, lower word
+#define Y_ACCL_OUT  	0x16  //Y-axis accelerometer output, upper word
+#define Z_ACCL_LOW  	0x18  //Z-axis accelerometer output, lower word
+#define Z_ACCL_OUT  	0x1A  //Z-axis accelerometer output, upper word
+#define TEMP_OUT    	0x1C  //Temperature output (internal, not calibrated)
+#define TIME_STAMP  	0x1E  //PPS mode time stamp
+#define X_DELTANG_LOW	0x24  //X-axis delta angle output, lower word
+#define X_DELTANG_OUT	0x26  //X-axis delta angle output, upper word
+#define Y_DELTANG_LOW	0x28  //Y-axis delta angle output, lower word
+#define Y_DELTANG_OUT	0x2A  //Y-axis delta angle output, upper word
+#define Z_DELTANG_LOW	0x2C  //Z-axis delta angle output, lower word
+#define Z_DELTANG_OUT	0x2E  //Z-axis delta angle output, upper word
+#define X_DELTVEL_LOW	0x30  //X-axis delta velocity output, lower word
+#define X_DELTVEL_OUT	0x32  //X-axis delta velocity output, upper word
+#define Y_DELTVEL_LOW	0x34  //Y-axis delta velocity output, lower word
+#define Y_DELTVEL_OUT	0x36  //Y-axis delta velocity output, upper word
+#define Z_DELTVEL_LOW	0x38  //Z-axis delta velocity output, lower word
+#define Z_DELTVEL_OUT	0x3A  //Z-axis delta velocity output, upper word
+#define XG_BIAS_LOW		0x40  //X-axis gyroscope bias offset correction, lower word
+#define XG_BIAS_HIGH	0x42  //X-axis gyroscope bias offset correction, upper word
+#define YG_BIAS_LOW		0x44  //Y-axis gyroscope bias offset correction, lower word
+#define YG_BIAS_HIGH	0x46  //Y-axis gyroscope bias offset correction, upper word
+#define ZG_BIAS_LOW		0x48  //Z-axis gyroscope bias offset correction, lower word
+#define ZG_BIAS_HIGH	0x4A  //Z-axis gyroscope bias offset correction, upper word
+#define XA_BIAS_LOW		0x4C  //X-axis accelerometer bias offset correction, lower word
+#define XA_BIAS_HIGH	0x4E  //X-axis accelerometer bias offset correction, upper word
+#define YA_BIAS_LOW		0x50  //Y-axis accelerometer bias offset correction, lower word
+#define YA_BIAS_HIGH	0x52  //Y-axis accelerometer bias offset correction, upper word
+#define ZA_BIAS_LOW		0x54  //Z-axis accelerometer bias offset correction, lower word
+#define ZA_BIAS_HIGH	0x56  //Z-axis accelerometer bias offset correction, upper word
+#define FILT_CTRL    	0x5C  //Filter control
+#define MSC_CTRL    	0x60  //Miscellaneous control
+#define UP_SCALE    	0x62  //Clock scale factor, PPS mode
+#define DEC_RATE    	0x64  //Decimation rate control (output data rate)
+#define NULL_CFG    	0x66  //Auto-null configuration control
+#define GLOB_CMD    	0x68  //Global commands
+#define FIRM_REV    	0x6C  //Firmware revision
+#define FIRM_DM    		0x6E  //Firmware revision date, month and day
+#define FIRM_Y    		0x70  //Firmware revision date, year
+#define PROD_ID    		0x72  //Product identification 
+#define SERIAL_NUM    0x74  //Serial number (relative to assembly lot)
+#define USER_SCR1    	0x76  //User scratch register 1 
+#define USER_SCR2    	0x78  //User scratch register 2 
+#define USER_SCR3    	0x7A  //User scratch register 3 
+#define FLSHCNT_LOW   0x7C  //Flash update count, lower word 
+#define FLSHCNT_HIGH  0x7E  //Flash update count, upper word 
+
+// Compile-time register descriptor. Width is 16 for single registers or 32 for LOW/OUT 
+// (or LOW/HIGH) pairs, which are addressed by their LOW word
+template <uint8_t Addr, uint8_t Width, bool Writable>
+struct ADIS16470Register {
+  static_assert(Width == 16 || Width == 32, "Register width must be 16 or 32 bits");
+  static_assert((Addr & 1) == 0, "Register addresses are word aligned");
+  static constexpr uint8_t addr = Addr;
+  static constexpr uint8_t width = Width;
+  static constexpr bool writable = Writable;
+};
+
+// Register descriptors shared by the family
+struct ADIS1647xRegisters {
+  typedef ADIS16470Register<DIAG_STAT,     16, false> DiagStat;
+  typedef ADIS16470Register<X_GYRO_LOW,    32, false> XGyro;
+  typedef ADIS16470Register<Y_GYRO_LOW,    32, false> YGyro;
+  typedef ADIS16470Register<Z_GYRO_LOW,    32, false> ZGyro;
+  typedef ADIS16470Register<X_GYRO_OUT,    16, false> XGyroOut;
+  typedef ADIS16470Register<Y_GYRO_OUT,    16, false> YGyroOut;
+  typedef ADIS16470Register<Z_GYRO_OUT,    16, false> ZGyroOut;
+  typedef ADIS16470Register<X_ACCL_LOW,    32, false> XAccl;
+  typedef ADIS16470Register<Y_ACCL_LOW,    32, false> YAccl;
+  typedef ADIS16470Register<Z_ACCL_LOW,    32, false> ZAccl;
+  typedef ADIS16470Register<X_ACCL_OUT,    16, false> XAcclOut;
+  typedef ADIS16470Register<Y_ACCL_OUT,    16, false> YAcclOut;
+  typedef ADIS16470Register<Z_ACCL_OUT,    16, false> ZAcclOut;
+  typedef ADIS16470Register<TEMP_OUT,      16, false> TempOut;
+  typedef ADIS16470Register<TIME_STAMP,    16, false> TimeStamp;
+  typedef ADIS16470Register<X_DELTANG_LOW, 32, false> XDeltAng;
+  typedef ADIS16470Register<Y_DELTANG_LOW, 32, false> YDeltAng;
+  typedef ADIS16470Register<Z_DELTANG_LOW, 32, false> ZDeltAng;
+  typedef ADIS16470Register<X_DELTANG_OUT, 16, false> XDeltAngOut;
+  typedef ADIS16470Register<Y_DELTANG_OUT, 16, false> YDeltAngOut;
+  typedef ADIS16470Register<Z_DELTANG_OUT, 16, false> ZDeltAngOut;
+  typedef ADIS16470Register<X_DELTVEL_LOW, 32, false> XDeltVel;
+  typedef ADIS16470Register<Y_DELTVEL_LOW, 32, false> YDeltVel;
+  typedef ADIS16470Register<Z_DELTVEL_LOW, 32, false> ZDeltVel;
+  typedef ADIS16470Register<X_DELTVEL_OUT, 16, false> XDeltVelOut;
+  typedef ADIS16470Register<Y_DELTVEL_OUT, 16, false> YDeltVelOut;
+  typedef ADIS16470Register<Z_DELTVEL_OUT, 16, false> ZDeltVelOut;
+  typedef ADIS16470Register<XG_BIAS_LOW,   32, true>  XgBias;
+  typedef ADIS16470Register<YG_BIAS_LOW,   32, true>  YgBias;
+  typedef ADIS16470Register<ZG_BIAS_LOW,   32, true>  ZgBias;
+  typedef ADIS16470Register<XA_BIAS_LOW,   32, true>  XaBias;
+  typedef ADIS16470Register<YA_BIAS_LOW,   32, true>  YaBias;
+  typedef ADIS16470Register<ZA_BIAS_LOW,   32, true>  ZaBias;
+  typedef ADIS16470Register<FILT_CTRL,     16, true>  FiltCtrl;
+  typedef ADIS16470Register<MSC_CTRL,      16, true>  MscCtrl;
+  typedef ADIS16470Register<UP_SCALE,      16, true>  UpScale;
+  typedef ADIS16470Register<DEC_RATE,      16, true>  DecRate;
+  typedef ADIS16470Register<NULL_CFG,      16, true>  NullCfg;
+  typedef ADIS16470Register<GLOB_CMD,      16, true>  GlobCmd;
+  typedef ADIS16470Register<FIRM_REV,      16, false> FirmRev;
+  typedef ADIS16470Register<FIRM_DM,       16, false> FirmDm;
+  typedef ADIS16470Register<FIRM_Y,        16, false> FirmY;
+  typedef ADIS16470Register<PROD_ID,       16, false> ProdId;
+  typedef ADIS16470Register<SERIAL_NUM,    16, false> SerialNum;
+  typedef ADIS16470Register<USER_SCR1,     16, true>  UserScr1;
+  typedef ADIS16470Register<USER_SCR2,     16, true>  UserScr2;
+  typedef ADIS16470Register<USER_SCR3,     16, true>  UserScr3;
+  typedef ADIS16470Register<FLSHCNT_LOW,   32, false> FlashCount;
+
+  // Burst layouts
+  typedef ADIS16470BurstLayout   Burst;
+  typedef ADIS16470Burst32Layout Burst32;
+};
+
+// ADIS16470: +/-2000 deg/sec, +/-40 g
+struct ADIS16470Traits : ADIS1647xRegisters {
+  static constexpr uint16_t prodId = 16470;
+  static constexpr float gyroScale = 0.1f;              // deg/sec/LSB
+  static constexpr float accelScale = 0.00125f;         // g/LSB
+  static constexpr float tempScale = 0.1f;              // deg C/LSB
+  static constexpr float deltaAngleScale = 0.061f;      // degrees/LSB
+  static constexpr float deltaVelocityScale = 0.01221f; // m/sec/LSB
+};
+
+// ADIS16465 and ADIS16475 accelerometer (+/-8 g) and delta velocity (+/-100 m/sec)
+struct ADIS1646xRange8g : ADIS1647xRegisters {
+  static constexpr float accelScale = 0.00025f;                 // g/LSB
+  static constexpr float tempScale = 0.1f;                      // deg C/LSB
+  static constexpr float deltaVelocityScale = 100.0f / 32768.0f; // m/sec/LSB
+};
+
+// -1 models: +/-125 deg/sec, delta angle +/-360 degrees
+struct ADIS1646xGyro1 {
+  static constexpr float gyroScale = 1.0f / 160.0f;             // deg/sec/LSB
+  static constexpr float deltaAngleScale = 360.0f / 32768.0f;   // degrees/LSB
+};
+
+// -2 models: +/-500 deg/sec, delta angle +/-720 degrees
+struct ADIS1646xGyro2 {
+  static constexpr float gyroScale = 1.0f / 40.0f;
+  static constexpr float deltaAngleScale = 720.0f / 32768.0f;
+};
+
+// -3 models: +/-2000 deg/sec, delta angle +/-2160 degrees
+struct ADIS1646xGyro3 {
+  static constexpr float gyroScale = 1.0f / 10.0f;
+  static constexpr float deltaAngleScale = 2160.0f / 32768.0f;
+};
+
+struct ADIS16465_1Traits : ADIS1646xRange8g, ADIS1646xGyro1 { static constexpr uint16_t prodId = 16465; };
+struct ADIS16465_2Traits : ADIS1646xRange8g, ADIS1646xGyro2 { static constexpr uint16_t prodId = 16465; };
+struct ADIS16465_3Traits : ADIS1646xRange8g, ADIS1646xGyro3 { static constexpr uint16_t prodId = 16465; };
+struct ADIS16475_1Traits : ADIS1646xRange8g, ADIS1646xGyro1 { static constexpr uint16_t prodId = 16475; };
+struct ADIS16475_2Traits : ADIS1646xRange8g, ADIS1646xGyro2 { static constexpr uint16_t prodId = 16475; };
+struct ADIS16475_3Traits : ADIS1646xRange8g, ADIS1646xGyro3 { static constexpr uint16_t prodId = 16475; };
+
+// Sensitivities of one part as plain values, so a driver instance can carry the scaling
+// of its own part at run time
+struct ADIS16470Sensitivity {
+  float gyro;           // deg/sec/LSB
+  float accel;          // g/LSB
+  float temp;           // deg C/LSB
+  float deltaAngle;     // degrees/LSB
+  float deltaVelocity;  // m/sec/LSB
+};
+
+// Sensitivities of a traits struct, e.g. adis16470Sensitivity<ADIS16465_2Traits>()
+template <class Traits>
+constexpr ADIS16470Sensitivity adis16470Sensitivity(void) {
+  return ADIS16470Sensitivity{ Traits::gyroScale, Traits::accelScale, Traits::tempScale,
+                               Traits::deltaAngleScale, Traits::deltaVelocityScale };
+}
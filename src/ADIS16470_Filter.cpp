@@ -0,0 +1,303 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Filter.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Streaming fixed-point decimation and filtering of 16-bit burst frames.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ADIS16470_Filter.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Returns floor(sqrt(x)) using the bit-by-bit method (32 iterations).
+////////////////////////////////////////////////////////////////////////////
+// x - value
+////////////////////////////////////////////////////////////////////////////
+uint32_t adis16470Isqrt(uint64_t x) {
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+  while (bit > x)
+    bit >>= 2;
+  while (bit != 0)
+  {
+    if (x >= root + bit)
+    {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+      root >>= 1;
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Constructor. Starts as a pass-through: every sample is an output and all
+// channel filters are bypassed.
+////////////////////////////////////////////////////////////////////////////
+ADIS16470Filter::ADIS16470Filter() {
+  for (int c = 0; c < FILTER_CHANNELS; c++)
+  {
+    _channels[c].biquads = 0;
+    _channels[c].tapCount = 0;
+  }
+  reset();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the output rate. Outputs are spaced by a rate accumulator, so any
+// outputHz up to inputHz works and the average output rate is exact; 
+// windows then hold floor or ceil(inputHz / outputHz) samples. Order 0 
+// outputs the latest biquad output, order 1 averages the window (boxcar)
+// and orders 2-3 apply a CIC decimator, which needs an integer ratio.
+// Resets the filter. Returns 1 on success or -1 for invalid settings.
+////////////////////////////////////////////////////////////////////////////
+// inputHz - sensor output data rate
+// outputHz - desired output rate
+// cicOrder - decimator order (0 to FILTER_MAX_CIC)
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470Filter::setRates(uint32_t inputHz, uint32_t outputHz, uint8_t cicOrder) {
+  if (inputHz == 0 || outputHz == 0 || outputHz > inputHz || cicOrder > FILTER_MAX_CIC)
+    return -1;
+  uint32_t ratio = (inputHz + outputHz - 1) / outputHz;
+  if (ratio > FILTER_MAX_RATIO)
+    return -1;
+  uint64_t gain = 1;
+  if (cicOrder >= 2)
+  {
+    if (inputHz % outputHz != 0)
+      return -1;
+    for (int i = 0; i < cicOrder; i++)
+      gain *= ratio;
+    if (gain > ((uint64_t)1 << 32)) // Keeps the true CIC sum inside int64_t
+      return -1;
+  }
+  _inputHz = inputHz;
+  _outputHz = outputHz;
+  _cicOrder = cicOrder;
+  _cicGain = gain;
+  reset();
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the biquad cascade applied to one channel at the sensor rate. 
+// Section outputs saturate to int32_t; keep the cascade gain such that 
+// internal values stay well below 2^30 (raw full scale is 2^23).
+// Returns 1 on success or -1 for invalid arguments.
+////////////////////////////////////////////////////////////////////////////
+// channel - 0-2 gyro X/Y/Z, 3-5 accel X/Y/Z
+// sections - Q2.30 coefficients, applied in order
+// count - number of sections (0 to FILTER_MAX_BIQUADS)
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470Filter::setBiquads(uint8_t channel, const ADIS16470Biquad *sections, uint8_t count) {
+  if (channel >= FILTER_CHANNELS || count > FILTER_MAX_BIQUADS)
+    return -1;
+  Channel &ch = _channels[channel];
+  for (int i = 0; i < count; i++)
+  {
+    ch.biquad[i] = sections[i];
+    for (int j = 0; j < 4; j++)
+      ch.biquadState[i][j] = 0;
+  }
+  ch.biquads = count;
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the FIR applied to one channel at the output rate, typically a CIC
+// droop compensator or a final low-pass. Returns 1 on success or -1 for 
+// invalid arguments.
+////////////////////////////////////////////////////////////////////////////
+// channel - 0-2 gyro X/Y/Z, 3-5 accel X/Y/Z
+// taps - Q1.15 coefficients, taps[0] applies to the newest value
+// count - number of taps (0 to FILTER_MAX_TAPS)
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470Filter::setFir(uint8_t channel, const int16_t *taps, uint8_t count) {
+  if (channel >= FILTER_CHANNELS || count > FILTER_MAX_TAPS)
+    return -1;
+  Channel &ch = _channels[channel];
+  for (int i = 0; i < count; i++)
+  {
+    ch.taps[i] = taps[i];
+    ch.history[i] = 0;
+  }
+  ch.tapCount = count;
+  ch.historyIndex = 0;
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Clears every filter, decimator and FIR state and starts a new window.
+// Coefficients and rates are kept.
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470Filter::reset(void) {
+  for (int c = 0; c < FILTER_CHANNELS; c++)
+  {
+    Channel &ch = _channels[c];
+    for (int i = 0; i < FILTER_MAX_BIQUADS; i++)
+      for (int j = 0; j < 4; j++)
+        ch.biquadState[i][j] = 0;
+    for (int i = 0; i < FILTER_MAX_CIC; i++)
+    {
+      ch.integrator[i] = 0;
+      ch.comb[i] = 0;
+    }
+    for (int i = 0; i < FILTER_MAX_TAPS; i++)
+      ch.history[i] = 0;
+    ch.historyIndex = 0;
+    ch.latest = 0;
+  }
+  _phase = 0;
+  clearWindow();
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Starts a new statistics window.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Filter::clearWindow(void) {
+  for (int c = 0; c < FILTER_CHANNELS; c++)
+  {
+    _channels[c].min = INT16_MAX;
+    _channels[c].max = INT16_MIN;
+    _channels[c].sumSquares = 0;
+  }
+  _samples = 0;
+  _diagStat = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decodes a wordBurst() result and processes it.
+////////////////////////////////////////////////////////////////////////////
+// burstWords - BURST_WORDS words from wordBurst()
+// out - receives the output when one is due
+////////////////////////////////////////////////////////////////////////////
+bool ADIS16470Filter::push(const uint16_t *burstWords, ADIS16470FilterOutput *out) {
+  ADIS16470Frame frame;
+  adis16470DecodeBurst(burstWords, &frame);
+  return push(frame, out);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Processes one sensor sample. Per channel this costs at most 
+// FILTER_MAX_BIQUADS biquads and FILTER_MAX_CIC integrators; on output 
+// samples it adds the combs, one division, at most FILTER_MAX_TAPS 
+// multiply-accumulates and one square root. Returns true when out was 
+// filled.
+////////////////////////////////////////////////////////////////////////////
+// frame - decoded 16-bit burst frame
+// out - receives the output when one is due
+////////////////////////////////////////////////////////////////////////////
+bool ADIS16470Filter::push(const ADIS16470Frame &frame, ADIS16470FilterOutput *out) {
+
+  const int16_t raw[FILTER_CHANNELS] = { frame.gyro[0], frame.gyro[1], frame.gyro[2],
+                                         frame.accl[0], frame.accl[1], frame.accl[2] };
+
+  // Sensor-rate stages
+  for (int c = 0; c < FILTER_CHANNELS; c++)
+  {
+    Channel &ch = _channels[c];
+    int32_t x = (int32_t)raw[c] * (1 << FILTER_FRAC_BITS);
+
+    for (int i = 0; i < ch.biquads; i++)
+    {
+      const ADIS16470Biquad &q = ch.biquad[i];
+      int32_t *s = ch.biquadState[i];
+      int64_t acc = (int64_t)q.b0 * x + (int64_t)q.b1 * s[0] + (int64_t)q.b2 * s[1]
+                  - (int64_t)q.a1 * s[2] - (int64_t)q.a2 * s[3];
+      int32_t y = adis16470RoundShift(acc, FILTER_BIQUAD_SHIFT);
+      s[1] = s[0];
+      s[0] = x;
+      s[3] = s[2];
+      s[2] = y;
+      x = y;
+    }
+    ch.latest = x;
+
+    if (_cicOrder > 0)
+    {
+      ch.integrator[0] += (uint64_t)(int64_t)x;
+      for (int i = 1; i < _cicOrder; i++)
+        ch.integrator[i] += ch.integrator[i - 1];
+    }
+
+    if (raw[c] < ch.min) ch.min = raw[c];
+    if (raw[c] > ch.max) ch.max = raw[c];
+    ch.sumSquares += (uint64_t)((int32_t)raw[c] * raw[c]);
+  }
+  _samples++;
+  _diagStat |= frame.diagStat;
+
+  // Rate accumulator decides whether this sample closes a window
+  _phase += _outputHz;
+  if (_phase < _inputHz)
+    return false;
+  _phase -= _inputHz;
+
+  // Output-rate stages
+  for (int c = 0; c < FILTER_CHANNELS; c++)
+  {
+    Channel &ch = _channels[c];
+    int32_t v = ch.latest;
+
+    if (_cicOrder > 0)
+    {
+      uint64_t d = ch.integrator[_cicOrder - 1];
+      for (int i = 0; i < _cicOrder; i++)
+      {
+        uint64_t prev = ch.comb[i];
+        ch.comb[i] = d;
+        d -= prev;
+      }
+      int64_t den = (_cicOrder == 1) ? (int64_t)_samples : (int64_t)_cicGain;
+      v = adis16470DivRound((int64_t)d, den);
+    }
+
+    if (ch.tapCount > 0)
+    {
+      ch.history[ch.historyIndex] = v;
+      int64_t acc = 0;
+      int idx = ch.historyIndex;
+      for (int k = 0; k < ch.tapCount; k++)
+      {
+        acc += (int64_t)ch.taps[k] * ch.history[idx];
+        idx = (idx == 0) ? ch.tapCount - 1 : idx - 1;
+      }
+      ch.historyIndex = (ch.historyIndex + 1 == ch.tapCount) ? 0 : ch.historyIndex + 1;
+      v = adis16470RoundShift(acc, FILTER_FIR_SHIFT);
+    }
+
+    out->value[c] = v;
+    out->min[c] = ch.min;
+    out->max[c] = ch.max;
+    out->rms[c] = (uint16_t)adis16470Isqrt((ch.sumSquares + _samples / 2) / _samples);
+  }
+  out->temp = frame.temp;
+  out->diagStat = _diagStat;
+  out->timeStamp = frame.timeStamp;
+  out->samples = _samples;
+
+  clearWindow();
+  return true;
+}
@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Filter.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Streaming fixed-point decimation and filtering of 16-bit burst frames. Each gyro and 
+//  accelerometer axis passes through its own biquad cascade at the sensor rate, a CIC 
+//  (or boxcar) decimator, and an FIR at the output rate. Min/max/RMS of the raw samples in 
+//  each output window are reported alongside, so peaks survive decimation. The output 
+//  rate is set independently of the sensor ODR. All state is held in the object (no 
+//  allocation) and the worst-case work per sample is fixed by the FILTER_MAX_* limits.
+//  This header has no Arduino dependencies; extras/bench/ADIS16470_FilterCheck.cpp 
+//  compares it bit for bit against a direct reference implementation.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ADIS16470_Types.h"
+
+// Channels processed: X/Y/Z gyro then X/Y/Z accel
+#define FILTER_CHANNELS     6
+
+// Capacity limits
+#define FILTER_MAX_BIQUADS  4
+#define FILTER_MAX_TAPS     32
+#define FILTER_MAX_CIC      3   // Highest CIC order
+#define FILTER_MAX_RATIO    65535
+
+// Fixed-point formats
+#define FILTER_FRAC_BITS    8   // Internal samples and outputs are LSB * 2^8
+#define FILTER_BIQUAD_SHIFT 30  // Biquad coefficients are Q2.30
+#define FILTER_FIR_SHIFT    15  // FIR taps are Q1.15
+
+// Biquad section in Q2.30: y = b0*x + b1*x[-1] + b2*x[-2] - a1*y[-1] - a2*y[-2]
+struct ADIS16470Biquad {
+  int32_t b0, b1, b2;
+  int32_t a1, a2;
+};
+
+// One decimated output
+struct ADIS16470FilterOutput {
+  int32_t value[FILTER_CHANNELS]; // Filtered value, LSB * 2^FILTER_FRAC_BITS
+  int16_t min[FILTER_CHANNELS];   // Smallest raw sample in the window
+  int16_t max[FILTER_CHANNELS];   // Largest raw sample in the window
+  uint16_t rms[FILTER_CHANNELS];  // RMS of the raw samples in the window, LSB
+  int16_t temp;                   // TEMP_OUT of the last sample
+  uint16_t diagStat;              // DIAG_STAT flags of every sample in the window ORed together
+  uint16_t timeStamp;             // TIME_STAMP of the last sample
+  uint16_t samples;               // Number of sensor samples in the window
+};
+
+// Rounds acc / 2^shift to nearest (ties up) and saturates to int32_t
+inline int32_t adis16470RoundShift(int64_t acc, int shift) {
+  int64_t y = (acc + ((int64_t)1 << (shift - 1))) >> shift;
+  if (y > INT32_MAX) return INT32_MAX;
+  if (y < INT32_MIN) return INT32_MIN;
+  return (int32_t)y;
+}
+
+// Rounds num / den (den > 0) to nearest (ties away from zero) and saturates to int32_t
+inline int32_t adis16470DivRound(int64_t num, int64_t den) {
+  int64_t y = (num >= 0) ? (num + den / 2) / den : -((-num + den / 2) / den);
+  if (y > INT32_MAX) return INT32_MAX;
+  if (y < INT32_MIN) return INT32_MIN;
+  return (int32_t)y;
+}
+
+// Integer square root (floor)
+uint32_t adis16470Isqrt(uint64_t x);
+
+class ADIS16470Filter {
+
+public:
+  ADIS16470Filter();
+
+  // Set the sensor and output rates and the CIC order (0 = pick latest, 1 = boxcar, 2-3 = CIC)
+  int setRates(uint32_t inputHz, uint32_t outputHz, uint8_t cicOrder);
+
+  // Set the biquad cascade of one channel (copied). count = 0 bypasses it
+  int setBiquads(uint8_t channel, const ADIS16470Biquad *sections, uint8_t count);
+
+  // Set the output-rate FIR of one channel (copied). count = 0 bypasses it
+  int setFir(uint8_t channel, const int16_t *taps, uint8_t count);
+
+  // Clear all filter state and the current window
+  int reset(void);
+
+  // Process one sensor sample. Returns true and fills out when an output is due
+  bool push(const ADIS16470Frame &frame, ADIS16470FilterOutput *out);
+
+  // Process one wordBurst() result
+  bool push(const uint16_t *burstWords, ADIS16470FilterOutput *out);
+
+private:
+  struct Channel {
+    ADIS16470Biquad biquad[FILTER_MAX_BIQUADS];
+    int32_t biquadState[FILTER_MAX_BIQUADS][4]; // x[-1], x[-2], y[-1], y[-2]
+    uint8_t biquads;
+    uint64_t integrator[FILTER_MAX_CIC];        // Modulo 2^64, as CIC filters require
+    uint64_t comb[FILTER_MAX_CIC];
+    int32_t latest;
+    int16_t taps[FILTER_MAX_TAPS];
+    int32_t history[FILTER_MAX_TAPS];
+    uint8_t tapCount;
+    uint8_t historyIndex;
+    int16_t min;
+    int16_t max;
+    uint64_t sumSquares;
+  };
+
+  // Starts a new statistics window
+  void clearWindow(void);
+
+  Channel _channels[FILTER_CHANNELS];
+  uint32_t _inputHz = 1;
+  uint32_t _outputHz = 1;
+  uint32_t _phase = 0;
+  uint8_t _cicOrder = 0;
+  uint64_t _cicGain = 1;
+  uint16_t _samples = 0;
+  uint16_t _diagStat = 0;
+};
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Integrity.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Burst integrity tracking for the ADIS16470.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ADIS16470_Integrity.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the expected TIME_STAMP increment between consecutive samples and 
+// restarts tracking.
+////////////////////////////////////////////////////////////////////////////
+// step - expected increment, 0 to disable gap and duplicate detection
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Integrity::setTimeStampStep(uint16_t step) {
+  _step = step;
+  _haveTimeStamp = false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Checks one burst and updates the counters. Bursts with a bad checksum 
+// are only counted; their contents are not trusted for tracking. A 
+// TIME_STAMP delta which rounds to one sample period but is not exactly
+// the step is counted as jitter, not as a gap.
+// Returns BURST_* status flags (0 for a good sample).
+////////////////////////////////////////////////////////////////////////////
+// diagStat - DIAG_STAT word of the burst
+// timeStamp - TIME_STAMP word of the burst
+// checksumOk - result of the checksum comparison
+////////////////////////////////////////////////////////////////////////////
+uint8_t ADIS16470Integrity::update(uint16_t diagStat, uint16_t timeStamp, bool checksumOk) {
+
+  _stats.bursts++;
+  if (!checksumOk)
+  {
+    _stats.badChecksum++;
+    return BURST_BAD_CHECKSUM;
+  }
+
+  uint8_t status = 0;
+
+  if (diagStat != 0)
+  {
+    status |= BURST_DIAG_ERROR;
+    _stats.diagErrors++;
+    for (int bit = 0; bit < 16; bit++) // Rare, so a simple loop is fine
+      if (diagStat & (1 << bit))
+        _stats.diagFlags[bit]++;
+  }
+
+  if (_step != 0)
+  {
+    if (_haveTimeStamp)
+    {
+      uint16_t delta = timeStamp - _lastTimeStamp; // Unsigned math handles the wrap
+      if (delta == 0)
+      {
+        status |= BURST_DUPLICATE;
+        _stats.duplicates++;
+      }
+      else if (delta != _step)
+      {
+        uint16_t samples = (delta + _step / 2) / _step; // Nearest whole number of periods
+        if (samples > 1)
+        {
+          status |= BURST_GAP;
+          _stats.gaps++;
+          _stats.samplesMissed += samples - 1;
+        }
+        else
+          _stats.jitter++; // Next sample, just off the nominal step
+      }
+    }
+    _lastTimeStamp = timeStamp;
+    _haveTimeStamp = true;
+  }
+
+  return status;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Clears all counters and restarts TIME_STAMP tracking.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Integrity::clear(void) {
+  _stats = ADIS16470IntegrityStats();
+  _haveTimeStamp = false;
+}
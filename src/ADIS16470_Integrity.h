@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Integrity.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Burst integrity tracking: DIAG_STAT flag decoding, TIME_STAMP continuity (gaps and 
+//  duplicates across 16-bit wraparound) and running counters which may be read at any time
+//  without touching the data path. This header has no Arduino dependencies.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ADIS16470_Types.h"
+
+// DIAG_STAT bits
+#define DIAG_DATAPATH_OVERRUN  0x0002  //Data path overrun
+#define DIAG_FLASH_UPDATE_FAIL 0x0004  //Flash memory update failure
+#define DIAG_SPI_ERROR         0x0008  //SPI communication error
+#define DIAG_STANDBY           0x0010  //Standby mode
+#define DIAG_SENSOR_FAIL       0x0020  //Sensor failure (self test)
+#define DIAG_MEMORY_FAIL       0x0040  //Memory failure
+#define DIAG_CLOCK_ERROR       0x0080  //Clock error
+
+// Status flags returned for each validated burst (0 = good sample)
+#define BURST_BAD_CHECKSUM     0x01  //Checksum mismatch, sample discarded
+#define BURST_GAP              0x02  //TIME_STAMP skipped one or more samples
+#define BURST_DUPLICATE        0x04  //TIME_STAMP did not advance
+#define BURST_DIAG_ERROR       0x08  //DIAG_STAT reported at least one flag
+#define BURST_OVERRUN          0x10  //Sample dropped because the frame queue was full
+
+// Running integrity counters
+struct ADIS16470IntegrityStats {
+  uint32_t bursts;          // Bursts checked
+  uint32_t badChecksum;     // Bursts with a checksum mismatch
+  uint32_t gaps;            // Number of discontinuities in TIME_STAMP
+  uint32_t samplesMissed;   // Samples missing according to TIME_STAMP
+  uint32_t duplicates;      // Bursts repeating the previous TIME_STAMP
+  uint32_t jitter;          // Bursts off the expected step by less than half a sample
+  uint32_t overruns;        // Valid samples dropped by the frame queue (sole overrun count)
+  uint32_t diagErrors;      // Bursts with any DIAG_STAT bit set
+  uint32_t diagFlags[16];   // Count of each DIAG_STAT bit
+};
+
+// Tracks burst integrity over time
+class ADIS16470Integrity {
+
+public:
+  // Expected TIME_STAMP increment per sample. 0 disables gap/duplicate detection
+  void setTimeStampStep(uint16_t step);
+
+  // Checks one burst. Returns BURST_* status flags
+  uint8_t update(uint16_t diagStat, uint16_t timeStamp, bool checksumOk);
+
+  // Records a valid sample dropped by the frame queue. Bursts already
+  // rejected for their checksum are not counted again
+  void countOverrun(void) { _stats.overruns++; }
+
+  // Running counters
+  const ADIS16470IntegrityStats &stats(void) const { return _stats; }
+
+  // Clears all counters and restarts TIME_STAMP tracking
+  void clear(void);
+
+private:
+  ADIS16470IntegrityStats _stats = {};
+  uint16_t _step = 1;
+  uint16_t _lastTimeStamp = 0;
+  bool _haveTimeStamp = false;
+};
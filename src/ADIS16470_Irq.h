@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Irq.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Short interrupt-masked sections for state shared between data ready ISRs and loop().
+//  adis16470IrqSave() masks interrupts and returns the previous state, which
+//  adis16470IrqRestore() puts back, so sections nest and may also be used inside an ISR.
+//  Host builds have no interrupts and compile them away; a host simulation that models
+//  preemption can supply its own pair with
+//    -DADIS16470_IRQ_HEADER='"MyIrq.h"'
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(ADIS16470_IRQ_HEADER)
+#include ADIS16470_IRQ_HEADER
+
+#elif defined(ARDUINO) && defined(__arm__)
+// Cortex-M: PRIMASK
+static inline uint32_t adis16470IrqSave(void) {
+  uint32_t primask;
+  __asm__ volatile("mrs %0, primask\n\tcpsid i" : "=r"(primask) : : "memory");
+  return primask;
+}
+static inline void adis16470IrqRestore(uint32_t state) {
+  __asm__ volatile("msr primask, %0" : : "r"(state) : "memory");
+}
+
+#elif defined(ARDUINO) && defined(__AVR__)
+#include <avr/interrupt.h>
+// AVR: global interrupt flag in SREG
+static inline uint32_t adis16470IrqSave(void) {
+  uint8_t sreg = SREG;
+  cli();
+  return sreg;
+}
+static inline void adis16470IrqRestore(uint32_t state) {
+  SREG = (uint8_t)state;
+}
+
+#elif defined(ARDUINO)
+#include "Arduino.h"
+// Other cores: assumes interrupts were enabled, so do not nest inside an ISR
+static inline uint32_t adis16470IrqSave(void) {
+  noInterrupts();
+  return 1;
+}
+static inline void adis16470IrqRestore(uint32_t state) {
+  if (state)
+    interrupts();
+}
+
+#else
+// Host: no interrupts
+static inline uint32_t adis16470IrqSave(void) { return 0; }
+static inline void adis16470IrqRestore(uint32_t state) { (void)state; }
+#endif
@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Profile.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Timing histograms for the ADIS16470 driver hot paths. See ADIS16470_Profile.h.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ADIS16470_Profile.h"
+#include "ADIS16470_Irq.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Returns the histogram bucket of a tick count. Values below 4 get their 
+// own bucket; above that each power of two is split into four.
+////////////////////////////////////////////////////////////////////////////
+static inline int bucketOf(uint32_t ticks) {
+  if (ticks < 4)
+    return ticks;
+  int msb = 31 - __builtin_clz(ticks);
+  return (msb - 1) * 4 + ((ticks >> (msb - 2)) & 3);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Returns the largest tick count that falls in a bucket
+////////////////////////////////////////////////////////////////////////////
+static inline uint32_t bucketTop(int bucket) {
+  if (bucket < 4)
+    return bucket;
+  int msb = bucket / 4 + 1;
+  uint32_t low = (uint32_t)(4 + bucket % 4) << (msb - 2);
+  return low + ((1UL << (msb - 2)) - 1);
+}
+
+void ADIS16470Histogram::record(uint32_t ticks) {
+  if (count == 0 || ticks < min)
+    min = ticks;
+  if (ticks > max)
+    max = ticks;
+  count++;
+  sum += ticks;
+  buckets[bucketOf(ticks)]++;
+}
+
+uint32_t ADIS16470Histogram::percentile(float fraction) const {
+  uint32_t target = (uint32_t)(fraction * count + 0.5f);
+  if (target < 1)
+    target = 1;
+  uint32_t seen = 0;
+  for (int i = 0; i < PROF_BUCKETS; i++)
+  {
+    seen += buckets[i];
+    if (seen >= target)
+      return (bucketTop(i) < max) ? bucketTop(i) : max;
+  }
+  return max;
+}
+
+#if defined(ADIS16470_PROFILE)
+
+#include <stdio.h>
+#if defined(ARDUINO)
+#include "Arduino.h"
+#else
+#include <time.h>
+#endif
+
+#if defined(ARM_DWT_CYCCNT)
+// Cortex-M cycle counter
+static uint32_t defaultClock(void) { return ARM_DWT_CYCCNT; }
+#define DEFAULT_TICKS_PER_SECOND F_CPU
+#elif defined(ARDUINO)
+static uint32_t defaultClock(void) { return micros(); }
+#define DEFAULT_TICKS_PER_SECOND 1000000UL
+#else
+static uint32_t defaultClock(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+#define DEFAULT_TICKS_PER_SECOND 1000000000UL
+#endif
+
+static ADIS16470ClockFn profClock = nullptr;
+static uint32_t profTicksPerSecond = DEFAULT_TICKS_PER_SECOND;
+static ADIS16470Histogram profHistograms[PROF_OPS]; // Updated with interrupts masked
+
+////////////////////////////////////////////////////////////////////////////
+// Replaces the clock used for every measurement.
+////////////////////////////////////////////////////////////////////////////
+// clock - free-running 32-bit clock, or nullptr for the default
+// ticksPerSecond - clock frequency
+////////////////////////////////////////////////////////////////////////////
+void adis16470ProfileSetClock(ADIS16470ClockFn clock, uint32_t ticksPerSecond) {
+  profClock = clock;
+  profTicksPerSecond = clock ? ticksPerSecond : DEFAULT_TICKS_PER_SECOND;
+}
+
+uint32_t adis16470ProfileNow(void) {
+  if (profClock)
+    return profClock();
+#if defined(ARM_DWT_CYCCNT)
+  if (!(ARM_DWT_CTRL & ARM_DWT_CTRL_CYCCNTENA))
+  {
+    // Enable the cycle counter on first use
+    ARM_DEMCR |= ARM_DEMCR_TRCENA;
+    ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+  }
+#endif
+  return defaultClock();
+}
+
+ADIS16470Histogram adis16470ProfileHistogram(int op) {
+  uint32_t irq = adis16470IrqSave();
+  ADIS16470Histogram h = profHistograms[op];
+  adis16470IrqRestore(irq);
+  return h;
+}
+
+void adis16470ProfileRecord(int op, uint32_t ticks) {
+  uint32_t irq = adis16470IrqSave(); // The data ready ISR may record into the same histogram
+  profHistograms[op].record(ticks);
+  adis16470IrqRestore(irq);
+}
+
+void adis16470ProfileDataReady(ADIS16470ProfileLatency &latency) {
+  latency.start = adis16470ProfileNow();
+  latency.pending = true;
+}
+
+void adis16470ProfileDataDone(ADIS16470ProfileLatency &latency) {
+  if (!latency.pending)
+    return;
+  adis16470ProfileRecord(PROF_DR_LATENCY, adis16470ProfileNow() - latency.start);
+  latency.pending = false;
+}
+
+void adis16470ProfileReset(void) {
+  for (int i = 0; i < PROF_OPS; i++)
+  {
+    uint32_t irq = adis16470IrqSave();
+    profHistograms[i] = ADIS16470Histogram();
+    adis16470IrqRestore(irq);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Writes one line per operation with its count and min/mean/p50/p99/max 
+// durations in nanoseconds.
+// Returns the number of characters written (excluding the terminator).
+////////////////////////////////////////////////////////////////////////////
+// buffer - destination
+// size - size of buffer
+////////////////////////////////////////////////////////////////////////////
+size_t adis16470ProfileFormat(char *buffer, size_t size) {
+  static const char *names[PROF_OPS] = { "select", "regRead", "regWrite", "burst", "isr", "drLatency" };
+  size_t used = 0;
+  double nsPerTick = 1e9 / profTicksPerSecond;
+
+  int n = snprintf(buffer, size, "op count min_ns mean_ns p50_ns p99_ns max_ns\n");
+  used += (n > 0) ? n : 0;
+  for (int i = 0; i < PROF_OPS && used < size; i++)
+  {
+    ADIS16470Histogram h = adis16470ProfileHistogram(i);
+    double mean = h.count ? (double)h.sum / h.count : 0;
+    n = snprintf(buffer + used, size - used, "%s %lu %lu %lu %lu %lu %lu\n", names[i],
+                 (unsigned long)h.count, (unsigned long)(h.min * nsPerTick), (unsigned long)(mean * nsPerTick),
+                 (unsigned long)(h.percentile(0.5f) * nsPerTick), (unsigned long)(h.percentile(0.99f) * nsPerTick),
+                 (unsigned long)(h.max * nsPerTick));
+    used += (n > 0) ? n : 0;
+  }
+  return (used < size) ? used : size - 1;
+}
+
+#endif
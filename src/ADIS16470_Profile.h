@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Profile.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Optional hot-path timing instrumentation. When ADIS16470_PROFILE is defined the driver 
+//  records the duration of select(), register reads and writes, burst transfers and the 
+//  data ready ISR (queueBurst()), plus the latency from the data ready edge to decoded data,
+//  into fixed-bucket histograms. Without it every ADIS16470_PROFILE_* macro compiles to 
+//  nothing and no memory is used.
+//
+//  The histograms are shared by every driver instance and are updated from both loop() and
+//  interrupt context, so each update runs with interrupts masked (see ADIS16470_Irq.h; on
+//  cores other than AVR and Cortex-M the mask does not nest inside an ISR). The data ready
+//  edge time is kept per instance.
+//
+//  On Cortex-M cores with a DWT cycle counter (Teensy 3.x/4.x) the counter is used as the 
+//  clock; on other Arduino cores micros(); on a PC CLOCK_MONOTONIC nanoseconds. Any 32-bit 
+//  free-running clock may be injected with adis16470ProfileSetClock().
+//
+//  The Arduino IDE does not pass sketch defines to libraries, so enable profiling by 
+//  uncommenting the define below or adding -DADIS16470_PROFILE to the build flags.
+//  ADIS16470::printProfile() exists on Arduino builds only; elsewhere format the summary 
+//  with adis16470ProfileFormat() and write it out with printf() or similar.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Uncomment to enable profiling
+//#define ADIS16470_PROFILE
+
+// Measured operations
+#define PROF_SELECT      0  //select()
+#define PROF_REG_READ    1  //regRead() and regReadMany()
+#define PROF_REG_WRITE   2  //regWrite()
+#define PROF_BURST       3  //Burst SPI transfer
+#define PROF_ISR         4  //queueBurst() (the data ready ISR)
+#define PROF_DR_LATENCY  5  //Data ready edge to decoded data
+#define PROF_OPS         6
+
+// Log-linear buckets: four per power of two, covering all 32-bit tick counts
+#define PROF_BUCKETS     124
+
+// Free-running 32-bit clock
+typedef uint32_t (*ADIS16470ClockFn)(void);
+
+// Duration histogram in clock ticks
+struct ADIS16470Histogram {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+  uint32_t buckets[PROF_BUCKETS];
+
+  // Adds one duration
+  void record(uint32_t ticks);
+
+  // Upper bound of the bucket holding the given fraction (0-1) of samples
+  uint32_t percentile(float fraction) const;
+};
+
+#if defined(ADIS16470_PROFILE)
+
+// Data ready edge of one driver instance, for PROF_DR_LATENCY
+struct ADIS16470ProfileLatency {
+  volatile uint32_t start;
+  volatile bool pending = false;
+};
+
+// Replaces the clock. ticksPerSecond is used to convert to nanoseconds
+void adis16470ProfileSetClock(ADIS16470ClockFn clock, uint32_t ticksPerSecond);
+
+// Current clock value
+uint32_t adis16470ProfileNow(void);
+
+// Consistent copy of the histogram of one PROF_* operation
+ADIS16470Histogram adis16470ProfileHistogram(int op);
+
+// Adds a duration to an operation's histogram
+void adis16470ProfileRecord(int op, uint32_t ticks);
+
+// Remembers the time of the data ready edge for PROF_DR_LATENCY
+void adis16470ProfileDataReady(ADIS16470ProfileLatency &latency);
+
+// Records PROF_DR_LATENCY for the last data ready edge
+void adis16470ProfileDataDone(ADIS16470ProfileLatency &latency);
+
+// Clears all histograms
+void adis16470ProfileReset(void);
+
+// Writes a text summary (count, min, mean, p50, p99, max in ns per operation). Returns its length
+size_t adis16470ProfileFormat(char *buffer, size_t size);
+
+// Times the enclosing block
+class ADIS16470ProfileScope {
+public:
+  ADIS16470ProfileScope(int op) : _op(op), _start(adis16470ProfileNow()) {}
+  ~ADIS16470ProfileScope() { adis16470ProfileRecord(_op, adis16470ProfileNow() - _start); }
+private:
+  int _op;
+  uint32_t _start;
+};
+
+#define ADIS16470_PROFILE_SCOPE(op)      ADIS16470ProfileScope _profScope(op)
+#define ADIS16470_PROFILE_DATA_READY(latency)  adis16470ProfileDataReady(latency)
+#define ADIS16470_PROFILE_DATA_DONE(latency)   adis16470ProfileDataDone(latency)
+
+#else
+
+#define ADIS16470_PROFILE_SCOPE(op)
+#define ADIS16470_PROFILE_DATA_READY(latency)
+#define ADIS16470_PROFILE_DATA_DONE(latency)
+
+#endif
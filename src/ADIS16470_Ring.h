@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Ring.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Fixed-capacity, allocation-free single-producer/single-consumer ring buffer. The producer
+//  (typically the data ready ISR) and the consumer (typically loop()) may run concurrently
+//  without locks or disabling interrupts. This header has no Arduino dependencies so it may
+//  also be compiled and tested on a PC.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// SPSC ring buffer holding up to N items. N must be a power of two.
+template <typename T, size_t N>
+class ADIS16470Ring {
+
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "ADIS16470Ring capacity must be a power of two");
+
+public:
+  // Producer: returns a slot to fill in place, or nullptr (and counts an overrun) if full
+  T *acquire(void) {
+    uint32_t head = _head; // Only the producer writes _head
+    uint32_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= N)
+    {
+      __atomic_store_n(&_overruns, _overruns + 1, __ATOMIC_RELAXED);
+      return nullptr;
+    }
+    return &_items[head & (N - 1)];
+  }
+
+  // Producer: publishes the slot returned by acquire()
+  void commit(void) {
+    uint32_t head = _head + 1;
+    uint32_t used = head - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+    if (used > _highWater)
+      __atomic_store_n(&_highWater, used, __ATOMIC_RELAXED);
+    __atomic_store_n(&_head, head, __ATOMIC_RELEASE);
+  }
+
+  // Producer: copies an item into the ring. Returns false on overrun
+  bool push(const T &item) {
+    T *slot = acquire();
+    if (slot == nullptr)
+      return false;
+    *slot = item;
+    commit();
+    return true;
+  }
+
+  // Consumer: removes one item. Returns false if the ring is empty
+  bool pop(T &item) {
+    return popBatch(&item, 1) == 1;
+  }
+
+  // Consumer: returns the oldest item to read in place, or nullptr if the ring is empty
+  const T *front(void) {
+    uint32_t tail = _tail; // Only the consumer writes _tail
+    if (__atomic_load_n(&_head, __ATOMIC_ACQUIRE) == tail)
+      return nullptr;
+    return &_items[tail & (N - 1)];
+  }
+
+  // Consumer: frees the slot returned by front()
+  void release(void) {
+    __atomic_store_n(&_tail, _tail + 1, __ATOMIC_RELEASE);
+  }
+
+  // Consumer: removes up to maxItems items. Returns the number removed
+  size_t popBatch(T *items, size_t maxItems) {
+    uint32_t tail = _tail; // Only the consumer writes _tail
+    uint32_t count = __atomic_load_n(&_head, __ATOMIC_ACQUIRE) - tail;
+    if (count > maxItems)
+      count = maxItems;
+    for (uint32_t i = 0; i < count; i++)
+      items[i] = _items[(tail + i) & (N - 1)];
+    __atomic_store_n(&_tail, tail + count, __ATOMIC_RELEASE);
+    return count;
+  }
+
+  // Number of items waiting to be consumed
+  size_t available(void) const {
+    return __atomic_load_n(&_head, __ATOMIC_ACQUIRE) - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+  }
+
+  // Total capacity
+  static size_t capacity(void) { return N; }
+
+  // Number of items dropped because the ring was full
+  uint32_t overruns(void) const { return __atomic_load_n(&_overruns, __ATOMIC_RELAXED); }
+
+  // Largest number of items held at once
+  uint32_t highWater(void) const { return __atomic_load_n(&_highWater, __ATOMIC_RELAXED); }
+
+  // Clears the overrun counter and high-water mark. Call while the producer is idle
+  void clearStats(void) {
+    __atomic_store_n(&_overruns, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_highWater, 0, __ATOMIC_RELAXED);
+  }
+
+private:
+  T _items[N];
+  uint32_t _head = 0; // Free-running write index, owned by the producer
+  uint32_t _tail = 0; // Free-running read index, owned by the consumer
+  uint32_t _overruns = 0;
+  uint32_t _highWater = 0;
+};
@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Scale.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Batch scaling kernels for decoded ADIS16470 burst frames.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ADIS16470_Scale.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Scales count 16-bit burst frames into structure-of-arrays output in a 
+// single pass.
+////////////////////////////////////////////////////////////////////////////
+// frames - decoded frames (see readFrames())
+// count - number of frames
+// out - destination arrays, count floats each
+////////////////////////////////////////////////////////////////////////////
+void adis16470ScaleFrames(const ADIS16470Frame *frames, size_t count, const ADIS16470ScaledData &out) {
+
+  // Local restrict pointers tell the compiler the outputs never alias
+  float * __restrict gx = out.gyroX;
+  float * __restrict gy = out.gyroY;
+  float * __restrict gz = out.gyroZ;
+  float * __restrict ax = out.accelX;
+  float * __restrict ay = out.accelY;
+  float * __restrict az = out.accelZ;
+  float * __restrict t = out.temp;
+
+  for (size_t i = 0; i < count; i++)
+  {
+    gx[i] = (float)frames[i].gyro[0] * GYRO_SCALE;
+    gy[i] = (float)frames[i].gyro[1] * GYRO_SCALE;
+    gz[i] = (float)frames[i].gyro[2] * GYRO_SCALE;
+    ax[i] = (float)frames[i].accl[0] * ACCEL_SCALE;
+    ay[i] = (float)frames[i].accl[1] * ACCEL_SCALE;
+    az[i] = (float)frames[i].accl[2] * ACCEL_SCALE;
+    t[i] = (float)frames[i].temp * TEMP_SCALE;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Scales count 32-bit burst frames into structure-of-arrays output in a 
+// single pass.
+////////////////////////////////////////////////////////////////////////////
+// frames - decoded frames (see burst32())
+// count - number of frames
+// out - destination arrays, count floats each
+////////////////////////////////////////////////////////////////////////////
+void adis16470ScaleFrames32(const ADIS16470Frame32 *frames, size_t count, const ADIS16470ScaledData &out) {
+
+  float * __restrict gx = out.gyroX;
+  float * __restrict gy = out.gyroY;
+  float * __restrict gz = out.gyroZ;
+  float * __restrict ax = out.accelX;
+  float * __restrict ay = out.accelY;
+  float * __restrict az = out.accelZ;
+  float * __restrict t = out.temp;
+
+  for (size_t i = 0; i < count; i++)
+  {
+    gx[i] = (float)frames[i].gyro[0] * GYRO_SCALE32;
+    gy[i] = (float)frames[i].gyro[1] * GYRO_SCALE32;
+    gz[i] = (float)frames[i].gyro[2] * GYRO_SCALE32;
+    ax[i] = (float)frames[i].accl[0] * ACCEL_SCALE32;
+    ay[i] = (float)frames[i].accl[1] * ACCEL_SCALE32;
+    az[i] = (float)frames[i].accl[2] * ACCEL_SCALE32;
+    t[i] = (float)frames[i].temp * TEMP_SCALE;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Scales count 16-bit delta angle/delta velocity frames into 
+// structure-of-arrays output in a single pass.
+////////////////////////////////////////////////////////////////////////////
+// frames - decoded frames (see deltaBurst())
+// count - number of frames
+// out - destination arrays, count floats each
+////////////////////////////////////////////////////////////////////////////
+void adis16470ScaleDeltaFrames(const ADIS16470DeltaFrame *frames, size_t count, const ADIS16470ScaledData &out) {
+
+  float * __restrict dax = out.gyroX;
+  float * __restrict day = out.gyroY;
+  float * __restrict daz = out.gyroZ;
+  float * __restrict dvx = out.accelX;
+  float * __restrict dvy = out.accelY;
+  float * __restrict dvz = out.accelZ;
+  float * __restrict t = out.temp;
+
+  for (size_t i = 0; i < count; i++)
+  {
+    dax[i] = (float)frames[i].deltAng[0] * DELTANG_SCALE;
+    day[i] = (float)frames[i].deltAng[1] * DELTANG_SCALE;
+    daz[i] = (float)frames[i].deltAng[2] * DELTANG_SCALE;
+    dvx[i] = (float)frames[i].deltVel[0] * DELTVEL_SCALE;
+    dvy[i] = (float)frames[i].deltVel[1] * DELTVEL_SCALE;
+    dvz[i] = (float)frames[i].deltVel[2] * DELTVEL_SCALE;
+    t[i] = (float)frames[i].temp * TEMP_SCALE;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Scales count 32-bit delta angle/delta velocity frames into 
+// structure-of-arrays output in a single pass.
+////////////////////////////////////////////////////////////////////////////
+// frames - decoded frames (see deltaBurst32())
+// count - number of frames
+// out - destination arrays, count floats each
+////////////////////////////////////////////////////////////////////////////
+void adis16470ScaleDeltaFrames32(const ADIS16470DeltaFrame32 *frames, size_t count, const ADIS16470ScaledData &out) {
+
+  float * __restrict dax = out.gyroX;
+  float * __restrict day = out.gyroY;
+  float * __restrict daz = out.gyroZ;
+  float * __restrict dvx = out.accelX;
+  float * __restrict dvy = out.accelY;
+  float * __restrict dvz = out.accelZ;
+  float * __restrict t = out.temp;
+
+  for (size_t i = 0; i < count; i++)
+  {
+    dax[i] = (float)frames[i].deltAng[0] * DELTANG_SCALE32;
+    day[i] = (float)frames[i].deltAng[1] * DELTANG_SCALE32;
+    daz[i] = (float)frames[i].deltAng[2] * DELTANG_SCALE32;
+    dvx[i] = (float)frames[i].deltVel[0] * DELTVEL_SCALE32;
+    dvy[i] = (float)frames[i].deltVel[1] * DELTVEL_SCALE32;
+    dvz[i] = (float)frames[i].deltVel[2] * DELTVEL_SCALE32;
+    t[i] = (float)frames[i].temp * TEMP_SCALE;
+  }
+}
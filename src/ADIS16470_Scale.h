@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Scale.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Single-precision scale factors and batch scaling kernels which convert decoded burst 
+//  frames into structure-of-arrays float output in one pass. Only float math is used, so on 
+//  a Cortex-M4F every conversion maps to VCVT/VMUL instead of soft-float double routines, and
+//  on a PC the loops auto-vectorize. This header has no Arduino dependencies.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ADIS16470_Device.h"
+
+// Sensitivities of the 16-bit outputs of ADIS16470_DEVICE (ADIS16470: 0.00125, 0.1, 0.1, 0.061, 0.01221)
+#define ACCEL_SCALE    (ADIS16470_DEVICE::accelScale)          // g/LSB
+#define GYRO_SCALE     (ADIS16470_DEVICE::gyroScale)           // deg/sec/LSB
+#define TEMP_SCALE     (ADIS16470_DEVICE::tempScale)           // deg C/LSB
+#define DELTANG_SCALE  (ADIS16470_DEVICE::deltaAngleScale)     // degrees/LSB
+#define DELTVEL_SCALE  (ADIS16470_DEVICE::deltaVelocityScale)  // m/sec/LSB
+
+// Sensitivities of the 32-bit (OUT:LOW) outputs
+#define ACCEL_SCALE32    (ACCEL_SCALE / 65536.0f)
+#define GYRO_SCALE32     (GYRO_SCALE / 65536.0f)
+#define DELTANG_SCALE32  (DELTANG_SCALE / 65536.0f)
+#define DELTVEL_SCALE32  (DELTVEL_SCALE / 65536.0f)
+
+// Destination arrays for the adis16470Scale*() kernels. Each must hold count floats
+// and must not overlap the others.
+struct ADIS16470ScaledData {
+  float *gyroX;
+  float *gyroY;
+  float *gyroZ;
+  float *accelX;
+  float *accelY;
+  float *accelZ;
+  float *temp;
+};
+
+// Scales count 16-bit burst frames into structure-of-arrays output
+void adis16470ScaleFrames(const ADIS16470Frame *frames, size_t count, const ADIS16470ScaledData &out);
+
+// Scales count 32-bit burst frames into structure-of-arrays output
+void adis16470ScaleFrames32(const ADIS16470Frame32 *frames, size_t count, const ADIS16470ScaledData &out);
+
+// Scales count 16-bit delta frames. gyroX-Z receive delta angles (degrees), accelX-Z delta velocities (m/sec)
+void adis16470ScaleDeltaFrames(const ADIS16470DeltaFrame *frames, size_t count, const ADIS16470ScaledData &out);
+
+// Scales count 32-bit delta frames, with the same outputs as adis16470ScaleDeltaFrames()
+void adis16470ScaleDeltaFrames32(const ADIS16470DeltaFrame32 *frames, size_t count, const ADIS16470ScaledData &out);
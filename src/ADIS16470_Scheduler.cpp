@@ -0,0 +1,184 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Scheduler.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Shared-bus transaction scheduler for several ADIS1647x devices.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ADIS16470_Scheduler.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Constructor
+////////////////////////////////////////////////////////////////////////////
+// clock - free-running 32-bit clock used for latency measurements
+////////////////////////////////////////////////////////////////////////////
+ADIS16470Scheduler::ADIS16470Scheduler(ADIS16470ClockFn clock) {
+  _clock = clock;
+  for (int i = 0; i < SCHED_MAX_BUSES; i++)
+    _buses[i].busy = false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Registers a device. Call before any data ready interrupt is attached.
+// Returns the device number passed to dataReady(), or -1 if there is no 
+// room or the bus number is out of range.
+////////////////////////////////////////////////////////////////////////////
+// bus - bus number (0 to SCHED_MAX_BUSES - 1); devices on one bus are serialized
+// service - performs the device's transaction
+// context - passed to service
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470Scheduler::addDevice(uint8_t bus, ADIS16470ServiceFn service, void *context) {
+  if (_deviceCount >= SCHED_MAX_DEVICES || bus >= SCHED_MAX_BUSES)
+    return -1;
+  Device &d = _devices[_deviceCount];
+  d.service = service;
+  d.context = context;
+  d.bus = bus;
+  d.queued = false;
+  d.edge = 0;
+  d.readStart = 0;
+  d.read = false;
+  d.stats = ADIS16470DeviceStats();
+  return _deviceCount++;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Records a data ready edge. If the device is still waiting for its 
+// previous sample, that sample is lost: the drop is counted and the edge
+// time is moved to the new sample.
+////////////////////////////////////////////////////////////////////////////
+// device - device number from addDevice()
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Scheduler::dataReady(uint8_t device) {
+  Device &d = _devices[device];
+  d.edge = _clock();
+  if (d.queued)
+  {
+    d.stats.dropped++;
+    return;
+  }
+  d.queued = true;
+  _buses[d.bus].queue.push(device); // Never full: each device is queued at most once
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Starts the next pending transaction on every idle bus. Each pass starts
+// at most one transaction per bus, and passes repeat until no bus can 
+// start another, so blocking transactions on one bus do not hold back an
+// asynchronous bus behind it.
+// Returns the number of transactions started.
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470Scheduler::poll(void) {
+  int started = 0;
+  bool again = true;
+  while (again)
+  {
+    again = false;
+    for (int b = 0; b < SCHED_MAX_BUSES; b++)
+    {
+      if (startNext(_buses[b]))
+      {
+        started++;
+        again = true;
+      }
+    }
+  }
+  return started;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Starts the oldest pending transaction on an idle bus. The edge time is 
+// taken and the queued flag cleared with interrupts masked, so an edge 
+// lands either before the claim (the transaction reads that newer sample
+// and is timed from it) or after it (a new sample). An entry whose edge 
+// came no later than the start of the device's previous transaction was 
+// already read by it: it is skipped, and the older sample it replaced is 
+// counted as dropped.
+// Returns true if a transaction was started.
+////////////////////////////////////////////////////////////////////////////
+bool ADIS16470Scheduler::startNext(Bus &bus) {
+  uint8_t device;
+  while (!bus.busy && bus.queue.pop(device))
+  {
+    Device &d = _devices[device];
+
+    // Claim the sample
+    uint32_t irq = adis16470IrqSave();
+    uint32_t edge = d.edge;
+    d.queued = false; // An edge from now on is a new sample
+    adis16470IrqRestore(irq);
+
+    if (d.read && (int32_t)(edge - d.readStart) <= 0)
+    {
+      d.stats.dropped++; // Read early by the previous transaction
+      continue;
+    }
+
+    bus.busy = true;
+    bus.device = device;
+    bus.edge = edge;
+    d.readStart = _clock(); // Edges up to here are part of this read
+    d.read = true;
+    if (d.service(d.context))
+      finish(bus);
+    return true;
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Marks the asynchronous transaction on a bus as finished. The next 
+// pending device is started by the following poll().
+////////////////////////////////////////////////////////////////////////////
+// bus - bus number
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Scheduler::complete(uint8_t bus) {
+  if (bus < SCHED_MAX_BUSES && _buses[bus].busy)
+    finish(_buses[bus]);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Updates the latency counters of the device just serviced on a bus and 
+// releases the bus.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Scheduler::finish(Bus &bus) {
+  ADIS16470DeviceStats &s = _devices[bus.device].stats;
+  uint32_t latency = _clock() - bus.edge;
+  if (s.serviced == 0 || latency < s.latencyMin)
+    s.latencyMin = latency;
+  if (latency > s.latencyMax)
+    s.latencyMax = latency;
+  s.latencySum += latency;
+  s.serviced++;
+  bus.busy = false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Returns the number of devices waiting for service on all buses.
+////////////////////////////////////////////////////////////////////////////
+size_t ADIS16470Scheduler::pending(void) const {
+  size_t n = 0;
+  for (int b = 0; b < SCHED_MAX_BUSES; b++)
+    n += _buses[b].queue.available();
+  return n;
+}
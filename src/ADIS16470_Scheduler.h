@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Scheduler.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Shared-bus transaction scheduler for several ADIS1647x devices. Each device's data ready 
+//  ISR calls dataReady(); poll() then services pending devices in arrival order, one 
+//  transaction at a time per SPI bus, so devices on the same bus never collide while devices
+//  on different buses may be serviced concurrently. A data ready edge that arrives before 
+//  the previous one was serviced means the sensor overwrote that sample, and is counted as a 
+//  drop. This header has no Arduino dependencies so it may be exercised on a PC with 
+//  simulated devices.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ADIS16470_Irq.h"
+#include "ADIS16470_Ring.h"
+#include "ADIS16470_Profile.h"
+
+// Capacity limits
+#define SCHED_MAX_DEVICES  8
+#define SCHED_MAX_BUSES    4
+
+// Performs the transaction for a device. Returns true if it completed, or false if it 
+// continues asynchronously and complete() will be called for its bus
+typedef bool (*ADIS16470ServiceFn)(void *context);
+
+// Per-device counters. Latency is measured in clock ticks from the data ready edge to the
+// end of the transaction
+struct ADIS16470DeviceStats {
+  uint32_t serviced;
+  uint32_t dropped;
+  uint32_t latencyMin;
+  uint32_t latencyMax;
+  uint64_t latencySum;
+};
+
+class ADIS16470Scheduler {
+
+public:
+  // clock - free-running 32-bit clock used to time stamp data ready edges (e.g. micros)
+  ADIS16470Scheduler(ADIS16470ClockFn clock);
+
+  // Registers a device on a bus. Returns its device number, or -1 if full
+  int addDevice(uint8_t bus, ADIS16470ServiceFn service, void *context);
+
+  // Call from the device's data ready ISR. ISRs calling this must not preempt each other
+  void dataReady(uint8_t device);
+
+  // Starts transactions on every idle bus. Returns the number started
+  int poll(void);
+
+  // Call when an asynchronous transaction on a bus finishes
+  void complete(uint8_t bus);
+
+  // Number of devices waiting for service
+  size_t pending(void) const;
+
+  // Counters for one device
+  const ADIS16470DeviceStats &stats(uint8_t device) const { return _devices[device].stats; }
+
+private:
+  struct Device {
+    ADIS16470ServiceFn service;
+    void *context;
+    uint8_t bus;
+    volatile bool queued;     // Waiting in its bus queue
+    volatile uint32_t edge;   // Time of the latest data ready edge
+    uint32_t readStart;       // Time the last transaction started
+    bool read;                // readStart is valid
+    ADIS16470DeviceStats stats;
+  };
+
+  struct Bus {
+    ADIS16470Ring<uint8_t, SCHED_MAX_DEVICES> queue; // Devices in data ready order
+    volatile bool busy;
+    uint8_t device;           // Device being serviced
+    uint32_t edge;            // Data ready time of the sample being serviced
+  };
+
+  // Starts the oldest pending transaction on an idle bus. Returns true if one was started
+  bool startNext(Bus &bus);
+
+  // Records the latency of the transaction that just finished on a bus
+  void finish(Bus &bus);
+
+  ADIS16470ClockFn _clock;
+  Device _devices[SCHED_MAX_DEVICES];
+  Bus _buses[SCHED_MAX_BUSES];
+  uint8_t _deviceCount = 0;
+};
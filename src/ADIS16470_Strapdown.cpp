@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Strapdown.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Strapdown attitude and velocity integration from delta angle/delta velocity burst frames.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include "ADIS16470_Strapdown.h"
+#include "ADIS16470_Scale.h"
+
+// Frame LSB to radians and m/sec
+#define DELTANG_RAD    (DELTANG_SCALE * 0.017453292f)
+#define DELTANG_RAD32  (DELTANG_SCALE32 * 0.017453292f)
+
+// c = a x b
+static inline void cross(const float *a, const float *b, float *c) {
+  c[0] = a[1] * b[2] - a[2] * b[1];
+  c[1] = a[2] * b[0] - a[0] * b[2];
+  c[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Constructor
+////////////////////////////////////////////////////////////////////////////
+ADIS16470Strapdown::ADIS16470Strapdown() {
+  _dt = 1.0f / 2000.0f;
+  setAttitude(1.0f, 0.0f, 0.0f, 0.0f);
+  setVelocity(0.0f, 0.0f, 0.0f);
+  setGravity(0.0f, 0.0f, STRAPDOWN_GRAVITY);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the attitude and restarts the coning/sculling history. Returns 1,
+// or -1 for a zero quaternion.
+////////////////////////////////////////////////////////////////////////////
+// w, x, y, z - body-to-navigation quaternion
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470Strapdown::setAttitude(float w, float x, float y, float z) {
+  float n = w * w + x * x + y * y + z * z;
+  if (!(n > 0.0f))
+    return -1;
+  n = 1.0f / sqrtf(n);
+  _q[0] = w * n;
+  _q[1] = x * n;
+  _q[2] = y * n;
+  _q[3] = z * n;
+  for (int i = 0; i < 3; i++)
+  {
+    _prevAngle[i] = 0.0f;
+    _prevVelocity[i] = 0.0f;
+  }
+  _renormCount = 0;
+  _samples = 0;
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the navigation-frame velocity.
+////////////////////////////////////////////////////////////////////////////
+// vx, vy, vz - velocity, m/sec
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470Strapdown::setVelocity(float vx, float vy, float vz) {
+  _v[0] = vx;
+  _v[1] = vy;
+  _v[2] = vz;
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the navigation-frame gravity vector added to the velocity each 
+// sample. Use (0, 0, 0) to integrate specific force only.
+////////////////////////////////////////////////////////////////////////////
+// gx, gy, gz - gravity, m/sec^2
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470Strapdown::setGravity(float gx, float gy, float gz) {
+  _g[0] = gx;
+  _g[1] = gy;
+  _g[2] = gz;
+  for (int i = 0; i < 3; i++)
+    _gdt[i] = _g[i] * _dt;
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the time between samples. Match the sensor's output rate after 
+// DEC_RATE. Returns 1, or -1 if dt is not positive.
+////////////////////////////////////////////////////////////////////////////
+// dt - sample period, seconds
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470Strapdown::setSamplePeriod(float dt) {
+  if (!(dt > 0.0f))
+    return -1;
+  _dt = dt;
+  return setGravity(_g[0], _g[1], _g[2]);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Integrates one sample. The rotation vector gets the two-sample coning 
+// term (1/12) a[k-1] x a[k]. The velocity increment is rotated to the 
+// start of the interval with (1/2) a x v and gets the sculling term 
+// (1/12) (a[k-1] x v[k] + v[k-1] x a[k]). The quaternion is advanced with
+// fourth-order series for cos(|a|/2) and sin(|a|/2)/|a|. These are 
+// accurate to float precision for rotations below 0.1 rad per sample,
+// which is 11000 deg/sec at 2000 SPS. Every STRAPDOWN_RENORM_INTERVAL 
+// samples a first-order correction (no square root) pulls the quaternion
+// back to unit length.
+////////////////////////////////////////////////////////////////////////////
+// deltaAngle - body rotation over the sample, radians
+// deltaVelocity - body velocity change over the sample, m/sec
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Strapdown::update(const float deltaAngle[3], const float deltaVelocity[3]) {
+
+  const float *a = deltaAngle;
+  const float *dv = deltaVelocity;
+  float t1[3], t2[3], t3[3];
+
+  // Coning-corrected rotation vector
+  float r[3];
+  cross(_prevAngle, a, t1);
+  for (int i = 0; i < 3; i++)
+    r[i] = a[i] + (1.0f / 12.0f) * t1[i];
+
+  // Rotation and sculling corrected velocity increment, body frame at the start of the sample
+  float u[3];
+  cross(a, dv, t1);
+  cross(_prevAngle, dv, t2);
+  cross(_prevVelocity, a, t3);
+  for (int i = 0; i < 3; i++)
+    u[i] = dv[i] + 0.5f * t1[i] + (1.0f / 12.0f) * (t2[i] + t3[i]);
+
+  // Rotate into the navigation frame with the attitude at the start of the sample:
+  // u' = u + 2w(q x u) + 2q x (q x u)
+  const float *qv = &_q[1];
+  cross(qv, u, t1);
+  for (int i = 0; i < 3; i++)
+    t1[i] *= 2.0f;
+  cross(qv, t1, t2);
+  for (int i = 0; i < 3; i++)
+    _v[i] += u[i] + _q[0] * t1[i] + t2[i] + _gdt[i];
+
+  // Quaternion of the rotation vector
+  float n2 = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+  float c = 1.0f - n2 * (1.0f / 8.0f) + n2 * n2 * (1.0f / 384.0f);
+  float s = 0.5f - n2 * (1.0f / 48.0f) + n2 * n2 * (1.0f / 3840.0f);
+  float dq[4] = { c, s * r[0], s * r[1], s * r[2] };
+
+  // q = q * dq
+  float q0 = _q[0], q1 = _q[1], q2 = _q[2], q3 = _q[3];
+  _q[0] = q0 * dq[0] - q1 * dq[1] - q2 * dq[2] - q3 * dq[3];
+  _q[1] = q0 * dq[1] + q1 * dq[0] + q2 * dq[3] - q3 * dq[2];
+  _q[2] = q0 * dq[2] - q1 * dq[3] + q2 * dq[0] + q3 * dq[1];
+  _q[3] = q0 * dq[3] + q1 * dq[2] - q2 * dq[1] + q3 * dq[0];
+
+  if (++_renormCount >= STRAPDOWN_RENORM_INTERVAL)
+  {
+    float k = 1.5f - 0.5f * (_q[0] * _q[0] + _q[1] * _q[1] + _q[2] * _q[2] + _q[3] * _q[3]);
+    for (int i = 0; i < 4; i++)
+      _q[i] *= k;
+    _renormCount = 0;
+  }
+
+  for (int i = 0; i < 3; i++)
+  {
+    _prevAngle[i] = a[i];
+    _prevVelocity[i] = dv[i];
+  }
+  _samples++;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Scales and integrates one 16-bit delta burst frame.
+////////////////////////////////////////////////////////////////////////////
+// frame - decoded delta burst
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Strapdown::update(const ADIS16470DeltaFrame &frame) {
+  float a[3], dv[3];
+  for (int i = 0; i < 3; i++)
+  {
+    a[i] = frame.deltAng[i] * DELTANG_RAD;
+    dv[i] = frame.deltVel[i] * DELTVEL_SCALE;
+  }
+  update(a, dv);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Scales and integrates one 32-bit delta burst frame.
+////////////////////////////////////////////////////////////////////////////
+// frame - decoded 32-bit delta burst
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470Strapdown::update(const ADIS16470DeltaFrame32 &frame) {
+  float a[3], dv[3];
+  for (int i = 0; i < 3; i++)
+  {
+    a[i] = (float)frame.deltAng[i] * DELTANG_RAD32;
+    dv[i] = (float)frame.deltVel[i] * DELTVEL_SCALE32;
+  }
+  update(a, dv);
+}
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Strapdown.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Strapdown attitude and velocity integration from delta angle/delta velocity burst 
+//  frames (MSC_CTRL BURST_SEL). Each sample applies a two-sample coning correction to the
+//  rotation vector, a rotation and sculling correction to the velocity increment, and a
+//  quaternion update whose sine and cosine come from truncated series. There is no 
+//  trigonometry, square root or division per sample. Everything is single precision, 
+//  so each update is a fixed sequence of FPU operations on a Cortex-M4F and can run at 
+//  the full output data rate from the data ready ISR or the frame queue. This header has 
+//  no Arduino dependencies; extras/bench/ADIS16470_StrapdownBench.cpp checks it against 
+//  analytic motion.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ADIS16470_Types.h"
+
+// Samples between quaternion renormalizations
+#define STRAPDOWN_RENORM_INTERVAL 64
+
+// Standard gravity, m/sec^2
+#define STRAPDOWN_GRAVITY 9.80665f
+
+class ADIS16470Strapdown {
+
+public:
+  // Starts level (identity attitude), at rest, with NED gravity and a 2000 SPS sample period
+  ADIS16470Strapdown();
+
+  // Set the body-to-navigation attitude quaternion (w, x, y, z). It is normalized
+  int setAttitude(float w, float x, float y, float z);
+
+  // Set the navigation-frame velocity, m/sec
+  int setVelocity(float vx, float vy, float vz);
+
+  // Set the navigation-frame gravity vector, m/sec^2. Default (0, 0, STRAPDOWN_GRAVITY) for NED
+  int setGravity(float gx, float gy, float gz);
+
+  // Set the time between samples, seconds (1 / ODR)
+  int setSamplePeriod(float dt);
+
+  // Integrate one sample given in radians and m/sec
+  void update(const float deltaAngle[3], const float deltaVelocity[3]);
+
+  // Integrate one 16-bit delta burst frame
+  void update(const ADIS16470DeltaFrame &frame);
+
+  // Integrate one 32-bit delta burst frame
+  void update(const ADIS16470DeltaFrame32 &frame);
+
+  // Attitude quaternion (w, x, y, z), body to navigation frame
+  const float *attitude(void) const { return _q; }
+
+  // Navigation-frame velocity, m/sec
+  const float *velocity(void) const { return _v; }
+
+  // Number of samples integrated
+  uint32_t samples(void) const { return _samples; }
+
+private:
+  float _q[4];
+  float _v[3];
+  float _gdt[3];            // Gravity times the sample period
+  float _g[3];
+  float _dt;
+  float _prevAngle[3];      // Previous sample, for coning and sculling
+  float _prevVelocity[3];
+  uint16_t _renormCount;
+  uint32_t _samples;
+};
@@ -0,0 +1,418 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Stream.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Binary stream encoder and decoder for ADIS16470 burst data. See ADIS16470_Stream.h for
+//  the packet layout.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include "ADIS16470_Stream.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Returns true if field i is 32 bits wide for the given sample type
+////////////////////////////////////////////////////////////////////////////
+static inline bool isWideField(uint8_t type, int i) {
+  return (type >= STREAM_INERTIAL32) && (i >= 1) && (i <= 6);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Copies a frame into STREAM_FIELDS raw field values
+////////////////////////////////////////////////////////////////////////////
+template <typename Frame, typename Value>
+static void toFields(const Frame &frame, const Value *rot, const Value *lin, uint32_t *fields) {
+  uint32_t mask = (sizeof(Value) == 2) ? 0xFFFF : 0xFFFFFFFF;
+  fields[0] = frame.diagStat;
+  for (int i = 0; i < 3; i++)
+  {
+    fields[1 + i] = (uint32_t)rot[i] & mask;
+    fields[4 + i] = (uint32_t)lin[i] & mask;
+  }
+  fields[7] = (uint16_t)frame.temp;
+  fields[8] = frame.timeStamp;
+  fields[9] = frame.checksum;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Copies STREAM_FIELDS raw field values into a frame
+////////////////////////////////////////////////////////////////////////////
+template <typename Frame, typename Value>
+static void fromFields(const uint32_t *fields, Frame *frame, Value *rot, Value *lin) {
+  frame->diagStat = fields[0];
+  for (int i = 0; i < 3; i++)
+  {
+    rot[i] = (Value)fields[1 + i];
+    lin[i] = (Value)fields[4 + i];
+  }
+  frame->temp = (int16_t)fields[7];
+  frame->timeStamp = fields[8];
+  frame->checksum = fields[9];
+}
+
+void adis16470FieldsToFrame(const uint32_t *fields, ADIS16470Frame *frame) {
+  fromFields(fields, frame, frame->gyro, frame->accl);
+}
+
+void adis16470FieldsToFrame(const uint32_t *fields, ADIS16470DeltaFrame *frame) {
+  fromFields(fields, frame, frame->deltAng, frame->deltVel);
+}
+
+void adis16470FieldsToFrame(const uint32_t *fields, ADIS16470Frame32 *frame) {
+  fromFields(fields, frame, frame->gyro, frame->accl);
+}
+
+void adis16470FieldsToFrame(const uint32_t *fields, ADIS16470DeltaFrame32 *frame) {
+  fromFields(fields, frame, frame->deltAng, frame->deltVel);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Computes the CRC-16/CCITT of a buffer using a 16-entry nibble table.
+// Returns the updated CRC.
+////////////////////////////////////////////////////////////////////////////
+// data - bytes to process
+// len - number of bytes
+// crc - starting value (0xFFFF, or a previous result to continue)
+////////////////////////////////////////////////////////////////////////////
+uint16_t adis16470Crc16(const uint8_t *data, size_t len, uint16_t crc) {
+  static const uint16_t table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+  };
+  for (size_t i = 0; i < len; i++)
+  {
+    crc = (crc << 4) ^ table[(crc >> 12) ^ (data[i] >> 4)];
+    crc = (crc << 4) ^ table[(crc >> 12) ^ (data[i] & 0x0F)];
+  }
+  return crc;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Selects the sample type and payload packing and resets the sequence 
+// number. Any open packet is discarded.
+////////////////////////////////////////////////////////////////////////////
+// type - STREAM_INERTIAL16, STREAM_DELTA16, STREAM_INERTIAL32 or STREAM_DELTA32
+// packed - use delta/varint packing when true
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470StreamEncoder::begin(uint8_t type, bool packed) {
+  _flags = (type & STREAM_TYPE_MASK) | (packed ? STREAM_PACKED : 0);
+  _sequence = 0;
+  _count = 0;
+  _length = STREAM_HEADER_BYTES;
+  _finished = false;
+}
+
+bool ADIS16470StreamEncoder::add(const ADIS16470Frame &frame) {
+  uint32_t fields[STREAM_FIELDS];
+  toFields(frame, frame.gyro, frame.accl, fields);
+  return addFields(fields);
+}
+
+bool ADIS16470StreamEncoder::add(const ADIS16470DeltaFrame &frame) {
+  uint32_t fields[STREAM_FIELDS];
+  toFields(frame, frame.deltAng, frame.deltVel, fields);
+  return addFields(fields);
+}
+
+bool ADIS16470StreamEncoder::add(const ADIS16470Frame32 &frame) {
+  uint32_t fields[STREAM_FIELDS];
+  toFields(frame, frame.gyro, frame.accl, fields);
+  return addFields(fields);
+}
+
+bool ADIS16470StreamEncoder::add(const ADIS16470DeltaFrame32 &frame) {
+  uint32_t fields[STREAM_FIELDS];
+  toFields(frame, frame.deltAng, frame.deltVel, fields);
+  return addFields(fields);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Appends one sample to the open packet, starting a new packet if the 
+// previous one was finished. A full packet is finished automatically.
+// Returns true when the packet is full and should be sent.
+////////////////////////////////////////////////////////////////////////////
+// fields - STREAM_FIELDS raw field values
+////////////////////////////////////////////////////////////////////////////
+bool ADIS16470StreamEncoder::addFields(const uint32_t *fields) {
+
+  if (_finished || _count >= ADIS16470_STREAM_SAMPLES)
+  {
+    // Start the next packet
+    _count = 0;
+    _length = STREAM_HEADER_BYTES;
+    _finished = false;
+  }
+
+  uint8_t type = _flags & STREAM_TYPE_MASK;
+  uint8_t *out = _packet + _length;
+
+  for (int i = 0; i < STREAM_FIELDS; i++)
+  {
+    bool wide = isWideField(type, i);
+    if (_flags & STREAM_PACKED)
+    {
+      // Signed difference from the previous sample at the field's own width
+      uint32_t prev = (_count == 0) ? 0 : _prev[i];
+      int32_t diff = wide ? (int32_t)(fields[i] - prev) : (int16_t)(fields[i] - prev);
+      uint32_t zigzag = ((uint32_t)diff << 1) ^ (uint32_t)(diff >> 31);
+      while (zigzag >= 0x80)
+      {
+        *out++ = (zigzag & 0x7F) | 0x80;
+        zigzag >>= 7;
+      }
+      *out++ = zigzag;
+      _prev[i] = fields[i];
+    }
+    else
+    {
+      *out++ = fields[i] & 0xFF;
+      *out++ = (fields[i] >> 8) & 0xFF;
+      if (wide)
+      {
+        *out++ = (fields[i] >> 16) & 0xFF;
+        *out++ = (fields[i] >> 24) & 0xFF;
+      }
+    }
+  }
+
+  _length = out - _packet;
+  _count++;
+
+  if (_count < ADIS16470_STREAM_SAMPLES)
+    return false;
+  finish();
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Writes the header and CRC of the open packet. Calling it again before 
+// the next add() returns the same packet.
+// Returns the packet length in bytes, or 0 if no samples were added.
+////////////////////////////////////////////////////////////////////////////
+size_t ADIS16470StreamEncoder::finish(void) {
+
+  if (_count == 0)
+    return 0;
+  if (_finished)
+    return _length;
+
+  size_t payload = _length - STREAM_HEADER_BYTES;
+  _packet[0] = STREAM_SYNC0;
+  _packet[1] = STREAM_SYNC1;
+  _packet[2] = STREAM_VERSION;
+  _packet[3] = _flags;
+  _packet[4] = _sequence & 0xFF;
+  _packet[5] = _sequence >> 8;
+  _packet[6] = _count;
+  _packet[7] = payload & 0xFF;
+  _packet[8] = payload >> 8;
+
+  uint16_t crc = adis16470Crc16(_packet + 2, _length - 2);
+  _packet[_length++] = crc & 0xFF;
+  _packet[_length++] = crc >> 8;
+
+  _sequence += _count;
+  _finished = true;
+
+  return _length;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Constructor
+////////////////////////////////////////////////////////////////////////////
+// handler - called for every decoded sample
+// context - passed back to the handler
+////////////////////////////////////////////////////////////////////////////
+ADIS16470StreamDecoder::ADIS16470StreamDecoder(ADIS16470StreamHandler handler, void *context) {
+  _handler = handler;
+  _context = context;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Feeds received bytes into the decoder. Complete packets are validated and
+// their samples passed to the handler as soon as they arrive.
+////////////////////////////////////////////////////////////////////////////
+// data - received bytes
+// len - number of bytes
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470StreamDecoder::feed(const uint8_t *data, size_t len) {
+  while (len > 0)
+  {
+    size_t n = sizeof(_buffer) - _length;
+    if (n > len)
+      n = len;
+    memcpy(_buffer + _length, data, n);
+    _length += n;
+    data += n;
+    len -= n;
+    parse();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Discards n bytes from the front of the receive buffer.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470StreamDecoder::consume(size_t n) {
+  memmove(_buffer, _buffer + n, _length - n);
+  _length -= n;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decodes every complete packet at the front of the receive buffer. On a 
+// bad header or CRC one byte is dropped and the search for the next sync 
+// pattern starts again.
+////////////////////////////////////////////////////////////////////////////
+void ADIS16470StreamDecoder::parse(void) {
+
+  while (_length >= 2)
+  {
+    // Find the sync pattern
+    size_t skip = 0;
+    while (skip + 1 < _length && !(_buffer[skip] == STREAM_SYNC0 && _buffer[skip + 1] == STREAM_SYNC1))
+      skip++;
+    if (skip > 0)
+    {
+      _stats.bytesSkipped += skip;
+      consume(skip);
+    }
+    if (_length < STREAM_HEADER_BYTES)
+      return;
+
+    uint8_t flags = _buffer[3];
+    uint16_t sequence = _buffer[4] | (_buffer[5] << 8);
+    uint8_t count = _buffer[6];
+    size_t payload = _buffer[7] | (_buffer[8] << 8);
+    if (_buffer[2] != STREAM_VERSION || count == 0 || count > ADIS16470_STREAM_SAMPLES ||
+        payload > STREAM_MAX_PAYLOAD)
+    {
+      _stats.formatErrors++;
+      _stats.bytesSkipped++;
+      consume(1);
+      continue;
+    }
+
+    size_t total = STREAM_HEADER_BYTES + payload + STREAM_CRC_BYTES;
+    if (_length < total)
+      return; // Wait for the rest of the packet
+
+    uint16_t crc = _buffer[total - 2] | (_buffer[total - 1] << 8);
+    if (adis16470Crc16(_buffer + 2, total - 4) != crc)
+    {
+      _stats.crcErrors++;
+      _stats.bytesSkipped++;
+      consume(1);
+      continue;
+    }
+
+    if (decodePayload(flags, sequence, count, _buffer + STREAM_HEADER_BYTES, payload))
+    {
+      _stats.packets++;
+      if (_synced)
+        _stats.samplesLost += (uint16_t)(sequence - _nextSequence);
+      _nextSequence = sequence + count;
+      _synced = true;
+    }
+    else
+      _stats.formatErrors++;
+
+    consume(total);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Reads the fields of one sample from a payload. For packed payloads 
+// fields must hold the previous sample (zero for the first).
+// Returns false if the payload ends early or holds an overlong varint.
+////////////////////////////////////////////////////////////////////////////
+// flags - packet flags (sample type and packing)
+// in - read position, advanced past the sample
+// end - end of the payload
+// fields - STREAM_FIELDS raw field values, updated in place
+////////////////////////////////////////////////////////////////////////////
+static bool readSample(uint8_t flags, const uint8_t *&in, const uint8_t *end, uint32_t *fields) {
+
+  uint8_t type = flags & STREAM_TYPE_MASK;
+  for (int i = 0; i < STREAM_FIELDS; i++)
+  {
+    bool wide = isWideField(type, i);
+    if (flags & STREAM_PACKED)
+    {
+      uint32_t zigzag = 0;
+      int shift = 0;
+      uint8_t b;
+      do
+      {
+        if (in >= end || shift > 28)
+          return false;
+        b = *in++;
+        zigzag |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+      } while (b & 0x80);
+      uint32_t diff = (zigzag >> 1) ^ (0 - (zigzag & 1));
+      fields[i] = wide ? fields[i] + diff : (fields[i] + diff) & 0xFFFF;
+    }
+    else
+    {
+      if (in + (wide ? 4 : 2) > end)
+        return false;
+      fields[i] = in[0] | (in[1] << 8);
+      if (wide)
+        fields[i] |= ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+      in += wide ? 4 : 2;
+    }
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decodes the samples of a packet which passed the CRC check and hands 
+// them to the handler. The whole payload is checked against the header 
+// first, so a malformed packet delivers no samples.
+// Returns false if the payload does not match the header.
+////////////////////////////////////////////////////////////////////////////
+bool ADIS16470StreamDecoder::decodePayload(uint8_t flags, uint16_t sequence, uint8_t count,
+                                           const uint8_t *payload, size_t len) {
+
+  const uint8_t *end = payload + len;
+  uint32_t fields[STREAM_FIELDS] = {};
+
+  // Validate: every sample must parse and use exactly len bytes
+  const uint8_t *in = payload;
+  for (uint8_t s = 0; s < count; s++)
+    if (!readSample(flags, in, end, fields))
+      return false;
+  if (in != end)
+    return false;
+
+  // Emit
+  in = payload;
+  memset(fields, 0, sizeof(fields));
+  for (uint8_t s = 0; s < count; s++)
+  {
+    readSample(flags, in, end, fields);
+    _stats.samples++;
+    if (_handler)
+      _handler(_context, flags & STREAM_TYPE_MASK, sequence + s, fields);
+  }
+
+  return true;
+}
@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Stream.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Compact, resynchronizable binary stream format for logging burst data over a serial link.
+//  The encoder batches samples into packets which are sent with a single Serial.write(); the
+//  decoder rebuilds the samples on the receiving side and reports lost or corrupt packets.
+//  This header has no Arduino dependencies so both halves also build on a PC.
+//
+//  Packet layout (multi-byte fields are little-endian):
+//    0  2  Sync bytes 0xA5 0x5A
+//    2  1  Format version (STREAM_VERSION)
+//    3  1  Flags: sample type in bits 0-1 (STREAM_*), STREAM_PACKED in bit 7
+//    4  2  Sequence number of the first sample. Increments by one per sample
+//    6  1  Number of samples
+//    7  2  Payload length in bytes
+//    9  n  Payload
+//    9+n 2 CRC-16/CCITT of bytes 2 to 8+n
+//
+//  Every sample is carried as ten fields: DIAG_STAT, three gyro (or delta angle), three accel 
+//  (or delta velocity), TEMP_OUT, TIME_STAMP and the sensor checksum. The six inertial fields 
+//  are 32 bits wide for 32-bit bursts. Unpacked payloads hold each field at its natural width.
+//  Packed payloads hold the zigzag varint of the difference from the previous sample in the 
+//  same packet (from zero for the first sample), so slowly changing data takes one byte per 
+//  field. Each packet decodes on its own, which lets the decoder resynchronize after errors.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ADIS16470_Types.h"
+
+// Packet framing
+#define STREAM_SYNC0        0xA5
+#define STREAM_SYNC1        0x5A
+#define STREAM_VERSION      1
+#define STREAM_HEADER_BYTES 9
+#define STREAM_CRC_BYTES    2
+
+// Sample types (flags bits 0-1). Match the burst modes of setBurstMode()
+#define STREAM_INERTIAL16   0
+#define STREAM_DELTA16      1
+#define STREAM_INERTIAL32   2
+#define STREAM_DELTA32      3
+#define STREAM_TYPE_MASK    0x03
+
+// Payload uses delta/varint packing
+#define STREAM_PACKED       0x80
+
+// Fields carried per sample
+#define STREAM_FIELDS       10
+
+// Maximum number of samples per packet
+#ifndef ADIS16470_STREAM_SAMPLES
+#define ADIS16470_STREAM_SAMPLES 16
+#endif
+
+// Worst case payload: every field as a 5-byte varint
+#define STREAM_MAX_PAYLOAD  (ADIS16470_STREAM_SAMPLES * STREAM_FIELDS * 5)
+#define STREAM_MAX_PACKET   (STREAM_HEADER_BYTES + STREAM_MAX_PAYLOAD + STREAM_CRC_BYTES)
+
+// Computes the CRC-16/CCITT (0x1021, initial value 0xFFFF) of a buffer
+uint16_t adis16470Crc16(const uint8_t *data, size_t len, uint16_t crc = 0xFFFF);
+
+// Builds stream packets from burst frames
+class ADIS16470StreamEncoder {
+
+public:
+  // Selects the sample type and payload packing. Resets the sequence number
+  void begin(uint8_t type, bool packed);
+
+  // Add one sample. Return true when the packet is full and should be sent
+  bool add(const ADIS16470Frame &frame);
+  bool add(const ADIS16470DeltaFrame &frame);
+  bool add(const ADIS16470Frame32 &frame);
+  bool add(const ADIS16470DeltaFrame32 &frame);
+
+  // Number of samples in the open packet
+  uint8_t samples(void) const { return _count; }
+
+  // Completes the open packet. Returns its length (0 if empty); the bytes are at data()
+  size_t finish(void);
+
+  // Packet bytes. Valid after finish() until the next add()
+  const uint8_t *data(void) const { return _packet; }
+
+private:
+  // Appends one sample given as STREAM_FIELDS raw field values
+  bool addFields(const uint32_t *fields);
+
+  uint8_t _packet[STREAM_MAX_PACKET];
+  uint32_t _prev[STREAM_FIELDS]; // Previous sample, for packing
+  size_t _length = STREAM_HEADER_BYTES; // Bytes written so far
+  uint16_t _sequence = 0; // Sequence number of the next sample
+  uint8_t _count = 0;
+  uint8_t _flags = STREAM_INERTIAL16;
+  bool _finished = false;
+};
+
+// Called by the decoder for every sample. fields holds STREAM_FIELDS raw values
+typedef void (*ADIS16470StreamHandler)(void *context, uint8_t type, uint16_t sequence, const uint32_t *fields);
+
+// Running decoder statistics
+struct ADIS16470StreamStats {
+  uint32_t packets;      // Packets decoded
+  uint32_t samples;      // Samples delivered
+  uint32_t crcErrors;    // Packets rejected by the CRC
+  uint32_t formatErrors; // Unknown version, bad length or malformed payload
+  uint32_t bytesSkipped; // Bytes discarded while searching for sync
+  uint32_t samplesLost;  // Samples missing from the sequence
+};
+
+// Rebuilds samples from a byte stream
+class ADIS16470StreamDecoder {
+
+public:
+  ADIS16470StreamDecoder(ADIS16470StreamHandler handler, void *context = nullptr);
+
+  // Feeds received bytes. Calls the handler for each sample in every complete packet
+  void feed(const uint8_t *data, size_t len);
+
+  // Decoder statistics
+  const ADIS16470StreamStats &stats(void) const { return _stats; }
+
+private:
+  // Parses complete packets from the front of _buffer
+  void parse(void);
+
+  // Decodes a validated payload. Returns false if it is malformed
+  bool decodePayload(uint8_t flags, uint16_t sequence, uint8_t count, const uint8_t *payload, size_t len);
+
+  // Discards n bytes from the front of _buffer
+  void consume(size_t n);
+
+  ADIS16470StreamHandler _handler;
+  void *_context;
+  uint8_t _buffer[STREAM_MAX_PACKET];
+  size_t _length = 0;
+  uint16_t _nextSequence = 0;
+  bool _synced = false; // _nextSequence is valid
+  ADIS16470StreamStats _stats = {};
+};
+
+// Converts decoded stream fields back into frames
+void adis16470FieldsToFrame(const uint32_t *fields, ADIS16470Frame *frame);
+void adis16470FieldsToFrame(const uint32_t *fields, ADIS16470DeltaFrame *frame);
+void adis16470FieldsToFrame(const uint32_t *fields, ADIS16470Frame32 *frame);
+void adis16470FieldsToFrame(const uint32_t *fields, ADIS16470DeltaFrame32 *frame);
@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_TimeSync.cpp
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Host-time stamping of samples with offset and drift tracking.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include "ADIS16470_TimeSync.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Constructor
+////////////////////////////////////////////////////////////////////////////
+// clock - free-running 32-bit MCU clock. Must not wrap between samples
+// ticksPerSample - nominal sample period in clock ticks (e.g. 500 for 
+// micros() at 2000 SPS)
+////////////////////////////////////////////////////////////////////////////
+ADIS16470TimeSync::ADIS16470TimeSync(ADIS16470ClockFn clock, float ticksPerSample) {
+  _clock = clock;
+  _ticksPerSample = ticksPerSample;
+  _outlierLimit = ticksPerSample * 0.0625f;
+  reset();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the expected TIME_STAMP increment per sample, used to count missed
+// samples. Use 0 when TIME_STAMP does not advance by a fixed step (e.g. it
+// is reset by an external sync pulse); every update then counts as one 
+// sample. Restarts tracking.
+////////////////////////////////////////////////////////////////////////////
+// step - TIME_STAMP counts per sample
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470TimeSync::setTimeStampStep(uint16_t step) {
+  _step = step;
+  return reset();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the loop time constant. Returns 1, or -1 if samples is below 2.
+////////////////////////////////////////////////////////////////////////////
+// samples - time constant in samples
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470TimeSync::setTimeConstant(uint16_t samples) {
+  if (samples < 2)
+    return -1;
+  _timeConstant = samples;
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Sets the largest correction a single capture may apply once the loop 
+// is locked. Captures further from the prediction (interrupt latency 
+// spikes) are clamped to it and counted as outliers.
+////////////////////////////////////////////////////////////////////////////
+// ticks - limit in clock ticks
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470TimeSync::setOutlierLimit(float ticks) {
+  _outlierLimit = ticks;
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Restarts tracking and clears the counters.
+////////////////////////////////////////////////////////////////////////////
+int ADIS16470TimeSync::reset(void) {
+  _started = false;
+  _lastEdge = 0;
+  _host64 = 0;
+  _lastTimeStamp = 0;
+  _timeStamp64 = 0;
+  _sampleIndex = 0;
+  _estimate = 0;
+  _estimateFrac = 0.0f;
+  _rate = 0.0f;
+  _settle = 0;
+  _stats = ADIS16470TimeSyncStats();
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Processes one sample and returns its host time: the loop's estimate of 
+// the data ready edge in 64-bit clock ticks. The first updates after a 
+// (re)start use a growing averaging window, so the loop acquires offset 
+// and drift within about one time constant, then runs as a critically 
+// damped alpha-beta filter. A constant interrupt latency shows up as a 
+// constant offset and is not removed.
+////////////////////////////////////////////////////////////////////////////
+// edgeTicks - MCU clock read at the data ready edge (now())
+// timeStamp - TIME_STAMP from the sample's burst
+////////////////////////////////////////////////////////////////////////////
+uint64_t ADIS16470TimeSync::update(uint32_t edgeTicks, uint16_t timeStamp) {
+
+  // Extend the MCU clock and TIME_STAMP
+  _host64 += (uint32_t)(edgeTicks - _lastEdge);
+  _lastEdge = edgeTicks;
+  uint16_t _tsDelta = (uint16_t)(timeStamp - _lastTimeStamp);
+  _lastTimeStamp = timeStamp;
+  _stats.updates++;
+
+  if (!_started)
+  {
+    _host64 = edgeTicks;
+    _timeStamp64 = timeStamp;
+    _started = true;
+    _estimate = _host64;
+    _estimateFrac = 0.0f;
+    _settle = 1;
+    return _estimate;
+  }
+  _timeStamp64 += _tsDelta;
+
+  // Sample periods since the last update
+  uint32_t _n = 1;
+  if (_step != 0 && _tsDelta >= _step)
+    _n = (_tsDelta + _step / 2) / _step;
+  _sampleIndex += _n;
+
+  if (_n > TIMESYNC_MAX_GAP)
+  {
+    // Too long to extrapolate: restart from this capture, keep the drift estimate
+    _estimate = _host64;
+    _estimateFrac = 0.0f;
+    _settle = 1;
+    _stats.restarts++;
+    _stats.locked = false;
+    return _estimate;
+  }
+
+  // Predict, then correct with the capture
+  float _period = _ticksPerSample * (1.0f + _rate);
+  float _predicted = _estimateFrac + _period * (float)_n;
+  float _r = (float)(int64_t)(_host64 - _estimate) - _predicted;
+  _stats.residual = _r;
+
+  if (_stats.locked)
+  {
+    if (fabsf(_r) > _stats.residualMax)
+      _stats.residualMax = fabsf(_r);
+    if (_r > _outlierLimit || _r < -_outlierLimit)
+    {
+      _r = (_r > 0.0f) ? _outlierLimit : -_outlierLimit;
+      _stats.outliers++;
+    }
+  }
+
+  // Gains: growing window while acquiring, then critically damped with theta = 1 - 1/T
+  float _t = (float)((_settle < _timeConstant) ? _settle + 1 : _timeConstant);
+  float _theta = 1.0f - 1.0f / _t;
+  float _alpha = 1.0f - _theta * _theta;
+  float _beta = (1.0f - _theta) * (1.0f - _theta);
+  if (_settle < _timeConstant)
+  {
+    _settle++;
+    _alpha = 2.0f * (2.0f * _t - 1.0f) / (_t * (_t + 1.0f)); // Least-squares line fit gains
+    _beta = 6.0f / (_t * (_t + 1.0f));
+  }
+  else
+    _stats.locked = true;
+
+  _predicted += _alpha * _r;
+  _rate += _beta * _r / (_ticksPerSample * (float)_n);
+  _stats.driftPpm = -_rate * 1e6f; // Longer host period means a slower sensor clock
+
+  // Move whole ticks into the integer part
+  float _whole = floorf(_predicted);
+  _estimate += (int64_t)_whole;
+  _estimateFrac = _predicted - _whole;
+
+  return _estimate + (uint64_t)(_estimateFrac + 0.5f);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Returns the host time of any sample index (past or predicted) from the
+// current estimate. Useful to place events recorded by sample number. The
+// float rounding stays well below the uncertainty of the drift estimate.
+////////////////////////////////////////////////////////////////////////////
+// sampleIndex - index as returned by sampleIndex()
+////////////////////////////////////////////////////////////////////////////
+uint64_t ADIS16470TimeSync::hostTime(uint64_t sampleIndex) const {
+  int64_t _n = (int64_t)(sampleIndex - _sampleIndex);
+
+  // Whole ticks per sample in integer math; the fraction and the drift 
+  // correction in float, as in update()
+  float _whole = floorf(_ticksPerSample);
+  float _rest = _estimateFrac + (float)_n * ((_ticksPerSample - _whole) + _ticksPerSample * _rate);
+  int64_t _restTicks = (int64_t)floorf(_rest + 0.5f);
+  return _estimate + (uint64_t)(_n * (int64_t)_whole + _restTicks);
+}
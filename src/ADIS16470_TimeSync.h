@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_TimeSync.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Host-time stamping of samples. The MCU clock is read at each data ready edge, TIME_STAMP
+//  is extended to 64 bits across wraps, and a second-order tracking loop (alpha-beta 
+//  filter) follows the offset and drift between the sensor's sample clock and the MCU 
+//  clock. Each sample is stamped with the loop's estimate of its edge time instead of the
+//  raw capture, which removes interrupt latency jitter and keeps stamps evenly spaced 
+//  even across missed samples. Capture spikes larger than the outlier limit are clamped.
+//  This header has no Arduino dependencies; extras/bench/ADIS16470_TimeSyncSim.cpp 
+//  exercises it against a simulated drifting clock.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ADIS16470_Profile.h"
+
+// Default loop time constant, samples
+#define TIMESYNC_TIME_CONSTANT 256
+
+// Gaps longer than this (in samples) restart the loop
+#define TIMESYNC_MAX_GAP       256
+
+// Tracking loop state and counters
+struct ADIS16470TimeSyncStats {
+  uint32_t updates;         // Samples processed
+  uint32_t outliers;        // Captures clamped to the outlier limit
+  uint32_t restarts;        // Loop restarts after long gaps
+  float driftPpm;           // Sensor clock rate relative to nominal, seen by the MCU clock
+  float residual;           // Last capture minus prediction, clock ticks
+  float residualMax;        // Largest absolute residual while locked, clock ticks
+  bool locked;              // Loop has settled for one time constant
+};
+
+class ADIS16470TimeSync {
+
+public:
+  // clock - free-running 32-bit MCU clock (micros or a cycle counter); ticksPerSample - nominal sample period in its ticks
+  ADIS16470TimeSync(ADIS16470ClockFn clock, float ticksPerSample);
+
+  // Reads the MCU clock. Call first thing in the data ready ISR
+  uint32_t now(void) const { return _clock(); }
+
+  // TIME_STAMP increment per sample. 0 ignores TIME_STAMP and counts one sample per update
+  int setTimeStampStep(uint16_t step);
+
+  // Loop time constant in samples. Longer smooths more jitter but follows drift changes slower
+  int setTimeConstant(uint16_t samples);
+
+  // Largest correction accepted from one capture once locked, clock ticks. Default 1/16 sample period
+  int setOutlierLimit(float ticks);
+
+  // Restart tracking
+  int reset(void);
+
+  // Processes one sample: edge capture and burst TIME_STAMP. Returns the sample's 64-bit host time
+  uint64_t update(uint32_t edgeTicks, uint16_t timeStamp);
+
+  // TIME_STAMP of the last sample extended across wraps
+  uint64_t timeStamp64(void) const { return _timeStamp64; }
+
+  // Sample index of the last sample (counts missed samples)
+  uint64_t sampleIndex(void) const { return _sampleIndex; }
+
+  // Converts a sample index to host time using the current offset and drift estimate
+  uint64_t hostTime(uint64_t sampleIndex) const;
+
+  // Tracking loop state and counters
+  const ADIS16470TimeSyncStats &stats(void) const { return _stats; }
+
+private:
+  ADIS16470ClockFn _clock;
+  float _ticksPerSample;
+  uint16_t _step = 1;
+  uint16_t _timeConstant = TIMESYNC_TIME_CONSTANT;
+  float _outlierLimit;
+
+  bool _started;
+  uint32_t _lastEdge;
+  uint64_t _host64;         // MCU clock extended to 64 bits
+  uint16_t _lastTimeStamp;
+  uint64_t _timeStamp64;
+  uint64_t _sampleIndex;
+  uint64_t _estimate;       // Estimated host time of the last sample, integer ticks
+  float _estimateFrac;      // and fraction
+  float _rate;              // Estimated ticks per sample relative to nominal, minus 1
+  uint32_t _settle;         // Updates since the last (re)start
+  ADIS16470TimeSyncStats _stats;
+};
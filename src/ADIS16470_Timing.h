@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Timing.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  SPI timing limits from the ADIS16470 datasheet (Table 2) and a compile-time model of the
+//  bus time each driver operation takes. The driver derives its stall times from this model,
+//  and host tools use it to predict throughput. This header has no Arduino dependencies.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+// Datasheet limits
+#define SCLK_MAX_HZ        2000000  //Maximum SCLK for register reads and writes
+#define SCLK_BURST_MAX_HZ  1000000  //Maximum SCLK for burst reads
+#define STALL_MIN_US       16       //Minimum CS high time between 16-bit frames (tSTALL)
+#define READRATE_MIN_US    24       //Minimum time between the starts of consecutive frames (tREADRATE)
+
+////////////////////////////////////////////////////////////////////////////
+// Time to clock the given number of bits, in microseconds (rounded up)
+////////////////////////////////////////////////////////////////////////////
+constexpr uint32_t adis16470ClockUs(uint32_t sclkHz, uint32_t bits) {
+  return (uint32_t)(((uint64_t)bits * 1000000UL + sclkHz - 1) / sclkHz);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Stall needed after a 16-bit frame at the given clock to satisfy both 
+// tSTALL and tREADRATE
+////////////////////////////////////////////////////////////////////////////
+constexpr uint32_t adis16470StallUs(uint32_t sclkHz) {
+  return (READRATE_MIN_US > adis16470ClockUs(sclkHz, 16) + STALL_MIN_US)
+    ? READRATE_MIN_US - adis16470ClockUs(sclkHz, 16) : STALL_MIN_US;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Bus time of one 16-bit frame plus its stall
+////////////////////////////////////////////////////////////////////////////
+constexpr uint32_t adis16470FrameUs(uint32_t sclkHz) {
+  return adis16470ClockUs(sclkHz, 16) + adis16470StallUs(sclkHz);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Bus time of regReadMany() for count registers (count + 1 frames)
+////////////////////////////////////////////////////////////////////////////
+constexpr uint32_t adis16470RegReadUs(uint32_t sclkHz, uint32_t count) {
+  return (count + 1) * adis16470FrameUs(sclkHz);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Bus time of regWrite() (one frame per byte)
+////////////////////////////////////////////////////////////////////////////
+constexpr uint32_t adis16470RegWriteUs(uint32_t sclkHz) {
+  return 2 * adis16470FrameUs(sclkHz);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Bus time of a burst returning the given number of words (command word 
+// included)
+////////////////////////////////////////////////////////////////////////////
+constexpr uint32_t adis16470BurstUs(uint32_t sclkHz, uint32_t words) {
+  return adis16470ClockUs(sclkHz, 16 * (words + 1));
+}
+
+// Model checks against the datasheet figures
+static_assert(adis16470StallUs(SCLK_MAX_HZ) == STALL_MIN_US, "2 MHz: 8 us frame + 16 us stall meets tREADRATE");
+static_assert(adis16470StallUs(SCLK_BURST_MAX_HZ) == STALL_MIN_US, "1 MHz: 16 us frame + 16 us stall");
+static_assert(adis16470StallUs(4000000) == 20, "4 MHz: 4 us frame needs a 20 us stall to meet tREADRATE");
+static_assert(adis16470FrameUs(SCLK_MAX_HZ) >= READRATE_MIN_US, "Frame period never below tREADRATE");
+static_assert(adis16470BurstUs(SCLK_BURST_MAX_HZ, 10) == 176, "16-bit burst: 22 bytes at 1 MHz");
+static_assert(adis16470BurstUs(SCLK_BURST_MAX_HZ, 16) == 272, "32-bit burst: 34 bytes at 1 MHz");
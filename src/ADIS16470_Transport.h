@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Transport.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Hardware access used by the ADIS16470 driver: SPI transactions and byte transfers, the
+//  CS/DR/RST pins, delays and the millisecond clock. The transport is a static policy
+//  chosen at compile time, so every call is a direct (usually inlined) call with no
+//  virtual dispatch. By default the Arduino SPI library and pin functions are used. To
+//  run the driver elsewhere (e.g. against the simulator in extras/sim), define
+//  ADIS16470_TRANSPORT_HEADER for the whole build as a header which defines
+//  ADIS16470_TRANSPORT to a class with the same members as ADIS16470ArduinoTransport.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#if defined(ADIS16470_TRANSPORT_HEADER)
+
+#include ADIS16470_TRANSPORT_HEADER
+
+#else
+
+#include "Arduino.h"
+#include <SPI.h>
+
+// DMA bursts through SPIClass::transfer(..., EventResponder &) where the core supports them
+#if defined(SPI_HAS_TRANSFER_ASYNC)
+#define ADIS16470_TRANSPORT_ASYNC
+#endif
+
+// Arduino SPI library and pin functions
+class ADIS16470ArduinoTransport {
+
+public:
+  typedef SPIClass Bus;
+  typedef SPISettings Settings;
+
+  ADIS16470ArduinoTransport(Bus &bus) : _bus(&bus) {}
+
+  // Bus used when the constructor is not given one
+  static Bus &defaultBus(void) { return SPI; }
+
+  // Initializes the bus and pins. CS and RST idle high
+  void begin(int CS, int DR, int RST) {
+    _bus->begin();
+    pinMode(CS, OUTPUT);
+    pinMode(DR, INPUT);
+    pinMode(RST, OUTPUT);
+    digitalWrite(CS, HIGH);
+    digitalWrite(RST, HIGH);
+  }
+
+  // SPI mode 3, MSB first at the given clock
+  static Settings settings(uint32_t sclkHz) { return SPISettings(sclkHz, MSBFIRST, SPI_MODE3); }
+
+  void beginTransaction(const Settings &settings) { _bus->beginTransaction(settings); }
+  void endTransaction(void) { _bus->endTransaction(); }
+  uint8_t transfer(uint8_t data) { return _bus->transfer(data); }
+
+#if defined(ADIS16470_TRANSPORT_ASYNC)
+  // Starts a DMA transfer. Returns false if the engine is unavailable
+  bool transferAsync(const uint8_t *tx, uint8_t *rx, size_t count, EventResponder &event) {
+    return _bus->transfer(tx, rx, count, event);
+  }
+#endif
+
+  void pinWrite(int pin, bool high) { digitalWrite(pin, high ? HIGH : LOW); }
+  bool pinRead(int pin) { return digitalRead(pin) == HIGH; }
+
+  void delayUs(uint32_t us) { delayMicroseconds(us); }
+  void delayMs(uint32_t ms) { delay(ms); }
+  uint32_t millis(void) { return ::millis(); }
+
+private:
+  Bus *_bus;
+};
+
+#define ADIS16470_TRANSPORT ADIS16470ArduinoTransport
+
+#endif
+
+typedef ADIS16470_TRANSPORT ADIS16470Transport;
@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  ADIS16470_Types.h
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 
+//  Burst frame definitions shared by the ADIS16470 library and host-side tools. This header
+//  has no Arduino dependencies so it may also be compiled on a PC.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Number of 16-bit words returned by a standard burst read
+#define BURST_WORDS   10
+
+// Number of 16-bit words returned by a 32-bit burst read (MSC_CTRL BURST32 set)
+#define BURST32_WORDS 16
+
+// Word positions in a standard burst
+struct ADIS16470BurstLayout {
+  static constexpr uint8_t words = BURST_WORDS;
+  static constexpr uint8_t diagStat = 0;
+  static constexpr uint8_t gyro = 1;       // X, Y, Z (or delta angle)
+  static constexpr uint8_t accl = 4;       // X, Y, Z (or delta velocity)
+  static constexpr uint8_t temp = 7;
+  static constexpr uint8_t timeStamp = 8;
+  static constexpr uint8_t checksum = 9;
+  static constexpr uint8_t stride = 1;     // Words per output
+};
+
+// Word positions in a 32-bit burst. Each output is sent as its LOW word then its OUT word
+struct ADIS16470Burst32Layout {
+  static constexpr uint8_t words = BURST32_WORDS;
+  static constexpr uint8_t diagStat = 0;
+  static constexpr uint8_t gyro = 1;
+  static constexpr uint8_t accl = 7;
+  static constexpr uint8_t temp = 13;
+  static constexpr uint8_t timeStamp = 14;
+  static constexpr uint8_t checksum = 15;
+  static constexpr uint8_t stride = 2;
+};
+
+static_assert(ADIS16470BurstLayout::checksum == BURST_WORDS - 1, "Checksum is the last burst word");
+static_assert(ADIS16470Burst32Layout::checksum == BURST32_WORDS - 1, "Checksum is the last burst word");
+
+// Decoded standard (16-bit) burst frame
+struct ADIS16470Frame {
+  uint16_t diagStat;  // DIAG_STAT
+  int16_t gyro[3];    // X/Y/Z_GYRO_OUT
+  int16_t accl[3];    // X/Y/Z_ACCL_OUT
+  int16_t temp;       // TEMP_OUT
+  uint16_t timeStamp; // TIME_STAMP
+  uint16_t checksum;  // Checksum sent by the sensor
+};
+
+// Decoded 16-bit delta angle/delta velocity burst frame (MSC_CTRL BURST_SEL set)
+struct ADIS16470DeltaFrame {
+  uint16_t diagStat;  // DIAG_STAT
+  int16_t deltAng[3]; // X/Y/Z_DELTANG_OUT
+  int16_t deltVel[3]; // X/Y/Z_DELTVEL_OUT
+  int16_t temp;       // TEMP_OUT
+  uint16_t timeStamp; // TIME_STAMP
+  uint16_t checksum;  // Checksum sent by the sensor
+};
+
+// Decoded 32-bit burst frame (MSC_CTRL BURST32 set)
+struct ADIS16470Frame32 {
+  uint16_t diagStat;  // DIAG_STAT
+  int32_t gyro[3];    // X/Y/Z_GYRO_OUT:X/Y/Z_GYRO_LOW
+  int32_t accl[3];    // X/Y/Z_ACCL_OUT:X/Y/Z_ACCL_LOW
+  int16_t temp;       // TEMP_OUT
+  uint16_t timeStamp; // TIME_STAMP
+  uint16_t checksum;  // Checksum sent by the sensor
+};
+
+// Decoded 32-bit delta angle/delta velocity burst frame (MSC_CTRL BURST32 and BURST_SEL set)
+struct ADIS16470DeltaFrame32 {
+  uint16_t diagStat;  // DIAG_STAT
+  int32_t deltAng[3]; // X/Y/Z_DELTANG_OUT:X/Y/Z_DELTANG_LOW
+  int32_t deltVel[3]; // X/Y/Z_DELTVEL_OUT:X/Y/Z_DELTVEL_LOW
+  int16_t temp;       // TEMP_OUT
+  uint16_t timeStamp; // TIME_STAMP
+  uint16_t checksum;  // Checksum sent by the sensor
+};
+
+////////////////////////////////////////////////////////////////////////////
+// Sums the bytes of count burst words. The sensor checksum covers every 
+// word before the checksum itself.
+////////////////////////////////////////////////////////////////////////////
+inline int16_t adis16470Checksum(const uint16_t *burstWords, size_t count) {
+  int16_t s = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    s += (burstWords[i] & 0xFF); // Count lower byte
+    s += ((burstWords[i] >> 8) & 0xFF); // Count upper byte
+  }
+  return s;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Combines a LOW/OUT word pair into a signed 32-bit value
+////////////////////////////////////////////////////////////////////////////
+inline int32_t adis16470Combine32(uint16_t lowWord, uint16_t outWord) {
+  return (int32_t)(((uint32_t)outWord << 16) | lowWord);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decodes BURST_WORDS burst words (as returned by wordBurst()) into a frame
+////////////////////////////////////////////////////////////////////////////
+inline void adis16470DecodeBurst(const uint16_t *burstWords, ADIS16470Frame *frame) {
+  typedef ADIS16470BurstLayout L;
+  frame->diagStat = burstWords[L::diagStat];
+  for (int i = 0; i < 3; i++)
+  {
+    frame->gyro[i] = (int16_t)burstWords[L::gyro + i];
+    frame->accl[i] = (int16_t)burstWords[L::accl + i];
+  }
+  frame->temp = (int16_t)burstWords[L::temp];
+  frame->timeStamp = burstWords[L::timeStamp];
+  frame->checksum = burstWords[L::checksum];
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decodes BURST_WORDS burst words read with BURST_SEL set
+////////////////////////////////////////////////////////////////////////////
+inline void adis16470DecodeDeltaBurst(const uint16_t *burstWords, ADIS16470DeltaFrame *frame) {
+  typedef ADIS16470BurstLayout L;
+  frame->diagStat = burstWords[L::diagStat];
+  for (int i = 0; i < 3; i++)
+  {
+    frame->deltAng[i] = (int16_t)burstWords[L::gyro + i];
+    frame->deltVel[i] = (int16_t)burstWords[L::accl + i];
+  }
+  frame->temp = (int16_t)burstWords[L::temp];
+  frame->timeStamp = burstWords[L::timeStamp];
+  frame->checksum = burstWords[L::checksum];
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decodes BURST32_WORDS burst words (as returned by wordBurst32()). Each 
+// 32-bit output is sent as the LOW word followed by the OUT word.
+////////////////////////////////////////////////////////////////////////////
+inline void adis16470DecodeBurst32(const uint16_t *burstWords, ADIS16470Frame32 *frame) {
+  typedef ADIS16470Burst32Layout L;
+  frame->diagStat = burstWords[L::diagStat];
+  for (int i = 0; i < 3; i++)
+  {
+    frame->gyro[i] = adis16470Combine32(burstWords[L::gyro + 2 * i], burstWords[L::gyro + 1 + 2 * i]);
+    frame->accl[i] = adis16470Combine32(burstWords[L::accl + 2 * i], burstWords[L::accl + 1 + 2 * i]);
+  }
+  frame->temp = (int16_t)burstWords[L::temp];
+  frame->timeStamp = burstWords[L::timeStamp];
+  frame->checksum = burstWords[L::checksum];
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decodes BURST32_WORDS burst words read with BURST_SEL set
+////////////////////////////////////////////////////////////////////////////
+inline void adis16470DecodeDeltaBurst32(const uint16_t *burstWords, ADIS16470DeltaFrame32 *frame) {
+  typedef ADIS16470Burst32Layout L;
+  frame->diagStat = burstWords[L::diagStat];
+  for (int i = 0; i < 3; i++)
+  {
+    frame->deltAng[i] = adis16470Combine32(burstWords[L::gyro + 2 * i], burstWords[L::gyro + 1 + 2 * i]);
+    frame->deltVel[i] = adis16470Combine32(burstWords[L::accl + 2 * i], burstWords[L::accl + 1 + 2 * i]);
+  }
+  frame->temp = (int16_t)burstWords[L::temp];
+  frame->timeStamp = burstWords[L::timeStamp];
+  frame->checksum = burstWords[L::checksum];
+}